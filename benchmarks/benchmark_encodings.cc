@@ -0,0 +1,119 @@
+#include "hpq/encodings/bitpack.h"
+#include "hpq/encodings/boolean.h"
+#include "hpq/encodings/byte_stream_split.h"
+#include "hpq/encodings/delta.h"
+#include "hpq/encodings/dict_encoding.h"
+#include "hpq/encodings/rle.h"
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Encodes then decodes `values` `iterations` times and reports the
+// throughput of each direction in MB/s of raw (unencoded) data.
+template <typename T>
+void RunBenchmark(const std::string &name, hpq::Encoder &encoder,
+                  hpq::Decoder &decoder, const std::vector<T> &values,
+                  int iterations = 20) {
+  const int n = static_cast<int>(values.size());
+  const double raw_mb =
+      static_cast<double>(values.size() * sizeof(T)) * iterations / 1e6;
+  std::vector<T> out(values.size());
+
+  std::pair<const uint8_t *, size_t> encoded;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; ++it) {
+    encoder.Clear();
+    encoder.Put(values.data(), n);
+    encoded = encoder.Flush();
+  }
+  auto mid = std::chrono::high_resolution_clock::now();
+  for (int it = 0; it < iterations; ++it) {
+    decoder.SetData(encoded.first, encoded.second, n);
+    decoder.Decode(out.data(), n);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+
+  if (std::memcmp(out.data(), values.data(), values.size() * sizeof(T)) != 0)
+    std::cout << name << ": ROUND TRIP MISMATCH" << std::endl;
+
+  std::chrono::duration<double> encode_s = mid - start;
+  std::chrono::duration<double> decode_s = end - mid;
+  std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+            << std::setprecision(1) << std::setw(10)
+            << raw_mb / encode_s.count() << " MB/s enc" << std::setw(10)
+            << raw_mb / decode_s.count() << " MB/s dec" << std::setw(8)
+            << 100.0 * encoded.second / (values.size() * sizeof(T)) << "%"
+            << std::endl;
+}
+
+int main(int argc, char **argv) {
+  int num_values = argc > 1 ? std::stoi(argv[1]) : 1 << 20;
+  std::mt19937_64 rng(42);
+
+  std::vector<int32_t> small(num_values);
+  for (auto &v : small)
+    v = static_cast<int32_t>(rng() % 1000);
+  {
+    hpq::BitPackEncoder encoder(10);
+    hpq::BitPackDecoder decoder(10);
+    RunBenchmark("BIT_PACKED w=10", encoder, decoder, small);
+  }
+
+  std::vector<int32_t> runs(num_values);
+  for (int i = 0; i < num_values; ++i)
+    runs[i] = (i / 64) % 7 == 0 ? static_cast<int32_t>(rng() % 16) : i / 64 % 16;
+  {
+    hpq::RleEncoder encoder(4);
+    hpq::RleDecoder decoder(4);
+    RunBenchmark("RLE w=4", encoder, decoder, runs);
+  }
+
+  std::vector<int64_t> ids(num_values);
+  int64_t id = 1000000;
+  for (auto &v : ids)
+    v = id += static_cast<int64_t>(rng() % 16);
+  {
+    hpq::DeltaEncoder encoder(hpq::Type::INT64);
+    hpq::DeltaDecoder decoder(hpq::Type::INT64);
+    RunBenchmark("DELTA_BINARY int64", encoder, decoder, ids);
+  }
+
+  std::vector<int64_t> categories(num_values);
+  for (auto &v : categories)
+    v = static_cast<int64_t>(rng() % 200) * 7919;
+  {
+    hpq::DictEncoder encoder(hpq::Type::INT64);
+    hpq::DictDecoder decoder(hpq::Type::INT64);
+    RunBenchmark("RLE_DICTIONARY int64", encoder, decoder, categories);
+  }
+
+  std::vector<uint8_t> flags(num_values);
+  for (auto &v : flags)
+    v = rng() % 4 == 0;
+  for (auto encoding : {hpq::Encoding::PLAIN, hpq::Encoding::RLE}) {
+    hpq::BooleanEncoder encoder(encoding);
+    hpq::BooleanDecoder decoder(encoding);
+    RunBenchmark(encoding == hpq::Encoding::PLAIN ? "BOOLEAN plain"
+                                                  : "BOOLEAN rle",
+                 encoder, decoder, flags);
+  }
+
+  std::vector<double> prices(num_values);
+  for (auto &v : prices)
+    v = 100.0 + static_cast<double>(rng() % 100000) / 100.0;
+  {
+    hpq::ByteStreamSplitEncoder encoder(hpq::Type::DOUBLE);
+    hpq::ByteStreamSplitDecoder decoder(hpq::Type::DOUBLE);
+    RunBenchmark("BYTE_STREAM_SPLIT dbl", encoder, decoder, prices);
+  }
+  {
+    hpq::PlainEncoder<hpq::DoubleType> encoder;
+    auto decoder = hpq::MakePlainDecoder(hpq::Type::DOUBLE);
+    RunBenchmark("PLAIN double", encoder, *decoder, prices);
+  }
+  return 0;
+}
@@ -0,0 +1,273 @@
+// End-to-end write benchmark on a deterministic TPC-H lineitem-like table.
+//
+//   benchmark_lineitem [scale_factor ...] [--threads=1,2,4]
+//
+// Scale factor 1 is about 6M rows. Every run writes the same data, so file
+// sizes are comparable across runs and machines.
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const char *kOutput = "benchmark_lineitem.parquet";
+constexpr int kBatchRows = 64 * 1024; // Rows per WriteColumn call
+
+// Days since 1970-01-01
+constexpr int32_t kStartDate = 8035;   // 1992-01-01
+constexpr int32_t kLastOrder = 10440;  // 1998-08-02
+constexpr int32_t kCurrentDate = 9298; // 1995-06-17
+
+// Column-major lineitem. DECIMAL(15,2) columns hold hundredths, dates hold
+// days since the epoch, and the low-cardinality string columns hold codes
+// into fixed value lists, as a dictionary-encoded string would. l_comment is
+// left out: the writer has no BYTE_ARRAY columns yet.
+struct LineItem {
+  std::vector<int64_t> orderkey, partkey, suppkey;
+  std::vector<int32_t> linenumber;
+  std::vector<int64_t> quantity, extendedprice, discount, tax;
+  std::vector<int32_t> returnflag, linestatus; // "RAN", "OF"
+  std::vector<int32_t> shipdate, commitdate, receiptdate;
+  std::vector<int32_t> shipinstruct, shipmode; // 4 and 7 values
+
+  size_t size() const { return orderkey.size(); }
+};
+
+// Follows the TPC-H dbgen distributions closely enough for encoding
+// behaviour: sparse sorted order keys with 1-7 lines each, uniform part and
+// supplier keys, prices derived from the part key and correlated dates.
+LineItem Generate(double scale_factor) {
+  LineItem t;
+  const int64_t orders = std::max<int64_t>(1, scale_factor * 1500000);
+  const int64_t parts = std::max<int64_t>(1, scale_factor * 200000);
+  const int64_t suppliers = std::max<int64_t>(1, scale_factor * 10000);
+  std::mt19937_64 rng(42);
+  auto uniform = [&rng](int64_t lo, int64_t hi) {
+    return lo + static_cast<int64_t>(rng() % (hi - lo + 1));
+  };
+
+  for (int64_t o = 0; o < orders; ++o) {
+    // dbgen only uses the first 8 keys of every 32
+    const int64_t orderkey = (o / 8) * 32 + o % 8 + 1;
+    const int32_t orderdate =
+        static_cast<int32_t>(uniform(kStartDate, kLastOrder));
+    const int lines = static_cast<int>(uniform(1, 7));
+    for (int line = 1; line <= lines; ++line) {
+      const int64_t partkey = uniform(1, parts);
+      const int64_t retail =
+          90000 + (partkey / 10) % 20001 + 100 * (partkey % 1000);
+      const int64_t quantity = uniform(1, 50);
+      const int32_t ship = orderdate + static_cast<int32_t>(uniform(1, 121));
+      const int32_t receipt = ship + static_cast<int32_t>(uniform(1, 30));
+
+      t.orderkey.push_back(orderkey);
+      t.partkey.push_back(partkey);
+      t.suppkey.push_back(uniform(1, suppliers));
+      t.linenumber.push_back(line);
+      t.quantity.push_back(quantity * 100);
+      t.extendedprice.push_back(quantity * retail);
+      t.discount.push_back(uniform(0, 10));
+      t.tax.push_back(uniform(0, 8));
+      t.returnflag.push_back(
+          receipt <= kCurrentDate ? static_cast<int32_t>(uniform(0, 1)) : 2);
+      t.linestatus.push_back(ship > kCurrentDate ? 0 : 1);
+      t.shipdate.push_back(ship);
+      t.commitdate.push_back(orderdate +
+                             static_cast<int32_t>(uniform(30, 90)));
+      t.receiptdate.push_back(receipt);
+      t.shipinstruct.push_back(static_cast<int32_t>(uniform(0, 3)));
+      t.shipmode.push_back(static_cast<int32_t>(uniform(0, 6)));
+    }
+  }
+  return t;
+}
+
+// Keys are REQUIRED; the remaining columns are OPTIONAL as they are in
+// most exported tables. WriteColumn has no null input, so every value is
+// defined: those pages carry an all-defined definition level run, and pages
+// with actual nulls are not measured here.
+hpq::Schema LineItemSchema() {
+  hpq::Schema schema;
+  schema.AddColumn("l_orderkey", hpq::Type::INT64, false);
+  schema.AddColumn("l_partkey", hpq::Type::INT64, false);
+  schema.AddColumn("l_suppkey", hpq::Type::INT64, false);
+  schema.AddColumn("l_linenumber", hpq::Type::INT32, false);
+  schema.AddColumn("l_quantity", hpq::Type::INT64);
+  schema.AddColumn("l_extendedprice", hpq::Type::INT64);
+  schema.AddColumn("l_discount", hpq::Type::INT64);
+  schema.AddColumn("l_tax", hpq::Type::INT64);
+  schema.AddColumn("l_returnflag", hpq::Type::INT32);
+  schema.AddColumn("l_linestatus", hpq::Type::INT32);
+  schema.AddColumn("l_shipdate", hpq::Type::INT32);
+  schema.AddColumn("l_commitdate", hpq::Type::INT32);
+  schema.AddColumn("l_receiptdate", hpq::Type::INT32);
+  schema.AddColumn("l_shipinstruct", hpq::Type::INT32);
+  schema.AddColumn("l_shipmode", hpq::Type::INT32);
+  return schema;
+}
+
+template <typename T>
+void WriteBatch(hpq::ParquetWriter &writer, int col, const std::vector<T> &v,
+                size_t offset, int n) {
+  writer.WriteColumn(col, v.data() + offset, n);
+}
+
+void WriteTable(hpq::ParquetWriter &writer, const LineItem &t) {
+  for (size_t offset = 0; offset < t.size(); offset += kBatchRows) {
+    const int n =
+        static_cast<int>(std::min<size_t>(kBatchRows, t.size() - offset));
+    int col = 0;
+    for (const auto *v : {&t.orderkey, &t.partkey, &t.suppkey})
+      WriteBatch(writer, col++, *v, offset, n);
+    WriteBatch(writer, col++, t.linenumber, offset, n);
+    for (const auto *v : {&t.quantity, &t.extendedprice, &t.discount, &t.tax})
+      WriteBatch(writer, col++, *v, offset, n);
+    for (const auto *v :
+         {&t.returnflag, &t.linestatus, &t.shipdate, &t.commitdate,
+          &t.receiptdate, &t.shipinstruct, &t.shipmode})
+      WriteBatch(writer, col++, *v, offset, n);
+  }
+}
+
+size_t RawBytes(const LineItem &t) {
+  return t.size() * (8 * 3 + 4 + 8 * 4 + 4 * 7);
+}
+
+// Resident set high-water mark in MB. ResetPeakRss() restarts it (Linux
+// 4.0+); without /proc the process-lifetime peak from getrusage is used.
+void ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (clear_refs)
+    clear_refs << "5";
+}
+
+double ReadRssMB(const std::string &field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, field.size(), field) == 0)
+      return std::stod(line.substr(field.size() + 1)) / 1024.0;
+  }
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss / 1024.0;
+}
+
+int64_t FileSize(const char *path) {
+  struct stat st;
+  return stat(path, &st) == 0 ? st.st_size : 0;
+}
+
+// encode_threads == 0 writes synchronously on the calling thread.
+void RunBenchmark(const LineItem &table, int encode_threads,
+                  bool report = true) {
+  hpq::WriterOptions options;
+  options.compression = "NONE";
+  options.row_group_size = 1024 * 1024;
+  options.async = encode_threads > 0;
+  options.encode_threads = std::max(1, encode_threads);
+
+  const double base_rss = ReadRssMB("VmRSS:");
+  ResetPeakRss();
+  auto start = std::chrono::steady_clock::now();
+  hpq::ParquetWriter writer(kOutput, options);
+  writer.Init(LineItemSchema());
+  WriteTable(writer, table);
+  writer.Close();
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double peak_rss = ReadRssMB("VmHWM:");
+
+  if (!report)
+    return;
+  const hpq::WriterStats stats = writer.stats();
+  const double raw_mb = RawBytes(table) / 1e6;
+  const int64_t file_size = FileSize(kOutput);
+  std::ostringstream mode;
+  if (encode_threads == 0)
+    mode << "sync";
+  else
+    mode << "async x" << encode_threads;
+
+  std::cout << std::fixed << std::setprecision(3) << "  " << std::left
+            << std::setw(10) << mode.str() << std::right
+            << " wall " << elapsed.count() << "s  "
+            << std::setprecision(1) << raw_mb / elapsed.count() << " MB/s  "
+            << table.size() / elapsed.count() / 1e6 << " Mrows/s"
+            << std::endl;
+  std::cout << std::setprecision(3) << "             encode "
+            << stats.encode_seconds << "s  compress "
+            << stats.compress_seconds << "s  write " << stats.write_seconds
+            << "s  (" << stats.pages << " pages)" << std::endl;
+  std::cout << std::setprecision(1) << "             file "
+            << file_size / 1e6 << " MB (" << std::setprecision(3)
+            << static_cast<double>(file_size) / RawBytes(table)
+            << " of raw)  peak RSS " << std::setprecision(1) << peak_rss
+            << " MB (+" << peak_rss - base_rss << " MB over input)"
+            << std::endl;
+}
+
+std::vector<int> ParseThreads(const std::string &list) {
+  std::vector<int> threads;
+  std::stringstream ss(list);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    threads.push_back(std::stoi(item));
+  return threads;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  std::vector<double> scale_factors;
+  std::vector<int> threads;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg.rfind("--threads=", 0) == 0)
+      threads = ParseThreads(arg.substr(10));
+    else
+      scale_factors.push_back(std::stod(arg));
+  }
+  if (scale_factors.empty())
+    scale_factors = {0.01, 0.1, 1};
+  if (threads.empty()) {
+    // 0 = synchronous, then doubling encode threads up to the core count
+    const int cores =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    threads = {0};
+    for (int n = 1; n <= cores; n *= 2)
+      threads.push_back(n);
+  }
+
+  for (double sf : scale_factors) {
+    auto start = std::chrono::steady_clock::now();
+    LineItem table = Generate(sf);
+    std::chrono::duration<double> generated =
+        std::chrono::steady_clock::now() - start;
+    std::cout << "lineitem SF " << sf << ": " << table.size() << " rows, "
+              << std::setprecision(1) << std::fixed
+              << RawBytes(table) / 1e6 << " MB raw (generated in "
+              << std::setprecision(2) << generated.count() << "s)"
+              << std::endl;
+
+    RunBenchmark(table, 0, false); // Warmup: page cache and allocator
+    for (int n : threads)
+      RunBenchmark(table, n);
+    std::cout << "----------------------------------------" << std::endl;
+  }
+  std::remove(kOutput);
+  return 0;
+}
@@ -1,12 +1,16 @@
 #include "hpq/schema.h"
 #include "hpq/writer.h"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <numeric>
 #include <random>
 #include <vector>
 
-void RunBenchmark(const std::string &name, int num_rows, bool use_gpu) {
+void RunBenchmark(const std::string &name, int num_rows, bool use_gpu,
+                  int batch_size = 0) {
+  if (batch_size <= 0)
+    batch_size = num_rows;
   std::cout << "Running Benchmark: " << name << " (" << num_rows << " rows)"
             << std::endl;
 
@@ -40,10 +44,13 @@ void RunBenchmark(const std::string &name, int num_rows, bool use_gpu) {
   hpq::ParquetWriter writer("benchmark_out.parquet", options);
   writer.Init(schema);
 
-  writer.WriteColumn(0, col_id.data(), num_rows);
-  writer.WriteColumn(1, col_random.data(), num_rows);
-  writer.WriteColumn(2, col_repeat.data(), num_rows);
-  writer.WriteColumn(3, col_small.data(), num_rows);
+  for (int offset = 0; offset < num_rows; offset += batch_size) {
+    int n = std::min(batch_size, num_rows - offset);
+    writer.WriteColumn(0, col_id.data() + offset, n);
+    writer.WriteColumn(1, col_random.data() + offset, n);
+    writer.WriteColumn(2, col_repeat.data() + offset, n);
+    writer.WriteColumn(3, col_small.data() + offset, n);
+  }
 
   writer.Close();
 
@@ -66,6 +73,9 @@ int main() {
   // Run with 1M rows
   RunBenchmark("CPU Adaptive", 1000000, false);
 
+  // Small batches: per-call overhead dominates
+  RunBenchmark("CPU Adaptive (16-row batches)", 1000000, false, 16);
+
   // Run with GPU (Fallback on Mac)
   RunBenchmark("GPU (Fallback)", 1000000, true);
 
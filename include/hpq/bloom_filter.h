@@ -1,41 +1,51 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
 namespace hpq {
 
-// Bloom Filter implementation
-// Uses a simple bitset and multiple hash functions (simulated via double
-// hashing)
+// Parquet split block Bloom filter: 256-bit blocks of eight 32-bit words.
+// A value sets one bit in each word of the block its hash selects. Values
+// are hashed with xxHash64 (seed 0) over their PLAIN encoding, so filters
+// written here can be probed by any Parquet reader and vice versa.
 class BloomFilter {
 public:
-  // Initialize with expected number of items and desired false positive
-  // probability
+  static constexpr size_t kMinBytes = 32;
+  static constexpr size_t kMaxBytes = 128 << 20;
+
+  // Sized for expected_items distinct values at false positive
+  // probability fpp.
   BloomFilter(int expected_items, double fpp = 0.05);
 
+  // Wraps a serialized bitset; its size must be a power of two of at least
+  // kMinBytes.
+  explicit BloomFilter(const std::vector<uint8_t> &bitset);
+
+  // Bitset size for `ndv` distinct values at `fpp`: a power of two in
+  // [kMinBytes, kMaxBytes].
+  static size_t OptimalNumBytes(int64_t ndv, double fpp);
+
+  static uint64_t Hash(const void *data, size_t size);
+
+  void InsertHash(uint64_t hash);
+  bool FindHash(uint64_t hash) const;
+
+  // INT64 values and BYTE_ARRAY strings
   void Insert(int64_t value);
   void Insert(const std::string &value);
-
   bool Find(int64_t value) const;
   bool Find(const std::string &value) const;
 
-  // Serialize to buffer (Parquet Bloom Filter format is complex, we'll use a
-  // simple bitset dump for this demo)
+  size_t num_bytes() const { return words_.size() * sizeof(uint32_t); }
+
+  // The bitset as stored after the BloomFilterHeader.
   std::vector<uint8_t> Serialize() const;
 
 private:
-  std::vector<uint8_t> bitset_;
-  int num_bits_;
-  int num_hashes_;
-
-  // Hash functions
-  uint64_t Hash(int64_t value) const;
-  uint64_t Hash(const std::string &value) const;
-
-  void SetBit(int index);
-  bool GetBit(int index) const;
+  std::vector<uint32_t> words_; // 8 per block
 };
 
 } // namespace hpq
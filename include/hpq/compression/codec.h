@@ -0,0 +1,36 @@
+#pragma once
+
+#include "hpq/format/parquet_metadata.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace hpq {
+
+// CPU page codecs. SNAPPY is built in; GZIP needs zlib at build time
+// (HPQ_HAVE_ZLIB). UNCOMPRESSED is always available.
+bool CodecAvailable(Codec codec);
+
+// Upper bound of CompressBuffer() output for `size` input bytes.
+size_t MaxCompressedSize(Codec codec, size_t size);
+
+// Compresses `size` bytes into `out` (MaxCompressedSize bytes) and returns
+// the compressed length. With `store` the codec's uncompressed framing is
+// written instead (Snappy literals, deflate stored blocks): a valid stream
+// for the column chunk's codec at close to memcpy cost. Throws for
+// unavailable codecs.
+size_t CompressBuffer(Codec codec, const uint8_t *input, size_t size,
+                      uint8_t *out, bool store = false);
+
+// Decompresses into exactly `out_size` bytes. Throws std::runtime_error on
+// corrupt input or a size mismatch.
+void DecompressBuffer(Codec codec, const uint8_t *input, size_t size,
+                      uint8_t *out, size_t out_size);
+
+// Estimated compressed / raw size of `data` under `codec`, from trial
+// compression of a few evenly spaced slices (kCompressionSampleBytes in
+// total). Samples whose order-0 entropy is close to 8 bits per byte are
+// reported incompressible without a trial.
+constexpr size_t kCompressionSampleBytes = 16 * 1024;
+double EstimateCompressionRatio(Codec codec, const uint8_t *data, size_t size);
+
+} // namespace hpq
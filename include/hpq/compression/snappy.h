@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hpq {
+
+// Snappy raw block format (the framing Parquet's SNAPPY codec uses): a varint
+// uncompressed length, then literal and back-reference elements.
+
+size_t SnappyMaxCompressedLength(size_t size);
+
+// Compresses `size` bytes into `out`, which must hold
+// SnappyMaxCompressedLength(size) bytes. Returns the compressed length.
+size_t SnappyCompress(const uint8_t *input, size_t size, uint8_t *out);
+
+// Same framing with literals only: a valid stream that costs a memcpy to
+// write and to read back.
+size_t SnappyStore(const uint8_t *input, size_t size, uint8_t *out);
+
+// Decompresses into exactly `out_size` bytes. Throws std::runtime_error on
+// corrupt input or a length mismatch.
+void SnappyDecompress(const uint8_t *input, size_t size, uint8_t *out,
+                      size_t out_size);
+
+} // namespace hpq
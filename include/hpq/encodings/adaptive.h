@@ -1,33 +1,124 @@
 #pragma once
 
 #include "hpq/encodings/encoding_base.h"
+#include "hpq/format/parquet_metadata.h"
 #include "hpq/schema.h"
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace hpq {
 
-// AdaptiveEncoder buffers data for a row group (or page),
-// analyzes it, and chooses the best encoding (Plain, RLE, BitPack).
-class AdaptiveEncoder : public Encoder {
+// What an adaptive analysis chose and the statistics the choice rests on.
+struct AdaptiveProfile {
+  enum class Choice : uint8_t {
+    kPlain,
+    kDelta,               // DELTA_BINARY_PACKED (INT32)
+    kRle,                 // BOOLEAN
+    kByteStreamSplit,     // FLOAT, DOUBLE
+    kDeltaByteArray,      // BYTE_ARRAY
+    kDeltaLengthByteArray // BYTE_ARRAY
+  };
+  Choice choice = Choice::kPlain;
+  int bit_width = -1;  // INT32: bits of the largest value, -1 with negatives
+  bool runs = false;   // INT32: runs longer than 10 values
+  double ratio = 0;    // FLOAT/DOUBLE: split / interleaved byte entropy;
+                       // BYTE_ARRAY: shared prefix bytes per value byte
+};
+
+// A column's adaptive decision, kept across its pages and row groups and
+// shared by the encoders working on them (thread-safe). Once a full
+// analysis has been stored, later chunks only analyze a sample of evenly
+// spaced windows; the full analysis runs again when the sample disagrees
+// with the stored choice or its statistics drift (a wider INT32 bit width,
+// a jump in the entropy ratio or prefix sharing).
+class AdaptiveDecisionCache {
+public:
+  // False until a full analysis has been stored.
+  bool Get(AdaptiveProfile *profile) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (valid_)
+      *profile = profile_;
+    return valid_;
+  }
+  void Set(const AdaptiveProfile &profile) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    profile_ = profile;
+    valid_ = true;
+    analyses_.fetch_add(1, std::memory_order_relaxed);
+  }
+  void CountReuse() { reuses_.fetch_add(1, std::memory_order_relaxed); }
+
+  int64_t analyses() const { return analyses_.load(); } // Full analyses
+  int64_t reuses() const { return reuses_.load(); }     // Sample agreed
+
+private:
+  mutable std::mutex mutex_;
+  bool valid_ = false;
+  AdaptiveProfile profile_;
+  std::atomic<int64_t> analyses_{0};
+  std::atomic<int64_t> reuses_{0};
+};
+
+// TypedAdaptiveEncoder buffers data for a row group (or page),
+// analyzes it, and chooses the best encoding (Plain, RLE, BitPack,
+// BYTE_STREAM_SPLIT, or DELTA_BYTE_ARRAY / DELTA_LENGTH_BYTE_ARRAY for
+// BYTE_ARRAY values, whose bytes are copied on Put()). The codec the page
+// will be compressed with feeds the decisions that only pay off after
+// compression. With a cache, a column's earlier decision is reused when a
+// sample of the new chunk agrees with it.
+template <typename DType>
+class TypedAdaptiveEncoder final : public TypedEncoder<DType> {
 public:
-  explicit AdaptiveEncoder(Type type);
+  using c_type = typename DType::c_type;
 
-  void Put(const void *values, int num_values) override;
+  explicit TypedAdaptiveEncoder(Codec codec = Codec::UNCOMPRESSED,
+                                AdaptiveDecisionCache *cache = nullptr)
+      : codec_(codec), cache_(cache) {}
+
+  void PutTyped(const c_type *values, int num_values) override;
   std::pair<const uint8_t *, size_t> Flush() override;
   void Clear() override;
+  Encoding encoding() const override;
 
 private:
-  Type type_;
-  // We need to store raw bytes or typed values.
-  // For simplicity, let's store raw bytes and cast when needed.
-  std::vector<uint8_t> raw_buffer_;
-  int num_values_ = 0;
+  Codec codec_;
+  AdaptiveDecisionCache *cache_;
+  std::vector<c_type> values_;
+  std::vector<uint8_t> bytes_; // BYTE_ARRAY: value bytes, back to back
 
   // The chosen encoder for the current chunk
   std::unique_ptr<Encoder> current_encoder_;
 
   void DecideAndEncode();
+  AdaptiveProfile Analyze(const c_type *values, int num_values) const;
+  bool Drifted(const AdaptiveProfile &cached) const;
+};
+
+extern template class TypedAdaptiveEncoder<BooleanType>;
+extern template class TypedAdaptiveEncoder<Int32Type>;
+extern template class TypedAdaptiveEncoder<Int64Type>;
+extern template class TypedAdaptiveEncoder<FloatType>;
+extern template class TypedAdaptiveEncoder<DoubleType>;
+extern template class TypedAdaptiveEncoder<ByteArrayType>;
+
+// Runtime-typed adapter over TypedAdaptiveEncoder; the type is resolved once
+// at construction.
+class AdaptiveEncoder : public Encoder {
+public:
+  explicit AdaptiveEncoder(Type type, Codec codec = Codec::UNCOMPRESSED);
+
+  void Put(const void *values, int num_values) override {
+    impl_->Put(values, num_values);
+  }
+  std::pair<const uint8_t *, size_t> Flush() override { return impl_->Flush(); }
+  void Clear() override { impl_->Clear(); }
+  Encoding encoding() const override { return impl_->encoding(); }
+
+private:
+  std::unique_ptr<Encoder> impl_;
 };
 
 } // namespace hpq
@@ -10,6 +10,14 @@
 
 namespace hpq {
 
+// Unpacks n values of bit_width bits, LSB-first (the BitPackEncoder layout),
+// reading exactly (n * bit_width + 7) / 8 bytes. Each width has its own
+// kernel; with AVX2, widths up to 32 decode 8 values per gather.
+void UnpackBits(const uint8_t *in, int bit_width, size_t n, uint32_t *out);
+
+// As UnpackBits for widths up to 64 (DELTA_BINARY_PACKED deltas).
+void UnpackBits64(const uint8_t *in, int bit_width, size_t n, uint64_t *out);
+
 class BitPackEncoder : public Encoder {
 public:
   explicit BitPackEncoder(int bit_width);
@@ -17,6 +25,7 @@ public:
   void Put(const void *values, int num_values) override;
   std::pair<const uint8_t *, size_t> Flush() override;
   void Clear() override;
+  Encoding encoding() const override { return Encoding::BIT_PACKED; }
 
 private:
   int bit_width_;
@@ -27,4 +36,22 @@ private:
   void Pack8Values(const uint32_t *in, uint8_t *out);
 };
 
+// Reads BitPackEncoder output. The bit width is not stored in the data, so
+// it is given here as it was to the encoder.
+class BitPackDecoder final : public TypedDecoder<Int32Type> {
+public:
+  explicit BitPackDecoder(int bit_width);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int DecodeTyped(int32_t *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::BIT_PACKED; }
+
+private:
+  int bit_width_;
+  const uint8_t *data_ = nullptr;
+  int position_ = 0;
+  int num_values_ = 0;
+  uint32_t group_[8];
+};
+
 } // namespace hpq
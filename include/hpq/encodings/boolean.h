@@ -0,0 +1,56 @@
+#pragma once
+
+#include "hpq/encodings/encoding_base.h"
+#include "hpq/encodings/rle.h"
+#include <vector>
+
+namespace hpq {
+
+// Packs one-byte booleans (0 = false, anything else = true) into LSB-first
+// bits, the Parquet PLAIN layout for BOOLEAN. out must hold (n + 7) / 8 bytes.
+void PackBooleans(const uint8_t *values, size_t n, uint8_t *out);
+
+// Inverse of PackBooleans: expands n LSB-first bits into 0/1 bytes.
+void UnpackBooleans(const uint8_t *bits, size_t n, uint8_t *out);
+
+// BOOLEAN encoder. Input is one byte per value.
+//  - PLAIN: bit-packed, 1 bit per value.
+//  - RLE:   4-byte length + RLE/bit-packed hybrid (bit width 1); long runs of
+//           identical values collapse to a few bytes.
+class BooleanEncoder final : public TypedEncoder<BooleanType> {
+public:
+  explicit BooleanEncoder(Encoding encoding = Encoding::PLAIN);
+
+  void PutTyped(const uint8_t *values, int num_values) override;
+  std::pair<const uint8_t *, size_t> Flush() override;
+  void Clear() override;
+  Encoding encoding() const override { return encoding_; }
+
+private:
+  Encoding encoding_;
+  std::vector<uint8_t> bits_; // PLAIN bit-packed values
+  size_t num_values_ = 0;
+  std::vector<uint8_t> buffer_; // RLE output
+
+  void EncodeRle();
+};
+
+// Reads BooleanEncoder output (PLAIN or RLE) into one byte (0/1) per value.
+class BooleanDecoder final : public TypedDecoder<BooleanType> {
+public:
+  explicit BooleanDecoder(Encoding encoding = Encoding::PLAIN);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int DecodeTyped(uint8_t *out, int max_values) override;
+  Encoding encoding() const override { return encoding_; }
+
+private:
+  Encoding encoding_;
+  const uint8_t *bits_ = nullptr; // PLAIN
+  size_t position_ = 0;
+  RleBitPackedReader reader_; // RLE
+  std::vector<uint32_t> scratch_;
+  int remaining_ = 0;
+};
+
+} // namespace hpq
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "hpq/encodings/encoding_base.h"
+#include <vector>
+
+namespace hpq {
+
+// Scatters byte k of every value into stream k: out[k * n + i] = byte k of
+// value i. width is 4 (FLOAT) or 8 (DOUBLE).
+void SplitByteStreams(const uint8_t *values, size_t n, size_t width,
+                      uint8_t *out);
+
+// Inverse of SplitByteStreams: out[i * width + k] = streams[k * stride + i]
+// for i < n. stride is the page's total value count, so a batch starting at
+// value p passes streams + p.
+void MergeByteStreams(const uint8_t *streams, size_t stride, size_t n,
+                      size_t width, uint8_t *out);
+
+// BYTE_STREAM_SPLIT encoding for FLOAT/DOUBLE. Does not shrink the data by
+// itself, but grouping exponent and high mantissa bytes together makes the
+// page much more compressible.
+class ByteStreamSplitEncoder : public Encoder {
+public:
+  explicit ByteStreamSplitEncoder(Type type);
+
+  void Put(const void *values, int num_values) override;
+  std::pair<const uint8_t *, size_t> Flush() override;
+  void Clear() override;
+  Encoding encoding() const override { return Encoding::BYTE_STREAM_SPLIT; }
+
+private:
+  size_t width_;
+  std::vector<uint8_t> raw_buffer_;
+  std::vector<uint8_t> buffer_;
+};
+
+class ByteStreamSplitDecoder : public Decoder {
+public:
+  explicit ByteStreamSplitDecoder(Type type);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int Decode(void *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::BYTE_STREAM_SPLIT; }
+
+private:
+  size_t width_;
+  const uint8_t *data_ = nullptr;
+  size_t stride_ = 0;
+  size_t position_ = 0;
+};
+
+} // namespace hpq
@@ -2,28 +2,116 @@
 
 #include "hpq/encodings/bitpack.h"
 #include "hpq/encodings/encoding_base.h"
+#include <memory>
 #include <vector>
 
 namespace hpq {
 
 // Delta Binary Packed Encoding
 // Supported Types: INT32, INT64
-class DeltaEncoder : public Encoder {
+template <typename DType>
+class TypedDeltaEncoder final : public TypedEncoder<DType> {
+  static_assert(DType::is_integer, "Delta encoding needs an integer type");
+
 public:
-  explicit DeltaEncoder(Type type);
+  using c_type = typename DType::c_type;
 
-  void Put(const void *values, int num_values) override;
+  void PutTyped(const c_type *values, int num_values) override;
   std::pair<const uint8_t *, size_t> Flush() override;
   void Clear() override;
+  Encoding encoding() const override {
+    return Encoding::DELTA_BINARY_PACKED;
+  }
 
 private:
-  Type type_;
   std::vector<int64_t>
       buffered_values_; // Store as int64 to cover both int32/int64
   std::vector<uint8_t> buffer_;
+};
+
+extern template class TypedDeltaEncoder<Int32Type>;
+extern template class TypedDeltaEncoder<Int64Type>;
+
+// Runtime-typed adapter: resolves the TypedDeltaEncoder once at construction.
+class DeltaEncoder : public Encoder {
+public:
+  explicit DeltaEncoder(Type type);
+
+  void Put(const void *values, int num_values) override {
+    impl_->Put(values, num_values);
+  }
+  std::pair<const uint8_t *, size_t> Flush() override { return impl_->Flush(); }
+  void Clear() override { impl_->Clear(); }
+  Encoding encoding() const override {
+    return Encoding::DELTA_BINARY_PACKED;
+  }
+
+private:
+  std::unique_ptr<Encoder> impl_;
+};
+
+// Inclusive prefix sum for DELTA_BINARY_PACKED: out[i] = prev + sum over
+// j <= i of (min_delta + deltas[j]), in wrapping 64-bit arithmetic. AVX2
+// scans 4 lanes per step.
+void DeltaPrefixSum(const uint64_t *deltas, size_t n, int64_t min_delta,
+                    int64_t prev, int64_t *out);
+
+// Reads DELTA_BINARY_PACKED data: TypedDeltaEncoder output, or any writer
+// following the spec (per-miniblock bit widths up to 64).
+template <typename DType>
+class TypedDeltaDecoder final : public TypedDecoder<DType> {
+  static_assert(DType::is_integer, "Delta encoding needs an integer type");
 
-  // Helper to encode a block of integers
-  void EncodeBlock(const int64_t *values, int count);
+public:
+  using c_type = typename DType::c_type;
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int DecodeTyped(c_type *out, int max_values) override;
+  Encoding encoding() const override {
+    return Encoding::DELTA_BINARY_PACKED;
+  }
+
+  // Next unread byte. Once every value has been decoded this is the end of
+  // the stream, where data embedded after it (DELTA_LENGTH_BYTE_ARRAY)
+  // starts.
+  const uint8_t *position() const { return data_; }
+
+private:
+  const uint8_t *data_ = nullptr;
+  const uint8_t *end_ = nullptr;
+  uint64_t values_per_block_ = 0;
+  uint64_t mini_blocks_ = 0;
+  int remaining_ = 0;      // Values not yet returned
+  bool first_pending_ = false;
+  int64_t last_value_ = 0;
+
+  std::vector<uint64_t> deltas_;
+  std::vector<int64_t> block_; // Decoded values of the current block
+  size_t block_pos_ = 0;
+
+  void DecodeBlock();
+};
+
+extern template class TypedDeltaDecoder<Int32Type>;
+extern template class TypedDeltaDecoder<Int64Type>;
+
+// Runtime-typed adapter over TypedDeltaDecoder.
+class DeltaDecoder : public Decoder {
+public:
+  explicit DeltaDecoder(Type type);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override {
+    impl_->SetData(data, size, num_values);
+  }
+  int Decode(void *out, int max_values) override {
+    return impl_->Decode(out, max_values);
+  }
+  Encoding encoding() const override {
+    return Encoding::DELTA_BINARY_PACKED;
+  }
+
+private:
+  std::unique_ptr<Decoder> impl_;
 };
 
 } // namespace hpq
@@ -3,36 +3,66 @@
 #include "hpq/encodings/bitpack.h"
 #include "hpq/encodings/encoding_base.h"
 #include "hpq/encodings/rle.h"
+#include "hpq/util/memory_budget.h"
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
-#include <variant>
 #include <vector>
 
 namespace hpq {
 
-// Dictionary Encoder for generic types (currently specialized for
-// strings/integers) For simplicity in this advanced phase, we'll focus on INT64
-// and Strings (simulated as byte arrays).
-class DictEncoder : public Encoder {
+// Chunk-local dictionary index of a persisted key, valid while its
+// generation matches the encoder's (see TypedDictEncoder).
+struct DictSlot {
+  uint32_t generation = 0;
+  int32_t index = 0;
+};
+
+// Dictionary Encoder for fixed-width numeric types. Output layout:
+// [NumEntries: 4 bytes] [Value1] [Value2] ... [BitWidth: 1 byte]
+// [BitPacked Indices]
+//
+// The hash table survives Clear(), so a stable column does not rebuild it
+// every chunk. Each flushed dictionary still holds only the values seen in
+// that chunk: keys map to a persistent slot that carries the chunk-local
+// index under a generation tag. When most persisted keys go unused by a
+// chunk (the value distribution drifted), the table is dropped.
+//
+// With a MemoryConsumer, the table and chunk buffers are charged to it,
+// updated at each Flush() and Clear(), so a budget sees the dictionary grow.
+template <typename DType>
+class TypedDictEncoder final : public TypedEncoder<DType> {
+  static_assert(DType::is_integer || DType::is_floating_point,
+                "Dictionary encoding needs a numeric type");
+
 public:
-  explicit DictEncoder(Type type);
+  using c_type = typename DType::c_type;
 
-  void Put(const void *values, int num_values) override;
+  explicit TypedDictEncoder(MemoryConsumer *memory = nullptr)
+      : memory_(memory) {}
+
+  void PutTyped(const c_type *values, int num_values) override;
   std::pair<const uint8_t *, size_t> Flush() override;
   void Clear() override;
+  Encoding encoding() const override { return Encoding::RLE_DICTIONARY; }
+
+  // Keys kept across chunks (for tests and tuning).
+  size_t persistent_size() const { return dict_.size(); }
 
 private:
-  Type type_;
+  // Values are keyed by bit pattern so floats hash consistently (NaN payloads
+  // and -0.0 stay distinct entries, as PLAIN would store them).
+  using key_type =
+      std::conditional_t<sizeof(c_type) == 4, uint32_t, uint64_t>;
 
-  // Dictionary: Value -> Index
-  // We use a variant to handle different key types for the map
-  // For simplicity/performance in this demo, we'll use separate maps or a
-  // template approach. Let's use a template-like approach with void* casting
-  // for the "Advanced" demo, or just support INT64 for now to demonstrate the
-  // mechanics without template bloat. Actually, let's do INT64.
+  // Persistent dictionary: Value -> Slot number
+  std::unordered_map<key_type, uint32_t> dict_;
+  std::vector<DictSlot> slots_;
+  uint32_t generation_ = 1;
 
-  std::unordered_map<int64_t, int32_t> dict_int64_;
-  std::vector<int64_t> dict_values_int64_;
+  // Values of the current chunk, in chunk-local index order
+  std::vector<c_type> dict_values_;
 
   // Indices of the data
   std::vector<int32_t> indices_;
@@ -40,6 +70,134 @@ private:
   // We need an RLE/BitPack encoder for the indices
   // The bit width for indices depends on the dictionary size.
   std::vector<uint8_t> buffer_;
+
+  MemoryCharge memory_;
+
+  // Heap bytes held by the table and the chunk buffers.
+  size_t Footprint() const;
+};
+
+extern template class TypedDictEncoder<Int32Type>;
+extern template class TypedDictEncoder<Int64Type>;
+extern template class TypedDictEncoder<FloatType>;
+extern template class TypedDictEncoder<DoubleType>;
+
+// FIXED_LEN_BYTE_ARRAY values (type_length bytes each, back to back) in the
+// TypedDictEncoder layout, with the same warm start and memory charge
+// across chunks. Keys live in one persistent buffer indexed by an
+// open-addressing table.
+class FixedLenDictEncoder final : public Encoder {
+public:
+  explicit FixedLenDictEncoder(int type_length,
+                               MemoryConsumer *memory = nullptr);
+
+  void Put(const void *values, int num_values) override;
+  std::pair<const uint8_t *, size_t> Flush() override;
+  void Clear() override;
+  Encoding encoding() const override { return Encoding::RLE_DICTIONARY; }
+
+  size_t persistent_size() const { return slots_.size(); }
+
+private:
+  size_t width_;
+  std::vector<uint8_t> keys_;   // Persisted keys, in slot order
+  std::vector<uint32_t> table_; // Slot number + 1; 0 is an empty bucket
+  std::vector<DictSlot> slots_;
+  uint32_t generation_ = 1;
+
+  std::vector<uint8_t> dict_values_; // Current chunk, chunk-local order
+  int32_t num_entries_ = 0;
+  std::vector<int32_t> indices_;
+  std::vector<uint8_t> buffer_;
+  MemoryCharge memory_;
+
+  uint32_t FindOrInsert(const uint8_t *value);
+  void Rehash(size_t buckets);
+  size_t Footprint() const;
+};
+
+// Runtime-typed adapter: resolves the TypedDictEncoder once at construction.
+// type_length is only used for FIXED_LEN_BYTE_ARRAY.
+class DictEncoder : public Encoder {
+public:
+  explicit DictEncoder(Type type, int type_length = 0,
+                       MemoryConsumer *memory = nullptr);
+
+  void Put(const void *values, int num_values) override {
+    impl_->Put(values, num_values);
+  }
+  std::pair<const uint8_t *, size_t> Flush() override { return impl_->Flush(); }
+  void Clear() override { impl_->Clear(); }
+  Encoding encoding() const override { return Encoding::RLE_DICTIONARY; }
+
+private:
+  std::unique_ptr<Encoder> impl_;
+};
+
+// Reads TypedDictEncoder output: indices are bit-unpacked in chunks and
+// looked up in the dictionary with a vector gather (GatherIndexed).
+template <typename DType>
+class TypedDictDecoder final : public TypedDecoder<DType> {
+  static_assert(DType::is_integer || DType::is_floating_point,
+                "Dictionary encoding needs a numeric type");
+
+public:
+  using c_type = typename DType::c_type;
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int DecodeTyped(c_type *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::RLE_DICTIONARY; }
+
+  int dictionary_size() const { return dict_size_; }
+
+private:
+  const uint8_t *dict_ = nullptr; // Unaligned dictionary values
+  int dict_size_ = 0;
+  std::unique_ptr<BitPackDecoder> index_decoder_;
+  std::vector<int32_t> indices_;
+  int remaining_ = 0;
+};
+
+extern template class TypedDictDecoder<Int32Type>;
+extern template class TypedDictDecoder<Int64Type>;
+extern template class TypedDictDecoder<FloatType>;
+extern template class TypedDictDecoder<DoubleType>;
+
+// Reads FixedLenDictEncoder output into type_length-byte values.
+class FixedLenDictDecoder final : public Decoder {
+public:
+  explicit FixedLenDictDecoder(int type_length);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int Decode(void *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::RLE_DICTIONARY; }
+
+  int dictionary_size() const { return dict_size_; }
+
+private:
+  size_t width_;
+  const uint8_t *dict_ = nullptr;
+  int dict_size_ = 0;
+  std::unique_ptr<BitPackDecoder> index_decoder_;
+  std::vector<int32_t> indices_;
+  int remaining_ = 0;
+};
+
+// Runtime-typed adapter over TypedDictDecoder and FixedLenDictDecoder.
+class DictDecoder : public Decoder {
+public:
+  explicit DictDecoder(Type type, int type_length = 0);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override {
+    impl_->SetData(data, size, num_values);
+  }
+  int Decode(void *out, int max_values) override {
+    return impl_->Decode(out, max_values);
+  }
+  Encoding encoding() const override { return Encoding::RLE_DICTIONARY; }
+
+private:
+  std::unique_ptr<Decoder> impl_;
 };
 
 } // namespace hpq
@@ -1,12 +1,26 @@
 #pragma once
 
 #include "hpq/schema.h"
+#include "hpq/type_traits.h"
 #include <cstdint>
 #include <memory>
 #include <vector>
 
 namespace hpq {
 
+// Parquet Encoding enum values (parquet.thrift), recorded in page headers.
+enum class Encoding : int32_t {
+  PLAIN = 0,
+  PLAIN_DICTIONARY = 2,
+  RLE = 3,
+  BIT_PACKED = 4,
+  DELTA_BINARY_PACKED = 5,
+  DELTA_LENGTH_BYTE_ARRAY = 6,
+  DELTA_BYTE_ARRAY = 7,
+  RLE_DICTIONARY = 8,
+  BYTE_STREAM_SPLIT = 9
+};
+
 class Encoder {
 public:
   virtual ~Encoder() = default;
@@ -21,8 +35,140 @@ public:
 
   // Clear internal state
   virtual void Clear() = 0;
+
+  // Encoding of the data returned by Flush()
+  virtual Encoding encoding() const = 0;
+};
+
+// Typed layer under the virtual interface. Concrete typed encoders are final,
+// so callers holding the concrete type call PutTyped() without a virtual
+// dispatch and get loops specialized for DType::c_type. Put() is the thin
+// adapter for callers that only know the runtime Type.
+template <typename DType> class TypedEncoder : public Encoder {
+public:
+  using c_type = typename DType::c_type;
+
+  virtual void PutTyped(const c_type *values, int num_values) = 0;
+
+  void Put(const void *values, int num_values) final {
+    PutTyped(static_cast<const c_type *>(values), num_values);
+  }
+};
+
+template <typename DType> class PlainEncoder final : public TypedEncoder<DType> {
+public:
+  using c_type = typename DType::c_type;
+
+  void PutTyped(const c_type *values, int num_values) override;
+  std::pair<const uint8_t *, size_t> Flush() override;
+  void Clear() override { buffer_.clear(); }
+  Encoding encoding() const override { return Encoding::PLAIN; }
+
+private:
+  std::vector<uint8_t> buffer_;
+};
+
+extern template class PlainEncoder<Int32Type>;
+extern template class PlainEncoder<Int64Type>;
+extern template class PlainEncoder<FloatType>;
+extern template class PlainEncoder<DoubleType>;
+// BYTE_ARRAY: 4-byte little-endian length, then the bytes, per value.
+template <>
+void PlainEncoder<ByteArrayType>::PutTyped(const ByteArray *values,
+                                           int num_values);
+extern template class PlainEncoder<ByteArrayType>;
+
+// FIXED_LEN_BYTE_ARRAY: values of type_length bytes, back to back, both on
+// input and in the PLAIN form.
+class FixedLenPlainEncoder final : public Encoder {
+public:
+  explicit FixedLenPlainEncoder(int type_length);
+
+  void Put(const void *values, int num_values) override;
+  std::pair<const uint8_t *, size_t> Flush() override {
+    return {buffer_.data(), buffer_.size()};
+  }
+  void Clear() override { buffer_.clear(); }
+  Encoding encoding() const override { return Encoding::PLAIN; }
+
+private:
+  size_t width_;
+  std::vector<uint8_t> buffer_;
+};
+
+// type_length is only used for FIXED_LEN_BYTE_ARRAY.
+std::unique_ptr<Encoder> MakePlainEncoder(Type type, int type_length = 0);
+
+// Read side of an encoding. A decoder is pointed at one page's encoded values
+// and drained in batches; throws std::runtime_error on malformed input.
+class Decoder {
+public:
+  virtual ~Decoder() = default;
+
+  // `data` holds num_values encoded values and must stay alive until they
+  // have been decoded.
+  virtual void SetData(const uint8_t *data, size_t size, int num_values) = 0;
+
+  // Decodes up to max_values values into out. Returns the number decoded,
+  // which is less than max_values only once the data is exhausted.
+  virtual int Decode(void *out, int max_values) = 0;
+
+  virtual Encoding encoding() const = 0;
+};
+
+// Typed layer under Decoder, mirroring TypedEncoder.
+template <typename DType> class TypedDecoder : public Decoder {
+public:
+  using c_type = typename DType::c_type;
+
+  virtual int DecodeTyped(c_type *out, int max_values) = 0;
+
+  int Decode(void *out, int max_values) final {
+    return DecodeTyped(static_cast<c_type *>(out), max_values);
+  }
+};
+
+template <typename DType> class PlainDecoder final : public TypedDecoder<DType> {
+public:
+  using c_type = typename DType::c_type;
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int DecodeTyped(c_type *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::PLAIN; }
+
+private:
+  const uint8_t *data_ = nullptr;
+  const uint8_t *end_ = nullptr;
+  int remaining_ = 0;
+};
+
+extern template class PlainDecoder<Int32Type>;
+extern template class PlainDecoder<Int64Type>;
+extern template class PlainDecoder<FloatType>;
+extern template class PlainDecoder<DoubleType>;
+// BYTE_ARRAY values point into the page data.
+template <>
+void PlainDecoder<ByteArrayType>::SetData(const uint8_t *data, size_t size,
+                                          int num_values);
+template <>
+int PlainDecoder<ByteArrayType>::DecodeTyped(ByteArray *out, int max_values);
+extern template class PlainDecoder<ByteArrayType>;
+
+// Decodes into type_length-byte values, back to back.
+class FixedLenPlainDecoder final : public Decoder {
+public:
+  explicit FixedLenPlainDecoder(int type_length);
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int Decode(void *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::PLAIN; }
+
+private:
+  size_t width_;
+  const uint8_t *data_ = nullptr;
+  int remaining_ = 0;
 };
 
-std::unique_ptr<Encoder> MakePlainEncoder(Type type);
+std::unique_ptr<Decoder> MakePlainDecoder(Type type, int type_length = 0);
 
 } // namespace hpq
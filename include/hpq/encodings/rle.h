@@ -5,6 +5,9 @@
 
 namespace hpq {
 
+// RLE/bit-packed hybrid (Parquet RLE) without a length prefix: varint run
+// headers, RLE values in (bit_width + 7) / 8 little-endian bytes, literal
+// runs in whole groups of 8 bit-packed values.
 class RleEncoder : public Encoder {
 public:
   explicit RleEncoder(int bit_width);
@@ -12,6 +15,7 @@ public:
   void Put(const void *values, int num_values) override;
   std::pair<const uint8_t *, size_t> Flush() override;
   void Clear() override;
+  Encoding encoding() const override { return Encoding::RLE; }
 
 private:
   int bit_width_;
@@ -23,8 +27,51 @@ private:
   int run_length_ = 0;
   std::vector<uint32_t> literal_buffer_;
 
+  void EndRun();
   void FlushRun();
-  void FlushLiterals();
+  void FlushLiterals(bool final);
+};
+
+// Streaming reader for the hybrid, shared by RleDecoder, BooleanDecoder
+// (bit width 1), definition levels and dictionary indices.
+class RleBitPackedReader {
+public:
+  RleBitPackedReader() = default;
+  RleBitPackedReader(const uint8_t *data, size_t size, int bit_width);
+
+  // Decodes up to n values; returns fewer only when the data runs out.
+  // Repeated runs expand with a fill, literal runs unpack whole groups
+  // straight into out.
+  int GetBatch(uint32_t *out, int n);
+
+private:
+  const uint8_t *data_ = nullptr;
+  const uint8_t *end_ = nullptr;
+  int bit_width_ = 0;
+
+  uint32_t repeat_value_ = 0;
+  int64_t repeat_count_ = 0;
+  const uint8_t *literals_ = nullptr; // Start of the current literal run
+  int64_t literal_count_ = 0;         // Values in the current literal run
+  int64_t literal_pos_ = 0;
+  uint32_t group_[8];
+
+  bool NextRun();
+};
+
+// Reads RleEncoder output with the same bit width.
+class RleDecoder final : public TypedDecoder<Int32Type> {
+public:
+  explicit RleDecoder(int bit_width) : bit_width_(bit_width) {}
+
+  void SetData(const uint8_t *data, size_t size, int num_values) override;
+  int DecodeTyped(int32_t *out, int max_values) override;
+  Encoding encoding() const override { return Encoding::RLE; }
+
+private:
+  int bit_width_;
+  RleBitPackedReader reader_;
+  int remaining_ = 0;
 };
 
 } // namespace hpq
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hpq {
+
+// AoS -> SoA: copies the `width`-byte field found at rows + i * stride for
+// i in [0, n) into out[i * width]. Widths 4 and 8 use AVX2 gathers; other
+// widths fall back to per-row copies.
+void GatherField(const uint8_t *rows, size_t stride, size_t width, size_t n,
+                 uint8_t *out);
+
+// Selection gather: copies values[indices[i]] (each `width` bytes) into
+// out[i * width] for i in [0, n). Indices must be below 2^31. Widths 4 and 8
+// use AVX2 gathers.
+void GatherIndexed(const uint8_t *values, size_t width,
+                   const uint32_t *indices, size_t n, uint8_t *out);
+
+} // namespace hpq
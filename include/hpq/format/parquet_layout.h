@@ -0,0 +1,30 @@
+#pragma once
+
+#include "hpq/format/parquet_metadata.h"
+#include "hpq/io/output_stream.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hpq {
+
+constexpr char kParquetMagic[4] = {'P', 'A', 'R', '1'};
+
+// File layout:
+//   "PAR1" <column chunk pages ...> <FileMetaData> <4-byte length> "PAR1"
+void WriteFileHeader(OutputStream &out);
+void WriteFileFooter(OutputStream &out, const FileMetaData &metadata);
+
+// Reads and parses the footer of the Parquet file open for reading on `fd`
+// (`filename` is for error messages). *footer_offset receives where the
+// serialized FileMetaData starts, which is where the data and indexes end.
+// Throws std::runtime_error on a missing or malformed footer.
+FileMetaData ReadFileFooter(int fd, const std::string &filename,
+                            int64_t *footer_offset);
+
+// Appends the RLE/bit-packed hybrid definition levels of a v1 data page for a
+// flat OPTIONAL column with no nulls (a single run of 1s), including the
+// 4-byte length prefix.
+void AppendAllDefinedLevels(std::vector<uint8_t> *out, int32_t num_values);
+
+} // namespace hpq
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "hpq/encodings/encoding_base.h"
+#include "hpq/schema.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hpq {
+
+// Parquet CompressionCodec (parquet.thrift)
+enum class Codec : int32_t {
+  UNCOMPRESSED = 0,
+  SNAPPY = 1,
+  GZIP = 2,
+  LZO = 3,
+  BROTLI = 4,
+  LZ4 = 5,
+  ZSTD = 6
+};
+
+// Maps WriterOptions::compression ("SNAPPY", "GZIP", "ZSTD", "NONE").
+Codec ParseCodec(const std::string &name);
+
+// Parquet PageType (parquet.thrift)
+enum class PageType : int32_t {
+  DATA_PAGE = 0,
+  INDEX_PAGE = 1,
+  DICTIONARY_PAGE = 2,
+  DATA_PAGE_V2 = 3
+};
+
+struct DataPageHeader {
+  int32_t num_values = 0;
+  Encoding encoding = Encoding::PLAIN;
+  Encoding definition_level_encoding = Encoding::RLE;
+  Encoding repetition_level_encoding = Encoding::RLE;
+};
+
+struct PageHeader {
+  PageType type = PageType::DATA_PAGE;
+  int32_t uncompressed_page_size = 0;
+  int32_t compressed_page_size = 0;
+  std::optional<int32_t> crc;
+  DataPageHeader data_page_header;
+};
+
+// Statistics (parquet.thrift). Bounds hold PLAIN-encoded values (see
+// hpq/format/statistics.h).
+struct Statistics {
+  std::optional<std::string> min_value;
+  std::optional<std::string> max_value;
+  std::optional<int64_t> null_count;
+};
+
+struct ColumnChunkMetaData {
+  Type type = Type::INT32;
+  std::vector<Encoding> encodings;
+  std::vector<std::string> path_in_schema;
+  Codec codec = Codec::UNCOMPRESSED;
+  int64_t num_values = 0;
+  int64_t total_uncompressed_size = 0;
+  int64_t total_compressed_size = 0;
+  int64_t data_page_offset = 0;
+  std::optional<int64_t> dictionary_page_offset;
+  std::optional<Statistics> statistics;
+  std::optional<int64_t> bloom_filter_offset; // BloomFilterHeader + bitset
+  std::optional<int32_t> bloom_filter_length;
+
+  // Page index locations, stored on the ColumnChunk
+  std::optional<int64_t> offset_index_offset;
+  std::optional<int32_t> offset_index_length;
+  std::optional<int64_t> column_index_offset;
+  std::optional<int32_t> column_index_length;
+};
+
+// One key of the order a row group's rows are sorted in.
+struct SortingColumn {
+  int32_t column_idx = 0;
+  bool descending = false;
+  bool nulls_first = false;
+};
+
+struct RowGroupMetaData {
+  std::vector<ColumnChunkMetaData> columns;
+  int64_t total_byte_size = 0;
+  int64_t num_rows = 0;
+  std::vector<SortingColumn> sorting_columns; // Empty: unsorted
+  int64_t file_offset = 0;
+  int64_t total_compressed_size = 0;
+  int16_t ordinal = 0;
+};
+
+struct FileMetaData {
+  int32_t version = 1;
+  std::vector<ColumnSchema> schema; // Flat schema: leaf columns only
+  int64_t num_rows = 0;
+  std::vector<RowGroupMetaData> row_groups;
+  std::string created_by = "highperf-parquet";
+};
+
+// Page index (parquet.thrift): per-page bounds for one column chunk...
+enum class BoundaryOrder : int32_t {
+  UNORDERED = 0,
+  ASCENDING = 1,
+  DESCENDING = 2
+};
+
+struct ColumnIndex {
+  std::vector<bool> null_pages;
+  std::vector<std::string> min_values;
+  std::vector<std::string> max_values;
+  BoundaryOrder boundary_order = BoundaryOrder::UNORDERED;
+  std::vector<int64_t> null_counts;
+};
+
+// ...and where each page starts. compressed_page_size includes the header.
+struct PageLocation {
+  int64_t offset = 0;
+  int32_t compressed_page_size = 0;
+  int64_t first_row_index = 0;
+};
+
+struct OffsetIndex {
+  std::vector<PageLocation> page_locations;
+};
+
+// Thrift compact serialization of the footer structures (appended to *out).
+void SerializePageHeader(const PageHeader &header, std::vector<uint8_t> *out);
+void SerializeFileMetaData(const FileMetaData &metadata,
+                           std::vector<uint8_t> *out);
+void SerializeColumnIndex(const ColumnIndex &index, std::vector<uint8_t> *out);
+void SerializeOffsetIndex(const OffsetIndex &index, std::vector<uint8_t> *out);
+// Header for a split block, xxHash64, uncompressed Bloom filter bitset.
+void SerializeBloomFilterHeader(int32_t num_bytes, std::vector<uint8_t> *out);
+
+// Parsers for the same structures. Unknown fields are skipped; malformed
+// input throws std::runtime_error. Page and Bloom filter headers precede
+// their data, so those parsers return the header length in bytes.
+size_t ParsePageHeader(const uint8_t *data, size_t size, PageHeader *header);
+FileMetaData ParseFileMetaData(const uint8_t *data, size_t size);
+ColumnIndex ParseColumnIndex(const uint8_t *data, size_t size);
+OffsetIndex ParseOffsetIndex(const uint8_t *data, size_t size);
+size_t ParseBloomFilterHeader(const uint8_t *data, size_t size,
+                              int32_t *num_bytes);
+
+} // namespace hpq
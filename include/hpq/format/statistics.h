@@ -0,0 +1,22 @@
+#pragma once
+
+#include "hpq/schema.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hpq {
+
+// Column statistics use the PLAIN encoding of a single value (BOOLEAN: one
+// byte, 0 or 1), both in Statistics and in the ColumnIndex.
+
+// Min and max of n values of a fixed-width type. Float NaNs are skipped and
+// zero bounds widen to -0.0 / +0.0, as the format asks of writers. Returns
+// false when no value qualifies.
+bool ComputeMinMax(Type type, const void *values, size_t n, std::string *min,
+                   std::string *max);
+
+// Three-way comparison of two encoded values of `type`.
+int CompareValues(Type type, const std::string &a, const std::string &b);
+
+} // namespace hpq
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hpq {
+
+// Thrift compact protocol type ids.
+enum class ThriftType : uint8_t {
+  STOP = 0,
+  BOOL_TRUE = 1,
+  BOOL_FALSE = 2,
+  BYTE = 3,
+  I16 = 4,
+  I32 = 5,
+  I64 = 6,
+  DOUBLE = 7,
+  BINARY = 8,
+  LIST = 9,
+  SET = 10,
+  MAP = 11,
+  STRUCT = 12
+};
+
+// Minimal Thrift compact protocol serializer, enough for the Parquet footer
+// and page headers. Field ids must be written in increasing order within a
+// struct (the compact protocol encodes them as deltas).
+class ThriftCompactWriter {
+public:
+  explicit ThriftCompactWriter(std::vector<uint8_t> *out) : out_(out) {}
+
+  void BeginStruct();
+  void EndStruct(); // Writes the STOP field
+
+  void WriteFieldBool(int16_t id, bool value);
+  void WriteFieldI8(int16_t id, int8_t value);
+  void WriteFieldI16(int16_t id, int16_t value);
+  void WriteFieldI32(int16_t id, int32_t value);
+  void WriteFieldI64(int16_t id, int64_t value);
+  void WriteFieldBinary(int16_t id, const void *data, size_t size);
+  void WriteFieldString(int16_t id, const std::string &value) {
+    WriteFieldBinary(id, value.data(), value.size());
+  }
+  void WriteFieldStructBegin(int16_t id); // Follow with fields + EndStruct()
+  void WriteFieldListBegin(int16_t id, ThriftType elem_type, int32_t size);
+
+  // List element writers (no field header)
+  void WriteBool(bool value);
+  void WriteI32(int32_t value);
+  void WriteI64(int64_t value);
+  void WriteBinary(const void *data, size_t size);
+  void WriteString(const std::string &value) {
+    WriteBinary(value.data(), value.size());
+  }
+  void WriteListBegin(ThriftType elem_type, int32_t size);
+
+private:
+  std::vector<uint8_t> *out_;
+  std::vector<int16_t> last_field_stack_;
+  int16_t last_field_ = 0;
+
+  void WriteFieldHeader(int16_t id, ThriftType type);
+  void WriteVarint(uint64_t value);
+};
+
+// Matching compact protocol reader. Structs are read as a loop over
+// ReadFieldHeader until it returns false; unknown fields go to Skip().
+// Throws std::runtime_error on truncated or malformed input.
+class ThriftCompactReader {
+public:
+  ThriftCompactReader(const uint8_t *data, size_t size)
+      : data_(data), pos_(data), end_(data + size) {}
+
+  void BeginStruct();
+  void EndStruct(); // Call after ReadFieldHeader returned false
+
+  // Returns false at the struct's STOP field.
+  bool ReadFieldHeader(int16_t *id, ThriftType *type);
+  // Bool fields carry their value in the field type.
+  static bool FieldBool(ThriftType type) {
+    return type == ThriftType::BOOL_TRUE;
+  }
+
+  bool ReadBool(); // List elements only
+  int8_t ReadI8();
+  int16_t ReadI16();
+  int32_t ReadI32();
+  int64_t ReadI64();
+  std::string ReadString();
+  void ReadListBegin(ThriftType *elem_type, int32_t *size);
+  void Skip(ThriftType type);
+
+  size_t bytes_read() const { return pos_ - data_; }
+
+private:
+  const uint8_t *data_;
+  const uint8_t *pos_;
+  const uint8_t *end_;
+  std::vector<int16_t> last_field_stack_;
+  int16_t last_field_ = 0;
+
+  uint8_t ReadByte();
+  uint64_t ReadVarint();
+  void SkipDepth(ThriftType type, int depth);
+  void SkipElement(ThriftType type, int depth);
+};
+
+} // namespace hpq
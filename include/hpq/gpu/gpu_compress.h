@@ -2,13 +2,37 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <span>
 #include <vector>
 
 namespace hpq {
 
+struct Page;
+class CodecSelector;
+
 // Compress data using GPU
 // Returns compressed size, or 0 if failed/not supported
 size_t CompressGPU(const uint8_t *input, size_t input_size, uint8_t *output,
                    size_t output_capacity);
 
+// Compresses batches of independent pages: the writer hands over all pages
+// of a row group at once, so per-call setup (threads, device buffers) is
+// paid once per batch. Implementations are thread-safe; one backend can be
+// shared by several writers (WriterOptions::compress_backend).
+class CompressBackend {
+public:
+  virtual ~CompressBackend() = default;
+
+  // Replaces each page's body with its compressed form, in the codec
+  // `codecs` picks for the page's column chunk. Throws the first failure
+  // once the whole batch has been processed.
+  virtual void CompressBatch(std::span<Page> pages, CodecSelector *codecs) = 0;
+};
+
+// CPU backend: a batch is spread over the calling thread plus
+// num_threads - 1 pool workers (num_threads <= 0: one per hardware thread),
+// each compressing into its own reusable scratch buffer.
+std::unique_ptr<CompressBackend> MakeCpuCompressBackend(int num_threads);
+
 } // namespace hpq
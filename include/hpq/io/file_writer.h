@@ -0,0 +1,83 @@
+#pragma once
+
+#include "hpq/io/output_stream.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace hpq {
+
+// Append-only file sink. Tracks the logical write position so the layout code
+// can record page and column chunk offsets without an lseek per page.
+//
+// Modes:
+//  - kWrite: plain write(2) and writev(2) calls.
+//  - kMmap:  the file is preallocated in large extents (fallocate) and mapped;
+//            writes are memcpy into the mapping, with no syscall per write.
+//            That copy replaces the kernel's copy in write(2) rather than
+//            removing it.
+//            The file is truncated to its final length on Close().
+//  - kDirect: O_DIRECT writes from a ring of 4 KiB-aligned, mlocked buffers.
+//            The caller fills one buffer while an I/O thread writes the
+//            previous ones, bypassing the page cache. The tail block is
+//            zero-padded and the file truncated on Close(). Filesystems that
+//            reject O_DIRECT fall back to buffered writes from the same ring.
+class FileWriter : public OutputStream {
+public:
+  enum class Mode { kWrite, kMmap, kDirect };
+
+  static constexpr size_t kDirectAlignment = 4096;
+
+  FileWriter();
+  ~FileWriter() override;
+
+  FileWriter(const FileWriter &) = delete;
+  FileWriter &operator=(const FileWriter &) = delete;
+
+  // `block_size` is the growth step in kMmap mode and the size of each ring
+  // buffer in kDirect mode (rounded up to kDirectAlignment).
+  void Open(const std::string &filename, Mode mode = Mode::kWrite,
+            size_t block_size = 64 << 20);
+  // Opens an existing file to continue writing at `offset` (Tell() starts
+  // there). The bytes after `offset` are discarded.
+  void OpenAt(const std::string &filename, int64_t offset,
+              Mode mode = Mode::kWrite, size_t block_size = 64 << 20);
+  void Write(const void *data, size_t size) override;
+  // One writev(2) per IOV_MAX buffers in kWrite mode; the other modes copy
+  // each buffer into the mapping or the ring, one memcpy per byte.
+  void Writev(const iovec *iov, int count) override;
+  void Close() override;
+
+  int64_t Tell() const override { return position_; }
+  bool is_open() const { return fd_ >= 0; }
+  Mode mode() const { return mode_; }
+  // True while kDirect output actually bypasses the page cache.
+  bool direct() const;
+
+private:
+  int fd_ = -1;
+  int64_t position_ = 0;
+  std::string filename_;
+  Mode mode_ = Mode::kWrite;
+
+  // kMmap state
+  uint8_t *map_ = nullptr;
+  size_t capacity_ = 0;
+  size_t extent_size_ = 0;
+
+  // kDirect state
+  struct DirectRing;
+  std::unique_ptr<DirectRing> ring_;
+
+  void OpenFile(const std::string &filename, Mode mode, size_t block_size,
+                int64_t offset);
+  void WriteAll(const uint8_t *data, size_t size);
+  void WriteRing(const uint8_t *data, size_t size);
+  void OpenDirect(size_t buffer_size, int64_t start);
+  void CloseDirect();
+  void EnsureCapacity(size_t end);
+  [[noreturn]] void Fail(const char *what) const;
+};
+
+} // namespace hpq
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/uio.h>
+#include <vector>
+
+namespace hpq {
+
+// Append-only byte sink the writer emits a Parquet file into. Tell() is the
+// logical write position, used for page and column chunk offsets. Errors
+// throw std::runtime_error.
+//
+// Implementations: FileWriter (a named file, with mmap and O_DIRECT modes),
+// FdOutputStream (any writable descriptor: pipe, socket, open file) and
+// BufferOutputStream (a growable in-memory buffer).
+class OutputStream {
+public:
+  virtual ~OutputStream() = default;
+
+  virtual void Write(const void *data, size_t size) = 0;
+  // Writes `count` buffers back to back. Descriptor sinks issue them as
+  // writev(2) calls, so pieces such as a page header and its body need not
+  // be copied together first. The default writes them one at a time.
+  virtual void Writev(const iovec *iov, int count);
+  virtual int64_t Tell() const = 0;
+  // Flushes what the sink buffers and releases it. Nothing may be written
+  // afterwards; closing twice is a no-op.
+  virtual void Close() = 0;
+};
+
+// Writes every byte of the `count` buffers to `fd`, in as few writev(2)
+// calls as IOV_MAX and short writes allow, retrying EINTR. Returns false
+// with errno set on error.
+bool WritevAll(int fd, const iovec *iov, int count);
+
+// Streams to a descriptor the caller opened. Nothing is seeked, so pipes
+// and sockets work; Tell() counts from 0. A reader that goes away raises
+// SIGPIPE as for any other write to a pipe.
+class FdOutputStream : public OutputStream {
+public:
+  // With `owns_fd`, Close() (or destruction) closes the descriptor.
+  explicit FdOutputStream(int fd, bool owns_fd = false);
+  ~FdOutputStream() override;
+
+  FdOutputStream(const FdOutputStream &) = delete;
+  FdOutputStream &operator=(const FdOutputStream &) = delete;
+
+  void Write(const void *data, size_t size) override;
+  void Writev(const iovec *iov, int count) override;
+  int64_t Tell() const override { return position_; }
+  void Close() override;
+
+private:
+  int fd_;
+  bool owns_fd_;
+  int64_t position_ = 0;
+};
+
+// Builds the file in memory. The bytes stay readable after Close().
+class BufferOutputStream : public OutputStream {
+public:
+  explicit BufferOutputStream(size_t initial_capacity = 0);
+
+  void Write(const void *data, size_t size) override;
+  void Writev(const iovec *iov, int count) override;
+  int64_t Tell() const override {
+    return static_cast<int64_t>(buffer_.size());
+  }
+  void Close() override {}
+
+  const std::vector<uint8_t> &buffer() const { return buffer_; }
+  // Hands the bytes over and leaves the stream empty.
+  std::vector<uint8_t> Release() { return std::move(buffer_); }
+
+private:
+  std::vector<uint8_t> buffer_;
+};
+
+} // namespace hpq
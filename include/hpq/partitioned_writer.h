@@ -0,0 +1,48 @@
+#pragma once
+
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace hpq {
+
+// Hive-style partitioned output. Rows are routed by the value of one INT32 or
+// INT64 column to <base_dir>/<column>=<value>/part-0.parquet; the partition
+// column itself is not stored in the files. The other columns keep their
+// logical types and take the input layouts ParquetWriter::WriteColumn takes.
+//
+// Every partition writer runs in async mode on one shared encode pool
+// (options.encode_pool, or one of options.encode_threads threads) and one
+// shared compress backend (options.compress_backend, or one of
+// options.compress_threads threads).
+// All charge one MemoryBudget: the one in options.memory_budget, or a new
+// one of memory_limit bytes. When the budget nears its limit, the largest
+// partitions end their row group early.
+class PartitionedWriter {
+public:
+  PartitionedWriter(const std::string &base_dir, const Schema &schema,
+                    int partition_column,
+                    const WriterOptions &options = WriterOptions(),
+                    size_t memory_limit = 256 << 20);
+  ~PartitionedWriter();
+
+  PartitionedWriter(const PartitionedWriter &) = delete;
+  PartitionedWriter &operator=(const PartitionedWriter &) = delete;
+
+  // columns[i] points to num_rows values of schema column i.
+  void WriteBatch(const std::vector<const void *> &columns, size_t num_rows);
+
+  void Close();
+
+  size_t num_partitions() const;
+  size_t buffered_bytes() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace hpq
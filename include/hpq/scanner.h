@@ -0,0 +1,119 @@
+#pragma once
+
+#include "hpq/format/parquet_metadata.h"
+#include "hpq/schema.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace hpq {
+
+// Predicate operand: integers (BOOLEAN as 0/1) or floating point. Mixed
+// comparisons are done in double.
+using ScalarValue = std::variant<int64_t, double>;
+
+// A comparison on one column. The predicates of a scan are ANDed.
+struct ColumnPredicate {
+  enum class Op {
+    kEqual,
+    kLess,
+    kLessEqual,
+    kGreater,
+    kGreaterEqual,
+    kBetween,
+    kIn
+  };
+
+  std::string column;
+  Op op = Op::kEqual;
+  std::vector<ScalarValue> values; // kBetween: {lo, hi} inclusive
+
+  static ColumnPredicate Equal(const std::string &column, ScalarValue value);
+  static ColumnPredicate Less(const std::string &column, ScalarValue value);
+  static ColumnPredicate LessEqual(const std::string &column,
+                                   ScalarValue value);
+  static ColumnPredicate Greater(const std::string &column, ScalarValue value);
+  static ColumnPredicate GreaterEqual(const std::string &column,
+                                      ScalarValue value);
+  static ColumnPredicate Between(const std::string &column, ScalarValue lo,
+                                 ScalarValue hi);
+  static ColumnPredicate In(const std::string &column,
+                            std::vector<ScalarValue> values);
+};
+
+struct ScanOptions {
+  std::vector<std::string> columns; // Projection; empty reads every column
+  std::vector<ColumnPredicate> predicates;
+  bool use_statistics = true;    // Skip row groups by chunk min/max
+  bool use_bloom_filters = true; // Skip row groups on kEqual / kIn misses
+  bool use_page_index = true;    // Skip pages by per-page min/max
+  bool verify_checksums = true;  // Check PageHeader.crc where present
+};
+
+// Decoded values of one projected column (BOOLEAN: one byte per value,
+// FIXED_LEN_BYTE_ARRAY: type_length bytes per value, as stored).
+struct ColumnVector {
+  std::string name;
+  Type type = Type::INT32;
+  int64_t length = 0;
+  std::vector<uint8_t> data;
+
+  template <typename T> const T *values() const {
+    return reinterpret_cast<const T *>(data.data());
+  }
+};
+
+// Rows [begin, end) of a row group.
+struct RowRange {
+  int64_t begin = 0;
+  int64_t end = 0;
+};
+
+// The rows of one row group that survived pruning. Pruning is conservative:
+// some returned rows may still fail the predicates.
+struct ScanBatch {
+  int row_group = 0;
+  int64_t first_row = 0;         // File row index of the row group's row 0
+  std::vector<RowRange> ranges;  // Rows returned, in order
+  int64_t num_rows = 0;          // Total length of `ranges`
+  std::vector<ColumnVector> columns; // In projection order
+};
+
+struct ScanStats {
+  int64_t row_groups = 0;
+  int64_t row_groups_skipped_by_statistics = 0;
+  int64_t row_groups_skipped_by_bloom_filter = 0;
+  int64_t row_groups_skipped_by_page_index = 0;
+  int64_t pages = 0;         // Data pages of projected columns, read or not
+  int64_t pages_skipped = 0;
+  int64_t bytes_read = 0;    // Footer, indexes and pages
+};
+
+// Reads a Parquet file with pread: only the footer, the indexes the
+// predicates need and the pages of projected columns that may hold matching
+// rows. Handles flat files with v1 data pages in the encodings and codecs
+// hpq writes; other files throw std::runtime_error.
+class ParquetScanner {
+public:
+  explicit ParquetScanner(const std::string &filename,
+                          const ScanOptions &options = ScanOptions());
+  ~ParquetScanner();
+
+  ParquetScanner(const ParquetScanner &) = delete;
+  ParquetScanner &operator=(const ParquetScanner &) = delete;
+
+  const FileMetaData &metadata() const;
+
+  // Decodes the next row group that may match. Returns false at the end.
+  bool Next(ScanBatch *batch);
+
+  const ScanStats &stats() const;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+} // namespace hpq
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -16,17 +17,63 @@ enum class Type {
   FIXED_LEN_BYTE_ARRAY
 };
 
+enum class TimeUnit { kMillis, kMicros, kNanos };
+
+// Logical type annotation (parquet.thrift LogicalType). It picks the
+// column's physical type and the value layout WriteColumn / WriteRows take:
+//   kDecimal   16-byte little-endian two's complement unscaled values (the
+//              Arrow decimal128 layout), stored in the narrowest type the
+//              precision allows: INT32 up to 9 digits, INT64 up to 18,
+//              else FIXED_LEN_BYTE_ARRAY of just enough bytes (big-endian)
+//   kDate      int32 days since the epoch (INT32)
+//   kTimestamp int64 in `unit` since the epoch (INT64)
+//   kUuid      16 bytes (FIXED_LEN_BYTE_ARRAY(16))
+//   kInt       8- or 16-bit integers, widened to INT32
+struct LogicalType {
+  enum class Kind { kNone, kDecimal, kDate, kTimestamp, kUuid, kInt };
+
+  Kind kind = Kind::kNone;
+  int precision = 0; // kDecimal: 1 to 38 digits
+  int scale = 0;
+  TimeUnit unit = TimeUnit::kMicros; // kTimestamp
+  bool adjusted_to_utc = true;
+  int bit_width = 0; // kInt: 8 or 16
+  bool is_signed = true;
+
+  static LogicalType Decimal(int precision, int scale);
+  static LogicalType Date();
+  static LogicalType Timestamp(TimeUnit unit, bool adjusted_to_utc = true);
+  static LogicalType Uuid();
+  static LogicalType Int(int bit_width, bool is_signed = true);
+
+  bool operator==(const LogicalType &other) const = default;
+};
+
 struct ColumnSchema {
   std::string name;
   Type type;
   bool nullable;
   int type_length = 0; // For FIXED_LEN_BYTE_ARRAY
+  int64_t field_offset = -1; // Byte offset within a row record (WriteRows)
+  LogicalType logical_type{};
 };
 
 class Schema {
 public:
   Schema() = default;
   void AddColumn(const std::string &name, Type type, bool nullable = true);
+  // Physical type and type_length follow from the logical type. Throws
+  // std::invalid_argument for unsupported parameters.
+  void AddColumn(const std::string &name, const LogicalType &logical_type,
+                 bool nullable = true);
+  void AddFixedLenColumn(const std::string &name, int type_length,
+                         bool nullable = true);
+  // Adds a copy of a column of another schema, annotations included.
+  void AddColumn(const ColumnSchema &column);
+
+  // Maps a column to a field of a fixed-layout row struct, e.g.
+  // schema.SetFieldOffset(0, offsetof(Row, id)).
+  void SetFieldOffset(size_t col_idx, size_t offset);
 
   const std::vector<ColumnSchema> &columns() const { return columns_; }
   size_t num_columns() const { return columns_.size(); }
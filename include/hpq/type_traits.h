@@ -0,0 +1,89 @@
+#pragma once
+
+#include "hpq/schema.h"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace hpq {
+
+// Compile-time descriptions of the fixed-width physical types. Encoders are
+// templated on these so their loops are specialized per type; the runtime
+// Type is resolved once, when a column chunk's encoder is created.
+struct BooleanType {
+  using c_type = uint8_t; // One byte per value on input
+  static constexpr Type type = Type::BOOLEAN;
+  static constexpr size_t byte_width = 1;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_floating_point = false;
+};
+
+struct Int32Type {
+  using c_type = int32_t;
+  static constexpr Type type = Type::INT32;
+  static constexpr size_t byte_width = 4;
+  static constexpr bool is_integer = true;
+  static constexpr bool is_floating_point = false;
+};
+
+struct Int64Type {
+  using c_type = int64_t;
+  static constexpr Type type = Type::INT64;
+  static constexpr size_t byte_width = 8;
+  static constexpr bool is_integer = true;
+  static constexpr bool is_floating_point = false;
+};
+
+struct FloatType {
+  using c_type = float;
+  static constexpr Type type = Type::FLOAT;
+  static constexpr size_t byte_width = 4;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_floating_point = true;
+};
+
+struct DoubleType {
+  using c_type = double;
+  static constexpr Type type = Type::DOUBLE;
+  static constexpr size_t byte_width = 8;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_floating_point = true;
+};
+
+// BYTE_ARRAY value: a view of bytes owned by the caller (encoders) or by
+// the page or decoder (decoders).
+struct ByteArray {
+  const uint8_t *ptr = nullptr;
+  uint32_t len = 0;
+};
+
+// Variable width, so not part of VisitFixedWidthType.
+struct ByteArrayType {
+  using c_type = ByteArray;
+  static constexpr Type type = Type::BYTE_ARRAY;
+  static constexpr bool is_integer = false;
+  static constexpr bool is_floating_point = false;
+};
+
+// Calls visitor(DType{}) for the traits matching `type`. Throws for types
+// without a fixed-width specialization.
+template <typename Visitor>
+decltype(auto) VisitFixedWidthType(Type type, Visitor &&visitor) {
+  switch (type) {
+  case Type::BOOLEAN:
+    return visitor(BooleanType{});
+  case Type::INT32:
+    return visitor(Int32Type{});
+  case Type::INT64:
+    return visitor(Int64Type{});
+  case Type::FLOAT:
+    return visitor(FloatType{});
+  case Type::DOUBLE:
+    return visitor(DoubleType{});
+  default:
+    throw std::runtime_error("Unsupported physical type");
+  }
+}
+
+} // namespace hpq
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace hpq {
+
+// Bounded lock-free MPMC ring (Vyukov). TryPush/TryPop never block; Push/Pop
+// park on an atomic counter when the ring is full/empty, which is how the
+// write pipeline applies backpressure to producers.
+template <typename T> class BoundedQueue {
+public:
+  explicit BoundedQueue(size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity)
+      cap <<= 1;
+    mask_ = cap - 1;
+    cells_ = std::make_unique<Cell[]>(cap);
+    for (size_t i = 0; i < cap; ++i)
+      cells_[i].seq.store(i, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+  bool TryPush(T &value) {
+    size_t pos = tail_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      size_t seq = cell.seq.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.seq.store(pos + 1, std::memory_order_release);
+          pushes_.fetch_add(1, std::memory_order_release);
+          pushes_.notify_all();
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // Full
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool TryPop(T &out) {
+    size_t pos = head_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell &cell = cells_[pos & mask_];
+      size_t seq = cell.seq.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          out = std::move(cell.value);
+          cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+          pops_.fetch_add(1, std::memory_order_release);
+          pops_.notify_all();
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // Empty
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Blocks while the queue is full. Returns false if the queue was closed.
+  bool Push(T value) {
+    for (;;) {
+      if (closed_.load(std::memory_order_acquire))
+        return false;
+      uint32_t seen = pops_.load(std::memory_order_acquire);
+      if (TryPush(value))
+        return true;
+      pops_.wait(seen, std::memory_order_acquire);
+    }
+  }
+
+  // Blocks while the queue is empty. Returns false once the queue is closed
+  // and fully drained.
+  bool Pop(T &out) {
+    for (;;) {
+      uint32_t seen = pushes_.load(std::memory_order_acquire);
+      if (TryPop(out))
+        return true;
+      if (closed_.load(std::memory_order_acquire))
+        return TryPop(out);
+      pushes_.wait(seen, std::memory_order_acquire);
+    }
+  }
+
+  // Wakes all blocked producers and consumers. Items already queued can still
+  // be popped.
+  void Close() {
+    closed_.store(true, std::memory_order_release);
+    pushes_.fetch_add(1, std::memory_order_release);
+    pushes_.notify_all();
+    pops_.fetch_add(1, std::memory_order_release);
+    pops_.notify_all();
+  }
+
+  size_t capacity() const { return mask_ + 1; }
+
+private:
+  struct Cell {
+    std::atomic<size_t> seq{0};
+    T value{};
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+  alignas(64) std::atomic<uint32_t> pushes_{0};
+  alignas(64) std::atomic<uint32_t> pops_{0};
+  std::atomic<bool> closed_{false};
+};
+
+} // namespace hpq
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hpq {
+
+// CRC-32 with the gzip/zlib polynomial, as Parquet's PageHeader.crc uses.
+// Pass a previous result as `crc` to continue it over more data. Folds 64
+// bytes per step with PCLMULQDQ where the target has it, slice-by-8 tables
+// otherwise.
+uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc = 0);
+
+} // namespace hpq
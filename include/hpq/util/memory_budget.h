@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace hpq {
+
+class MemoryConsumer;
+
+// Byte budget shared by any number of writers. Consumers reserve as their
+// buffers grow and release once the data has been written. When usage
+// crosses flush_threshold * limit, the largest consumer is asked to flush
+// (end its row group early); it does so on its own thread at the next
+// opportunity, so the budget never calls into another writer concurrently.
+//
+// The limit is a soft one: reservations always succeed.
+class MemoryBudget {
+public:
+  explicit MemoryBudget(size_t limit, double flush_threshold = 0.9);
+
+  MemoryBudget(const MemoryBudget &) = delete;
+  MemoryBudget &operator=(const MemoryBudget &) = delete;
+
+  size_t limit() const { return limit_; }
+  size_t used() const { return used_.load(std::memory_order_relaxed); }
+  // Usage above which the largest consumer is asked to flush
+  size_t flush_at() const { return flush_at_; }
+  bool over_threshold() const { return used() > flush_at_; }
+
+private:
+  friend class MemoryConsumer;
+
+  size_t limit_;
+  size_t flush_at_;
+  std::atomic<size_t> used_{0};
+  std::mutex mutex_;
+  std::vector<MemoryConsumer *> consumers_;
+
+  void Register(MemoryConsumer *consumer);
+  void Unregister(MemoryConsumer *consumer);
+  void RequestFlush();
+};
+
+// One writer's account. Works without a budget too, as a plain counter.
+// Reserve/Release may be called from any thread.
+class MemoryConsumer {
+public:
+  explicit MemoryConsumer(MemoryBudget *budget = nullptr);
+  ~MemoryConsumer();
+
+  MemoryConsumer(const MemoryConsumer &) = delete;
+  MemoryConsumer &operator=(const MemoryConsumer &) = delete;
+
+  void Reserve(size_t bytes);
+  void Release(size_t bytes);
+  size_t reserved() const { return reserved_.load(std::memory_order_relaxed); }
+
+  // True once if the budget asked this consumer to flush since the last call.
+  bool TakeFlushRequest() {
+    return flush_requested_.exchange(false, std::memory_order_acq_rel);
+  }
+
+private:
+  friend class MemoryBudget;
+
+  MemoryBudget *budget_;
+  std::atomic<size_t> reserved_{0};
+  std::atomic<bool> flush_requested_{false};
+};
+
+// Keeps a consumer charged with a measured footprint, such as an encoder's
+// long-lived tables: Set() reserves or releases the difference from the
+// last value, and destruction releases the rest. A null consumer charges
+// nothing.
+class MemoryCharge {
+public:
+  explicit MemoryCharge(MemoryConsumer *consumer = nullptr)
+      : consumer_(consumer) {}
+  ~MemoryCharge() { Set(0); }
+
+  MemoryCharge(const MemoryCharge &) = delete;
+  MemoryCharge &operator=(const MemoryCharge &) = delete;
+
+  void Set(size_t bytes);
+  size_t bytes() const { return bytes_; }
+
+private:
+  MemoryConsumer *consumer_;
+  size_t bytes_ = 0;
+};
+
+} // namespace hpq
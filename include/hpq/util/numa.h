@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace hpq {
+
+// NUMA layout of the machine, read once from sysfs. Off Linux, or where
+// sysfs is not readable, the machine is a single node 0 holding every CPU.
+struct NumaTopology {
+  std::vector<int> nodes;             // Ids of the nodes that have CPUs
+  std::vector<std::vector<int>> cpus; // CPUs of each entry of nodes
+
+  static const NumaTopology &Get();
+
+  // Position of `node` in nodes, or -1.
+  int IndexOf(int node) const;
+};
+
+// Node of the CPU the calling thread is running on (0 if unknown).
+int CurrentNumaNode();
+
+// Restrict the calling thread to the CPUs of `node`, or to a single CPU.
+// Return false if the kernel refused (e.g. the CPUs are outside the
+// process's cpuset); the thread then keeps its previous affinity.
+bool PinThreadToNode(int node);
+bool PinThreadToCpu(int cpu);
+
+// Prefer `node` for the whole pages inside [data, data + size). Pages not
+// yet touched are allocated there; pages already backed elsewhere are
+// migrated. Only a preference: allocation falls back to other nodes when
+// the node is short of memory.
+void BindToNumaNode(void *data, size_t size, int node);
+
+// Ask for transparent huge pages over the whole pages inside
+// [data, data + size). Takes effect when THP is in "madvise" or "always"
+// mode.
+void AdviseHugePages(void *data, size_t size);
+
+// Node holding the page at `data`, or -1 if unknown.
+int NumaNodeOfAddress(const void *data);
+
+} // namespace hpq
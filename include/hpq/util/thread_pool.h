@@ -0,0 +1,32 @@
+#pragma once
+
+#include "hpq/util/bounded_queue.h"
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace hpq {
+
+// Fixed set of worker threads draining a bounded task queue. Shared by
+// several writers (see WriterOptions::encode_pool) so the number of encode
+// threads does not grow with the number of open files.
+class ThreadPool {
+public:
+  explicit ThreadPool(int num_threads, size_t queue_depth = 256);
+  // Runs every task already submitted, then joins the workers.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Blocks while the queue is full. Tasks must not throw.
+  void Submit(std::function<void()> task);
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+private:
+  BoundedQueue<std::function<void()>> queue_;
+  std::vector<std::thread> threads_;
+};
+
+} // namespace hpq
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace hpq {
+
+// One completed span. `name` must be a string literal (it is stored, not
+// copied); ids that do not apply are -1.
+struct TraceEvent {
+  const char *name = nullptr;
+  int64_t start_ns = 0; // steady_clock
+  int64_t duration_ns = 0;
+  int32_t column = -1;
+  int32_t page = -1; // Ordinal within the column chunk
+  int64_t row_group = -1;
+};
+
+// What one thread recorded, oldest span first.
+struct TraceThread {
+  int tid = 0;
+  std::string name; // Empty unless the thread named itself
+  std::vector<TraceEvent> events;
+  uint64_t dropped = 0; // Overwritten once the ring was full
+};
+
+// Process-wide span recorder for the write path, exported as Chrome
+// trace-event JSON (opens in ui.perfetto.dev and chrome://tracing).
+//
+// Each thread records into its own ring buffer, so spans from encoder,
+// compressor and writer threads never contend; when a ring is full the
+// oldest spans are overwritten. Rings outlive their threads until the next
+// Start(), so pipeline threads that have exited still show up in the dump.
+//
+// The library's own spans are HPQ_TRACE_SPAN sites, which compile to
+// nothing unless it is built with HPQ_ENABLE_TRACING (the CMake option of
+// that name). Compiled in, a span costs one relaxed load while tracing is
+// stopped and two clock reads plus a ring slot while it runs.
+class Tracer {
+public:
+  // Discards what was recorded and starts recording, keeping at most
+  // `events_per_thread` spans per thread.
+  static void Start(size_t events_per_thread = 1 << 16);
+  static void Stop();
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  static void Record(const TraceEvent &event);
+  // Labels the calling thread in the dump.
+  static void SetThreadName(const std::string &name);
+
+  // Copies out the rings, one entry per thread that recorded anything.
+  // Safe while tracing runs.
+  static std::vector<TraceThread> Snapshot();
+  // Writes Snapshot() as a JSON object with a "traceEvents" array of
+  // complete ("X") events and thread name metadata. Throws
+  // std::runtime_error if the file cannot be written.
+  static void WriteChromeTrace(std::ostream &out);
+  static void WriteChromeTrace(const std::string &path);
+
+  static int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+private:
+  static inline std::atomic<bool> enabled_{false};
+};
+
+// Records the lifetime of the scope as a span, if tracing is running when
+// it opens.
+class TraceSpan {
+public:
+  explicit TraceSpan(const char *name, int column = -1,
+                     int64_t row_group = -1, int page = -1) {
+    if (!Tracer::enabled())
+      return;
+    event_.name = name;
+    event_.column = column;
+    event_.row_group = row_group;
+    event_.page = page;
+    event_.start_ns = Tracer::Now();
+  }
+  ~TraceSpan() {
+    if (!event_.name)
+      return;
+    event_.duration_ns = Tracer::Now() - event_.start_ns;
+    Tracer::Record(event_);
+  }
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+  TraceEvent event_;
+};
+
+} // namespace hpq
+
+// HPQ_TRACE_SPAN(name, [column, [row_group, [page]]]) opens a TraceSpan
+// until the end of the enclosing scope; HPQ_TRACE_THREAD(name) names the
+// calling thread. Without HPQ_ENABLE_TRACING neither evaluates its
+// arguments.
+#if defined(HPQ_ENABLE_TRACING)
+#define HPQ_TRACE_CONCAT_(a, b) a##b
+#define HPQ_TRACE_CONCAT(a, b) HPQ_TRACE_CONCAT_(a, b)
+#define HPQ_TRACE_SPAN(...)                                                  \
+  ::hpq::TraceSpan HPQ_TRACE_CONCAT(hpq_trace_span_, __LINE__)(__VA_ARGS__)
+#define HPQ_TRACE_THREAD(name) ::hpq::Tracer::SetThreadName(name)
+#else
+#define HPQ_TRACE_SPAN(...) static_cast<void>(0)
+#define HPQ_TRACE_THREAD(name) static_cast<void>(0)
+#endif
@@ -2,23 +2,176 @@
 
 #include "hpq/schema.h"
 #include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace hpq {
 
+class CompressBackend;
+class MemoryBudget;
+class OutputStream;
+class ThreadPool;
+
+// What compression = "AUTO" optimizes for when choosing a chunk's codec.
+enum class CompressionTarget {
+  kSpeed,    // SNAPPY
+  kBalanced, // GZIP only where it clearly beats SNAPPY on the sample
+  kRatio     // GZIP when available
+};
+
+// How WriterOptions::pin_threads restricts pipeline threads.
+enum class ThreadPinning {
+  kNone,
+  kNode, // To the CPUs of the thread's NUMA node
+  kCore  // To one CPU of that node each
+};
+
 struct WriterOptions {
   size_t row_group_size = 64 * 1024;
+  size_t data_page_size = 1024 * 1024; // Raw value bytes per data page
   bool use_dictionary = true;
   bool use_gpu_compression = false;
-  std::string compression = "SNAPPY"; // SNAPPY, GZIP, ZSTD, NONE
+  std::string compression = "SNAPPY"; // SNAPPY, GZIP, ZSTD, NONE, AUTO
+
+  // Compressibility is estimated per page by trial-compressing a small
+  // sample. A column chunk whose first page would shrink by less than
+  // min_compression_gain is written UNCOMPRESSED; later pages under the
+  // threshold are stored in the codec's uncompressed framing. Codecs not
+  // built in (ZSTD, or GZIP without zlib) leave chunks UNCOMPRESSED.
+  double min_compression_gain = 0.1;
+  CompressionTarget compression_target = CompressionTarget::kBalanced;
+
+  // Remember each column's adaptive encoding choice across pages and row
+  // groups. Later pages check it against a small sample of their values
+  // and only rerun the full analysis when the sample shows drift.
+  bool reuse_encoding_decisions = true;
+
+  // Pages are compressed one row group at a time, as a batch spread over
+  // compress_threads threads (<= 0: one per hardware thread), the writing
+  // thread included. A compress_backend shared by several writers replaces
+  // their private threads.
+  int compress_threads = 1;
+  std::shared_ptr<CompressBackend> compress_backend;
+
+  // Cluster each row group by these columns (most significant first,
+  // ascending) before encoding, and record them as the row groups'
+  // sorting_columns. Rows are buffered until every column has a full row
+  // group, so columns written one after the other are held in memory.
+  // Keys must be fixed-width columns.
+  std::vector<std::string> sort_by;
+
+  // Column chunk statistics are always written. The page index (per-page
+  // bounds and offsets) lets readers skip pages; Bloom filters let them
+  // skip row groups on equality lookups for the named columns.
+  bool write_page_index = true;
+  std::vector<std::string> bloom_filter_columns;
+  double bloom_filter_fpp = 0.01;
+
+  // Store a CRC-32 of each data page (as written: compressed, after the
+  // header) in PageHeader.crc. Computed on the compress stage as each page
+  // is finished; ParquetScanner checks it by default.
+  bool page_checksums = false;
+
+  // Add row groups to an existing file written by this library instead of
+  // replacing it. The schema passed to Init() must match the file's. New
+  // row groups go where the old footer was, then a merged footer is
+  // written; existing pages are never read. Until Close() completes the
+  // file has no valid footer. A missing file is created as usual.
+  bool append = false;
+
+  // Write through a shared file mapping that is preallocated in
+  // mmap_extent_size steps and truncated to the final length on close.
+  // Pages are compressed into their own buffers and then copied into the
+  // mapping, so this costs the same one copy per byte as write(2). What it
+  // changes is block allocation (large fallocate extents) and the absence
+  // of a syscall per column chunk, not the amount of copying.
+  bool use_mmap = false;
+  size_t mmap_extent_size = 64 << 20;
+
+  // Write with O_DIRECT from a ring of aligned buffers so bulk output does
+  // not evict other data from the page cache. Takes precedence over use_mmap.
+  bool use_direct_io = false;
+  size_t direct_buffer_size = 4 << 20;
+
+  // Async mode: WriteColumn copies values into page buffers and returns;
+  // encode, compress and I/O run on background stages. WriteColumn only
+  // blocks when pipeline_queue_depth pages are already waiting to be encoded.
+  bool async = false;
+  size_t pipeline_queue_depth = 64;
+  int encode_threads = 1;
+  // Async mode only: encode on this pool instead of encode_threads private
+  // threads. One pool can serve many writers.
+  std::shared_ptr<ThreadPool> encode_pool;
+
+  // Let different threads call WriteColumn on different columns at the
+  // same time (one thread per column at a time). Appends take no lock: each
+  // column stages, cuts and, without async, encodes its own pages. A
+  // finished column chunk meets the others at its row group's barrier, and
+  // the last column to arrive hands the row group to compression and I/O;
+  // no thread ever waits there. Not combinable with sort_by, and
+  // memory_budget flush requests are not honoured early. WriteRows,
+  // FlushRowGroup and Close must not overlap WriteColumn calls.
+  bool concurrent_columns = false;
+
+  // NUMA placement (Linux). With numa_aware, each column's page buffers are
+  // bound to a home node (columns round-robin over the nodes) before they
+  // are first touched, so the writing thread's node no longer decides where
+  // they live; async encode threads are spread over the nodes and each
+  // encodes the pages of its own node (not with encode_pool). pin_threads
+  // keeps encode threads on their node, and the compress and write stages
+  // on the node of the thread that called Init(). use_huge_pages asks for
+  // transparent huge pages on page buffers of huge_page_threshold bytes or
+  // more. Locality is reported in WriterStats.
+  bool numa_aware = false;
+  ThreadPinning pin_threads = ThreadPinning::kNone;
+  bool use_huge_pages = false;
+  size_t huge_page_threshold = 2 << 20;
+
+  // Optional budget shared across writers. Staged pages are charged until
+  // they are written; near the limit the largest writer ends its row group
+  // early.
+  std::shared_ptr<MemoryBudget> memory_budget;
+};
+
+// Busy time per write stage, summed over the threads running it. With
+// async encoding on several threads encode_seconds can exceed wall time.
+struct WriterStats {
+  int64_t pages = 0;
+  int64_t pages_compressed = 0; // The rest were not worth compressing
+  double encode_seconds = 0;   // Adaptive analysis, encoding, statistics
+  double compress_seconds = 0;
+  double write_seconds = 0;    // Row group assembly, file I/O and footer
+
+  // numa_aware only: pages encoded on the node holding their raw values,
+  // and pages encoded across nodes.
+  int64_t pages_numa_local = 0;
+  int64_t pages_numa_remote = 0;
+  int threads_pinned = 0; // Pipeline threads pinned by pin_threads
+
+  // reuse_encoding_decisions: pages that ran the full adaptive analysis,
+  // and pages that reused their column's earlier decision.
+  int64_t encoding_analyses = 0;
+  int64_t encoding_decisions_reused = 0;
 };
 
 class ParquetWriter {
 public:
+  // Completion callback for CloseAsync; receives the first write error, or
+  // nullptr on success.
+  using CloseCallback = std::function<void(std::exception_ptr)>;
+
   explicit ParquetWriter(const std::string &filename,
                          const WriterOptions &options = WriterOptions());
+  // Writes into `out` instead of a named file, e.g. a BufferOutputStream
+  // or an FdOutputStream over a pipe; Close() ends with out->Close().
+  // Throws std::invalid_argument if append, use_mmap or use_direct_io is
+  // set, as those need a named file.
+  explicit ParquetWriter(std::shared_ptr<OutputStream> out,
+                         const WriterOptions &options = WriterOptions());
   ~ParquetWriter();
 
   // Disable copy
@@ -31,8 +184,29 @@ public:
   // Write a column chunk
   void WriteColumn(int col_idx, const void *values, int num_values);
 
+  // Write fixed-layout row records (array of structs). Every column needs a
+  // field offset (Schema::SetFieldOffset); fields are transposed directly
+  // into the column page buffers.
+  void WriteRows(const void *rows, size_t stride, size_t num_rows);
+
+  // Ends the current row group before row_group_size is reached. Every
+  // column must have been written up to the same row.
+  void FlushRowGroup();
+
+  // Column data held in memory: staged page buffers plus pages that have
+  // been cut but not yet written out, counted at their raw size. This is
+  // what the writer charges to WriterOptions::memory_budget.
+  size_t buffered_bytes() const;
+
+  // Stage timings so far. Complete once Close() has returned.
+  WriterStats stats() const;
+
   void Close();
 
+  // Starts closing the file and returns without waiting for the pipeline to
+  // drain. In synchronous mode the work is done before returning.
+  std::future<void> CloseAsync(CloseCallback on_complete = nullptr);
+
 private:
   class Impl;
   std::unique_ptr<Impl> impl_;
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "hpq/format/parquet_metadata.h"
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace hpq {
+
+struct WriterOptions;
+struct Page;
+
+// Per-page compression policy. Parquet has one codec per column chunk, so
+// the codec is chosen from the chunk's first page (ordinal 0); every page
+// then either compresses with it or, when its sample shows too little
+// gain, is stored in the codec's uncompressed framing. A chunk's entry is
+// dropped once its last page has been selected. Thread-safe.
+class CodecSelector {
+public:
+  explicit CodecSelector(const WriterOptions &options);
+
+  // Decides the codec of every chunk whose first page is in `pages`. Call
+  // before the pages are compressed in parallel, so the choice does not
+  // depend on which page a worker happens to reach first.
+  void ChooseChunkCodecs(std::span<const Page> pages);
+
+  // Codec of the page's column chunk; UNCOMPRESSED means write the body as
+  // is. *store is set when this page should use the stored framing. A
+  // chunk not seen by ChooseChunkCodecs is decided from this page.
+  Codec Select(const Page &page, bool *store);
+
+  int64_t pages_compressed() const { return pages_compressed_.load(); }
+  // Chunks with pages still to be selected
+  size_t open_chunks();
+
+private:
+  std::vector<Codec> candidates_; // Empty: never compress
+  double max_ratio_;              // 1 - min_compression_gain
+
+  struct ChunkCodec {
+    Codec codec = Codec::UNCOMPRESSED;
+    double first_ratio = -1; // Sample ratio of page 0, when it decided
+    int selected = 0;        // Pages of the chunk selected so far
+    int expected = -1;       // Known once the last page is selected
+  };
+
+  std::mutex mutex_;
+  std::map<std::pair<int64_t, int>, ChunkCodec> chunks_; // (row group, col)
+  std::atomic<int64_t> pages_compressed_{0};
+
+  Codec ChooseChunkCodec(const std::vector<uint8_t> &body, double *ratio);
+};
+
+} // namespace hpq
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "hpq/gpu/gpu_compress.h"
+#include "hpq/writer/codec_selector.h"
+#include "hpq/writer/page.h"
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace hpq {
+
+struct WriterOptions;
+
+// Compress stage of both write paths. Encoded pages are held until their
+// row group is complete, then compressed as one batch on the backend
+// (WriterOptions::compress_backend, or a private CPU backend with
+// compress_threads threads). The assembler parks whole row groups anyway,
+// so holding pages here adds little memory. With use_gpu_compression the
+// pages go through CompressPageGPU one at a time instead.
+class CompressStage {
+public:
+  CompressStage(size_t num_columns, const WriterOptions &options,
+                CodecSelector *codecs);
+
+  // Takes an encoded page. When it completes its row group, that row
+  // group's pages are compressed and appended to *ready.
+  void Add(Page page, std::vector<Page> *ready);
+
+  // Compresses the pages of row groups that never completed.
+  void Flush(std::vector<Page> *ready);
+
+private:
+  struct RowGroupPages {
+    std::vector<Page> pages;
+    std::vector<int> received; // Per column
+    std::vector<int> expected; // Per column, known once the last page arrives
+    size_t complete_chunks = 0;
+  };
+
+  size_t num_columns_;
+  const WriterOptions &options_;
+  CodecSelector *codecs_;
+  std::shared_ptr<CompressBackend> backend_;
+  std::map<int64_t, RowGroupPages> pending_;
+
+  void Compress(std::vector<Page> &pages, std::vector<Page> *ready);
+};
+
+} // namespace hpq
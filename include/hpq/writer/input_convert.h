@@ -0,0 +1,29 @@
+#pragma once
+
+#include "hpq/schema.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace hpq {
+
+// How a column's input values (WriteColumn / WriteRows) become its stored
+// physical values, for logical types whose input layout differs (see
+// LogicalType). Other columns are copied as is.
+struct InputConverter {
+  size_t input_width = 0; // Bytes per input value
+
+  // Throws std::runtime_error if any of `count` input values, `stride`
+  // bytes apart, does not fit the column. Run on a whole batch before any
+  // of it is staged. nullptr: every input value fits.
+  void (*check)(const ColumnSchema &column, const uint8_t *src,
+                size_t stride, int64_t count) = nullptr;
+
+  // Converts `count` checked input values, `stride` bytes apart, to stored
+  // values back to back at dst. nullptr: stored as is.
+  void (*convert)(const uint8_t *src, size_t stride, int64_t count,
+                  int type_length, uint8_t *dst) = nullptr;
+};
+
+InputConverter ResolveInputConverter(const ColumnSchema &column);
+
+} // namespace hpq
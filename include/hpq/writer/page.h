@@ -0,0 +1,69 @@
+#pragma once
+
+#include "hpq/encodings/encoding_base.h"
+#include "hpq/format/parquet_metadata.h"
+#include "hpq/schema.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace hpq {
+
+struct WriterOptions;
+struct Page;
+class AdaptiveDecisionCache;
+class CodecSelector;
+
+// Type-specialized encode stage, resolved once per column (see
+// ResolvePageEncoder) and carried by each page through the pipeline.
+using PageEncodeFn = void (*)(const ColumnSchema &column,
+                              const WriterOptions &options, Page *page);
+
+// A data page as it moves through the write stages:
+// producer (raw values) -> encode -> compress -> row group assembly.
+struct Page {
+  int column = 0;
+  int64_t row_group = 0;
+  int ordinal = 0; // Position within the column chunk
+  bool last_in_chunk = false;
+  int32_t num_values = 0;
+  PageEncodeFn encode = nullptr;
+  int numa_node = -1; // numa_aware: home node of the values buffer
+  AdaptiveDecisionCache *adaptive = nullptr; // The column's, if any
+
+  std::vector<uint8_t> values; // Raw values, released after encoding
+  size_t raw_bytes = 0;        // Bytes charged to the writer's MemoryConsumer
+  std::vector<uint8_t> body;   // Levels + encoded values, maybe compressed
+
+  Encoding encoding = Encoding::PLAIN;
+  Codec codec = Codec::UNCOMPRESSED;
+  int32_t uncompressed_size = 0;
+  std::optional<int32_t> crc; // page_checksums: CRC-32 of the final body
+
+  // Filled by the encode stage from the raw values
+  bool has_stats = false;
+  std::string min_value; // PLAIN-encoded bounds for the page index
+  std::string max_value;
+  bool bloom = false;                 // Column has a Bloom filter
+  std::vector<uint64_t> bloom_hashes; // Distinct value hashes, sorted
+};
+
+// Encode stage for a column's physical type: runs the typed adaptive
+// encoder (PLAIN for FIXED_LEN_BYTE_ARRAY) over page->values and fills
+// page->body (with definition levels for OPTIONAL columns), the page
+// statistics and, when page->bloom is set, the Bloom filter hashes. Throws
+// for unsupported types.
+PageEncodeFn ResolvePageEncoder(const ColumnSchema &column);
+
+// CPU compression of one page: replaces page->body with its compressed form
+// in the codec `codecs` picks for the page's column chunk. `scratch` is
+// reused across calls on the same thread.
+void CompressPage(CodecSelector *codecs, Page *page,
+                  std::vector<uint8_t> *scratch);
+
+// Single-buffer GPU path (WriterOptions::use_gpu_compression). Keeps the raw
+// page when the device produces no output.
+void CompressPageGPU(const WriterOptions &options, Page *page);
+
+} // namespace hpq
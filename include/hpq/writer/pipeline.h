@@ -0,0 +1,91 @@
+#pragma once
+
+#include "hpq/schema.h"
+#include "hpq/util/bounded_queue.h"
+#include "hpq/util/thread_pool.h"
+#include "hpq/writer.h"
+#include "hpq/writer/compress_stage.h"
+#include "hpq/writer/page.h"
+#include "hpq/writer/row_group_assembler.h"
+#include "hpq/writer/stage_timers.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hpq {
+
+// Asynchronous write path: encode -> compress -> write stages connected by
+// bounded MPMC queues. Submit() blocks only when the encode queue is full.
+// With WriterOptions::encode_pool set, pages are encoded as tasks on that
+// shared pool instead of on threads owned by this pipeline. With numa_aware
+// there is one encode queue per NUMA node, and pages go to the queue of the
+// node holding their values.
+class WritePipeline {
+public:
+  // Called on the write stage thread once every page has been written (or the
+  // pipeline failed). A non-null exception_ptr reports the first stage error.
+  using DrainedCallback = std::function<void(std::exception_ptr)>;
+
+  // Stage busy times are accumulated into `timers`; `compress` batches
+  // pages by row group for compression.
+  WritePipeline(const Schema &schema, const WriterOptions &options,
+                RowGroupAssembler *assembler, StageTimers *timers,
+                CompressStage *compress);
+  ~WritePipeline();
+
+  WritePipeline(const WritePipeline &) = delete;
+  WritePipeline &operator=(const WritePipeline &) = delete;
+
+  // Rethrows the first stage error, if any.
+  void Submit(Page page);
+
+  // No more pages will be submitted. Returns immediately.
+  void Finish(DrainedCallback on_drained);
+
+  // Waits for all stage threads to exit.
+  void Join();
+
+private:
+  const Schema &schema_;
+  const WriterOptions &options_;
+  RowGroupAssembler *assembler_;
+  StageTimers *timers_;
+  CompressStage *compress_;
+
+  std::vector<std::unique_ptr<BoundedQueue<Page>>> encode_queues_;
+  BoundedQueue<Page> compress_queue_;
+  BoundedQueue<Page> write_queue_;
+
+  std::vector<std::thread> encode_threads_;
+  std::thread compress_thread_;
+  std::thread write_thread_;
+  std::atomic<int> encoders_running_{0};
+
+  // Shared-pool mode: pages submitted but not yet encoded, plus one for the
+  // producer until Finish(). Whoever drops it to zero closes compress_queue_.
+  ThreadPool *pool_ = nullptr;
+  std::mutex pending_mutex_;
+  std::condition_variable pending_done_;
+  int64_t pending_ = 1;
+  bool finished_ = false;
+
+  DrainedCallback on_drained_;
+  std::atomic<bool> failed_{false};
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+
+  void PinToNode(int node);
+  void EncodeLoop(int worker);
+  void EncodePage(Page &page);
+  void ReleasePending();
+  void CompressLoop();
+  void WriteLoop();
+  void Fail(std::exception_ptr error);
+};
+
+} // namespace hpq
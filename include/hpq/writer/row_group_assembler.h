@@ -0,0 +1,72 @@
+#pragma once
+
+#include "hpq/format/parquet_metadata.h"
+#include "hpq/io/output_stream.h"
+#include "hpq/schema.h"
+#include "hpq/util/memory_budget.h"
+#include "hpq/writer/page.h"
+#include <map>
+#include <vector>
+
+namespace hpq {
+
+struct WriterOptions;
+
+// Final write stage. Pages may arrive in any order (columns are written
+// independently and encode workers run in parallel), but Parquet requires
+// each column chunk to be contiguous. The assembler parks pages until a row
+// group is complete, then writes it column by column, followed by the row
+// group's Bloom filters.
+class RowGroupAssembler {
+public:
+  // Page::raw_bytes is released from `memory` once a row group is written.
+  RowGroupAssembler(const Schema &schema, const WriterOptions &options,
+                    OutputStream *out, MemoryConsumer *memory = nullptr);
+
+  // Append mode: the row groups of `existing` come first in the footer.
+  // Must be called before the first page arrives.
+  void ContinueFrom(const FileMetaData &existing);
+
+  // Recorded as RowGroup.sorting_columns in the row groups written.
+  void SetSortingColumns(std::vector<SortingColumn> columns) {
+    sorting_columns_ = std::move(columns);
+  }
+
+  void AddPage(Page page);
+
+  // All row groups must be complete. Writes the page index and returns the
+  // footer metadata.
+  FileMetaData Finish();
+
+private:
+  struct ChunkPages {
+    std::vector<Page> pages;
+    int expected = -1; // Known once the last page arrives
+  };
+
+  // Page index of one column chunk, written at Finish()
+  struct ChunkIndex {
+    ColumnIndex column_index;
+    OffsetIndex offset_index;
+    bool has_column_index = true; // False if a page has no min/max
+  };
+
+  const Schema &schema_;
+  const WriterOptions &options_;
+  OutputStream *out_;
+  std::map<int64_t, std::vector<ChunkPages>> pending_;
+  int64_t next_row_group_ = 0;
+  FileMetaData metadata_;
+  MemoryConsumer *memory_;
+  std::vector<std::vector<ChunkIndex>> page_index_; // [row group][column]
+  size_t first_new_row_group_ = 0; // Row groups before it came from the file
+  std::vector<SortingColumn> sorting_columns_;
+
+  bool IsComplete(const std::vector<ChunkPages> &chunks) const;
+  void WriteRowGroup(std::vector<ChunkPages> &chunks);
+  void WriteBloomFilter(std::vector<ChunkPages> &chunks, size_t column,
+                        ColumnChunkMetaData *meta);
+  void WritePageIndex();
+};
+
+} // namespace hpq
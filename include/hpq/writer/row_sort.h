@@ -0,0 +1,25 @@
+#pragma once
+
+#include "hpq/schema.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hpq {
+
+// One key of a row group sort: num_rows values of a fixed-width type.
+struct SortKey {
+  Type type;
+  const uint8_t *values;
+};
+
+// Stable permutation ordering rows ascending by keys[0], then keys[1], and
+// so on. LSD radix sort, one byte per pass, least significant key first.
+// Keys are mapped to order-preserving unsigned integers (signed integers by
+// flipping the sign bit; floats so that -0.0 < +0.0 and NaNs go last), and
+// byte positions on which all rows agree cost no pass. num_rows must be
+// below 2^31.
+std::vector<uint32_t> SortPermutation(const std::vector<SortKey> &keys,
+                                      size_t num_rows);
+
+} // namespace hpq
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "hpq/util/numa.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace hpq {
+
+// Busy time per write stage, summed over every thread running the stage,
+// plus the page and NUMA locality counters behind WriterStats.
+struct StageTimers {
+  std::atomic<int64_t> pages{0};
+  std::atomic<int64_t> encode_ns{0};
+  std::atomic<int64_t> compress_ns{0};
+  std::atomic<int64_t> write_ns{0};
+  std::atomic<int64_t> numa_local_pages{0};
+  std::atomic<int64_t> numa_remote_pages{0};
+  std::atomic<int> threads_pinned{0};
+};
+
+// numa_aware: counts a page whose raw values start at `values` as encoded
+// on or off their node, unless the kernel does not say where they are.
+// Call from the thread about to encode it.
+inline void RecordNumaLocality(const void *values, StageTimers *timers) {
+  const int node = NumaNodeOfAddress(values);
+  if (node < 0)
+    return; // Placement unknown
+  auto &counter = node == CurrentNumaNode()
+                      ? timers->numa_local_pages
+                      : timers->numa_remote_pages;
+  counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Adds the lifetime of the scope to `counter`.
+class ScopedStageTimer {
+public:
+  explicit ScopedStageTimer(std::atomic<int64_t> *counter)
+      : counter_(counter), start_(std::chrono::steady_clock::now()) {}
+  ~ScopedStageTimer() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    counter_->fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+  }
+
+  ScopedStageTimer(const ScopedStageTimer &) = delete;
+  ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+private:
+  std::atomic<int64_t> *counter_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace hpq
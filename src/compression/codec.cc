@@ -0,0 +1,180 @@
+#include "hpq/compression/codec.h"
+#include "hpq/compression/snappy.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#ifdef HPQ_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace hpq {
+
+namespace {
+
+constexpr int kSampleSlices = 4;
+// Above this many bits per byte a sample is treated as random: byte-level
+// LZ codecs cannot gain enough to pay for themselves.
+constexpr double kIncompressibleEntropy = 7.9;
+
+[[noreturn]] void Unavailable(Codec codec) {
+  throw std::runtime_error("Compression codec " +
+                           std::to_string(static_cast<int>(codec)) +
+                           " is not available in this build");
+}
+
+#ifdef HPQ_HAVE_ZLIB
+// Parquet's GZIP is the gzip container (RFC 1952), hence windowBits 15 + 16.
+constexpr int kGzipWindowBits = 15 + 16;
+
+size_t GzipCompress(const uint8_t *input, size_t size, uint8_t *out,
+                    size_t capacity, int level) {
+  z_stream z{};
+  if (deflateInit2(&z, level, Z_DEFLATED, kGzipWindowBits, 8,
+                   Z_DEFAULT_STRATEGY) != Z_OK)
+    throw std::runtime_error("deflateInit2 failed");
+  z.next_in = const_cast<Bytef *>(input);
+  z.avail_in = static_cast<uInt>(size);
+  z.next_out = out;
+  z.avail_out = static_cast<uInt>(capacity);
+  int rc = deflate(&z, Z_FINISH);
+  size_t written = z.total_out;
+  deflateEnd(&z);
+  if (rc != Z_STREAM_END)
+    throw std::runtime_error("GZIP compression failed");
+  return written;
+}
+
+void GzipDecompress(const uint8_t *input, size_t size, uint8_t *out,
+                    size_t out_size) {
+  z_stream z{};
+  if (inflateInit2(&z, kGzipWindowBits) != Z_OK)
+    throw std::runtime_error("inflateInit2 failed");
+  uint8_t empty; // inflate() rejects a null output pointer
+  z.next_in = const_cast<Bytef *>(input);
+  z.avail_in = static_cast<uInt>(size);
+  z.next_out = out_size > 0 ? out : &empty;
+  z.avail_out = static_cast<uInt>(out_size);
+  int rc = inflate(&z, Z_FINISH);
+  size_t written = z.total_out;
+  inflateEnd(&z);
+  if (rc != Z_STREAM_END || written != out_size)
+    throw std::runtime_error("Corrupt GZIP data");
+}
+#endif
+
+double Entropy(const uint8_t *data, size_t size) {
+  uint32_t counts[256] = {};
+  for (size_t i = 0; i < size; ++i)
+    ++counts[data[i]];
+  double bits = 0;
+  for (uint32_t c : counts) {
+    if (c == 0)
+      continue;
+    double p = static_cast<double>(c) / size;
+    bits -= p * std::log2(p);
+  }
+  return bits;
+}
+
+} // namespace
+
+bool CodecAvailable(Codec codec) {
+  switch (codec) {
+  case Codec::UNCOMPRESSED:
+  case Codec::SNAPPY:
+    return true;
+#ifdef HPQ_HAVE_ZLIB
+  case Codec::GZIP:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+size_t MaxCompressedSize(Codec codec, size_t size) {
+  switch (codec) {
+  case Codec::UNCOMPRESSED:
+    return size;
+  case Codec::SNAPPY:
+    return SnappyMaxCompressedLength(size);
+#ifdef HPQ_HAVE_ZLIB
+  case Codec::GZIP:
+    // compressBound() covers the zlib wrapper; gzip's is 12 bytes larger.
+    return compressBound(static_cast<uLong>(size)) + 32;
+#endif
+  default:
+    Unavailable(codec);
+  }
+}
+
+size_t CompressBuffer(Codec codec, const uint8_t *input, size_t size,
+                      uint8_t *out, bool store) {
+  switch (codec) {
+  case Codec::UNCOMPRESSED:
+    std::memcpy(out, input, size);
+    return size;
+  case Codec::SNAPPY:
+    return store ? SnappyStore(input, size, out)
+                 : SnappyCompress(input, size, out);
+#ifdef HPQ_HAVE_ZLIB
+  case Codec::GZIP:
+    return GzipCompress(input, size, out, MaxCompressedSize(codec, size),
+                        store ? Z_NO_COMPRESSION : Z_DEFAULT_COMPRESSION);
+#endif
+  default:
+    Unavailable(codec);
+  }
+}
+
+void DecompressBuffer(Codec codec, const uint8_t *input, size_t size,
+                      uint8_t *out, size_t out_size) {
+  switch (codec) {
+  case Codec::UNCOMPRESSED:
+    if (size != out_size)
+      throw std::runtime_error("Uncompressed page size mismatch");
+    std::memcpy(out, input, size);
+    return;
+  case Codec::SNAPPY:
+    SnappyDecompress(input, size, out, out_size);
+    return;
+#ifdef HPQ_HAVE_ZLIB
+  case Codec::GZIP:
+    GzipDecompress(input, size, out, out_size);
+    return;
+#endif
+  default:
+    Unavailable(codec);
+  }
+}
+
+double EstimateCompressionRatio(Codec codec, const uint8_t *data,
+                                size_t size) {
+  if (codec == Codec::UNCOMPRESSED || size == 0)
+    return 1.0;
+
+  // Small inputs are tried whole; larger ones through evenly spaced slices
+  // so that a sorted or drifting page is represented end to end.
+  std::vector<uint8_t> sample;
+  const uint8_t *trial = data;
+  size_t trial_size = size;
+  if (size > kCompressionSampleBytes) {
+    const size_t slice = kCompressionSampleBytes / kSampleSlices;
+    const size_t stride = (size - slice) / (kSampleSlices - 1);
+    sample.resize(kCompressionSampleBytes);
+    for (int i = 0; i < kSampleSlices; ++i)
+      std::memcpy(sample.data() + i * slice, data + i * stride, slice);
+    trial = sample.data();
+    trial_size = sample.size();
+  }
+  if (Entropy(trial, trial_size) > kIncompressibleEntropy)
+    return 1.0;
+
+  std::vector<uint8_t> out(MaxCompressedSize(codec, trial_size));
+  size_t compressed = CompressBuffer(codec, trial, trial_size, out.data());
+  return static_cast<double>(compressed) / trial_size;
+}
+
+} // namespace hpq
@@ -0,0 +1,256 @@
+#include "hpq/compression/snappy.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace hpq {
+
+namespace {
+
+// Matches are searched within 64 KiB blocks, so every offset fits the
+// 2-byte copy element.
+constexpr size_t kBlockSize = 1 << 16;
+constexpr int kHashBits = 14;
+
+enum ElementType : uint8_t { kLiteral = 0, kCopy1 = 1, kCopy2 = 2, kCopy4 = 3 };
+
+inline uint32_t Load32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+inline uint64_t Load64(const uint8_t *p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint32_t HashBytes(uint32_t bytes) {
+  return (bytes * 0x1e35a7bdu) >> (32 - kHashBits);
+}
+
+uint8_t *EmitVarint(uint8_t *op, uint64_t v) {
+  while (v >= 0x80) {
+    *op++ = static_cast<uint8_t>(v | 0x80);
+    v >>= 7;
+  }
+  *op++ = static_cast<uint8_t>(v);
+  return op;
+}
+
+uint8_t *EmitLiteral(uint8_t *op, const uint8_t *literal, size_t len) {
+  const size_t n = len - 1;
+  if (n < 60) {
+    *op++ = static_cast<uint8_t>(kLiteral | (n << 2));
+  } else {
+    // Tags 60..63: the length follows in 1..4 little-endian bytes
+    int bytes = n < (1u << 8)    ? 1
+                : n < (1u << 16) ? 2
+                : n < (1u << 24) ? 3
+                                 : 4;
+    *op++ = static_cast<uint8_t>(kLiteral | ((59 + bytes) << 2));
+    for (int i = 0; i < bytes; ++i)
+      *op++ = static_cast<uint8_t>(n >> (8 * i));
+  }
+  std::memcpy(op, literal, len);
+  return op + len;
+}
+
+// 4 <= len <= 64
+uint8_t *EmitCopyAtMost64(uint8_t *op, size_t offset, size_t len) {
+  if (len < 12 && offset < 2048) {
+    *op++ = static_cast<uint8_t>(kCopy1 | ((len - 4) << 2) |
+                                 ((offset >> 8) << 5));
+    *op++ = static_cast<uint8_t>(offset);
+  } else {
+    *op++ = static_cast<uint8_t>(kCopy2 | ((len - 1) << 2));
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+  }
+  return op;
+}
+
+uint8_t *EmitCopy(uint8_t *op, size_t offset, size_t len) {
+  while (len >= 68) {
+    op = EmitCopyAtMost64(op, offset, 64);
+    len -= 64;
+  }
+  if (len > 64) { // Leaves at least 4 for the last element
+    op = EmitCopyAtMost64(op, offset, 60);
+    len -= 60;
+  }
+  return EmitCopyAtMost64(op, offset, len);
+}
+
+// Length of the common run of `a` and `b` (b < a), bounded by `end`.
+inline size_t MatchLength(const uint8_t *a, const uint8_t *b,
+                          const uint8_t *end) {
+  const uint8_t *start = a;
+  while (a + 8 <= end) {
+    uint64_t x = Load64(a) ^ Load64(b);
+    if (x != 0)
+      return a - start + (__builtin_ctzll(x) >> 3);
+    a += 8;
+    b += 8;
+  }
+  while (a < end && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return a - start;
+}
+
+// Greedy LZ77 over one block with a 4-byte hash table. The probe step grows
+// while no match is found, so incompressible input is skipped quickly.
+uint8_t *CompressBlock(const uint8_t *input, size_t size, uint8_t *op,
+                       uint16_t *table) {
+  const uint8_t *end = input + size;
+  const uint8_t *literal = input;
+  if (size > 4) {
+    std::memset(table, 0, sizeof(uint16_t) << kHashBits);
+    const uint8_t *limit = end - 4; // Last position a 4-byte load may start
+    const uint8_t *ip = input + 1;
+    for (;;) {
+      const uint8_t *candidate;
+      const uint8_t *next = ip;
+      uint32_t skip = 32;
+      do {
+        ip = next;
+        next = ip + (skip++ >> 5);
+        if (next > limit)
+          goto done;
+        uint32_t h = HashBytes(Load32(ip));
+        candidate = input + table[h];
+        table[h] = static_cast<uint16_t>(ip - input);
+      } while (Load32(ip) != Load32(candidate));
+
+      op = EmitLiteral(op, literal, ip - literal);
+      do {
+        size_t len = 4 + MatchLength(ip + 4, candidate + 4, end);
+        op = EmitCopy(op, ip - candidate, len);
+        ip += len;
+        literal = ip;
+        if (ip > limit)
+          goto done;
+        table[HashBytes(Load32(ip - 1))] =
+            static_cast<uint16_t>(ip - 1 - input);
+        uint32_t h = HashBytes(Load32(ip));
+        candidate = input + table[h];
+        table[h] = static_cast<uint16_t>(ip - input);
+      } while (Load32(ip) == Load32(candidate));
+      ++ip;
+    }
+  }
+done:
+  if (literal < end)
+    op = EmitLiteral(op, literal, end - literal);
+  return op;
+}
+
+[[noreturn]] void Corrupt() {
+  throw std::runtime_error("Corrupt Snappy data");
+}
+
+} // namespace
+
+size_t SnappyMaxCompressedLength(size_t size) { return 32 + size + size / 6; }
+
+size_t SnappyCompress(const uint8_t *input, size_t size, uint8_t *out) {
+  uint16_t table[1 << kHashBits];
+  uint8_t *op = EmitVarint(out, size);
+  for (size_t pos = 0; pos < size; pos += kBlockSize) {
+    size_t n = std::min(kBlockSize, size - pos);
+    op = CompressBlock(input + pos, n, op, table);
+  }
+  return op - out;
+}
+
+size_t SnappyStore(const uint8_t *input, size_t size, uint8_t *out) {
+  uint8_t *op = EmitVarint(out, size);
+  for (size_t pos = 0; pos < size; pos += kBlockSize)
+    op = EmitLiteral(op, input + pos, std::min(kBlockSize, size - pos));
+  return op - out;
+}
+
+void SnappyDecompress(const uint8_t *input, size_t size, uint8_t *out,
+                      size_t out_size) {
+  const uint8_t *ip = input;
+  const uint8_t *iend = input + size;
+  uint64_t length = 0;
+  for (int shift = 0;; shift += 7) {
+    if (ip == iend || shift > 28)
+      Corrupt();
+    uint8_t b = *ip++;
+    length |= static_cast<uint64_t>(b & 0x7f) << shift;
+    if (b < 0x80)
+      break;
+  }
+  if (length != out_size)
+    throw std::runtime_error("Snappy length does not match the page size");
+
+  uint8_t *op = out;
+  uint8_t *oend = out + out_size;
+  while (ip < iend) {
+    const uint8_t tag = *ip++;
+    size_t len;
+    size_t offset;
+    switch (tag & 3) {
+    case kLiteral: {
+      len = tag >> 2;
+      if (len >= 60) {
+        size_t bytes = len - 59;
+        if (static_cast<size_t>(iend - ip) < bytes)
+          Corrupt();
+        len = 0;
+        for (size_t i = 0; i < bytes; ++i)
+          len |= static_cast<size_t>(ip[i]) << (8 * i);
+        ip += bytes;
+      }
+      ++len;
+      if (static_cast<size_t>(iend - ip) < len ||
+          static_cast<size_t>(oend - op) < len)
+        Corrupt();
+      std::memcpy(op, ip, len);
+      ip += len;
+      op += len;
+      continue;
+    }
+    case kCopy1:
+      if (ip == iend)
+        Corrupt();
+      len = 4 + ((tag >> 2) & 7);
+      offset = (static_cast<size_t>(tag >> 5) << 8) | *ip++;
+      break;
+    case kCopy2:
+      if (iend - ip < 2)
+        Corrupt();
+      len = 1 + (tag >> 2);
+      offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+      ip += 2;
+      break;
+    default:
+      if (iend - ip < 4)
+        Corrupt();
+      len = 1 + (tag >> 2);
+      offset = Load32(ip);
+      ip += 4;
+    }
+    if (offset == 0 || offset > static_cast<size_t>(op - out) ||
+        len > static_cast<size_t>(oend - op))
+      Corrupt();
+    const uint8_t *src = op - offset;
+    if (offset >= len) {
+      std::memcpy(op, src, len);
+      op += len;
+    } else {
+      // Overlapping copy repeats the last `offset` bytes
+      for (size_t i = 0; i < len; ++i)
+        *op++ = src[i];
+    }
+  }
+  if (op != oend)
+    Corrupt();
+}
+
+} // namespace hpq
@@ -1,61 +1,97 @@
 #include "hpq/encodings/adaptive.h"
 #include "hpq/encodings/bitpack.h"
+#include "hpq/encodings/boolean.h"
+#include "hpq/encodings/byte_stream_split.h"
+#include "hpq/encodings/delta.h"
+#include "hpq/encodings/delta_byte_array.h"
 #include "hpq/encodings/rle.h"
+#include "hpq/util/trace.h"
 #include <algorithm>
 #include <cmath>
 #include <cstring>
-#include <iostream>
 
 namespace hpq {
 
-AdaptiveEncoder::AdaptiveEncoder(Type type) : type_(type) {}
-
-void AdaptiveEncoder::Put(const void *values, int num_values) {
-  int type_size = 0;
-  switch (type_) {
-  case Type::INT32:
-    type_size = 4;
-    break;
-  case Type::INT64:
-    type_size = 8;
-    break;
-  case Type::FLOAT:
-    type_size = 4;
-    break;
-  case Type::DOUBLE:
-    type_size = 8;
-    break;
-  case Type::BOOLEAN:
-    type_size = 1;
-    break; // Simplified
-  default:
-    type_size = 1;
-    break;
+AdaptiveEncoder::AdaptiveEncoder(Type type, Codec codec) {
+  if (type == Type::BYTE_ARRAY) {
+    impl_ = std::make_unique<TypedAdaptiveEncoder<ByteArrayType>>(codec);
+    return;
   }
+  impl_ = VisitFixedWidthType(type, [codec](auto dtype) {
+    return std::unique_ptr<Encoder>(
+        std::make_unique<TypedAdaptiveEncoder<decltype(dtype)>>(codec));
+  });
+}
+
+// Order-0 entropy in bits per byte of data[i * step] for i in [0, count).
+static double ByteEntropy(const uint8_t *data, size_t count, size_t step) {
+  uint32_t hist[256] = {0};
+  for (size_t i = 0; i < count; ++i)
+    hist[data[i * step]]++;
+  double entropy = 0;
+  for (uint32_t c : hist) {
+    if (c == 0)
+      continue;
+    double p = static_cast<double>(c) / count;
+    entropy -= p * std::log2(p);
+  }
+  return entropy;
+}
+
+// Sampled order-0 entropy of the separated byte streams over that of the
+// interleaved PLAIN bytes. A general purpose codec sees roughly that ratio
+// in compressed size.
+static double ByteStreamSplitRatio(const uint8_t *values, int num_values,
+                                   size_t width) {
+  constexpr int kSampleValues = 4096;
+  const size_t step = std::max(1, num_values / kSampleValues);
+  const size_t count = (num_values + step - 1) / step;
 
-  size_t current_size = raw_buffer_.size();
-  size_t bytes_to_add = num_values * type_size;
-  raw_buffer_.resize(current_size + bytes_to_add);
-  std::memcpy(raw_buffer_.data() + current_size, values, bytes_to_add);
-  num_values_ += num_values;
+  std::vector<uint8_t> sample(count * width);
+  for (size_t i = 0; i < count; ++i)
+    std::memcpy(sample.data() + i * width, values + i * step * width, width);
+
+  double plain_bits = ByteEntropy(sample.data(), sample.size(), 1) * width;
+  double split_bits = 0;
+  for (size_t k = 0; k < width; ++k)
+    split_bits += ByteEntropy(sample.data() + k, count, width);
+  return plain_bits > 0 ? split_bits / plain_bits : 1.0;
+}
+
+// Drift check sample: kSampleWindows runs of kSampleWindow consecutive
+// values, evenly spaced, so runs and prefix sharing stay visible. Chunks
+// under kMinSampledValues are always analyzed in full.
+constexpr int kSampleWindows = 16;
+constexpr int kSampleWindow = 64;
+constexpr int kMinSampledValues = 4 * kSampleWindows * kSampleWindow;
+
+template <typename DType>
+void TypedAdaptiveEncoder<DType>::PutTyped(const c_type *values,
+                                           int num_values) {
+  values_.insert(values_.end(), values, values + num_values);
+  if constexpr (std::is_same_v<DType, ByteArrayType>) {
+    // Copied now; the views are pointed at bytes_ in DecideAndEncode.
+    for (int i = 0; i < num_values; ++i)
+      bytes_.insert(bytes_.end(), values[i].ptr,
+                    values[i].ptr + values[i].len);
+  }
 }
 
-void AdaptiveEncoder::DecideAndEncode() {
-  // Simple heuristic:
-  // 1. Calculate min/max to see if BitPacking is viable (for INT).
-  // 2. Check for runs to see if RLE is viable.
-  // 3. Default to Plain.
+template <typename DType>
+AdaptiveProfile
+TypedAdaptiveEncoder<DType>::Analyze(const c_type *values,
+                                     int num_values) const {
+  using Choice = AdaptiveProfile::Choice;
+  AdaptiveProfile profile;
 
-  if (type_ == Type::INT32) {
-    const int32_t *values =
-        reinterpret_cast<const int32_t *>(raw_buffer_.data());
+  if constexpr (std::is_same_v<DType, Int32Type>) {
     int32_t min_val = values[0];
     int32_t max_val = values[0];
 
     // Check runs
     int max_run_length = 0;
     int current_run = 1;
-    for (int i = 1; i < num_values_; ++i) {
+    for (int i = 1; i < num_values; ++i) {
       if (values[i] < min_val)
         min_val = values[i];
       if (values[i] > max_val)
@@ -73,55 +109,179 @@ void AdaptiveEncoder::DecideAndEncode() {
       max_run_length = current_run;
 
     // Heuristics
-    bool use_rle = (max_run_length > 10); // Arbitrary threshold
+    profile.runs = (max_run_length > 10); // Arbitrary threshold
 
     // Check bit width for packing
     // Only valid if non-negative for simple bitpacking (or use zigzag)
     // Our BitPackEncoder is simple, assumes unsigned or small positive.
     bool use_bitpack = false;
-    int bit_width = 32;
     if (min_val >= 0) {
-      if (max_val == 0)
-        bit_width = 0;
-      else
-        bit_width = static_cast<int>(std::ceil(std::log2(max_val + 1)));
-
-      if (bit_width < 28)
+      profile.bit_width =
+          max_val == 0
+              ? 0
+              : static_cast<int>(std::ceil(std::log2(max_val + 1.0)));
+      if (profile.bit_width < 28)
         use_bitpack = true; // Saving at least 4 bits/value
     }
 
-    if (use_rle) {
-      // RLE wins for high repetition
-      // Note: Our RLE implementation currently uses BitPacking internally too.
-      // Ideally we pass the bit_width to RLE.
-      int width = (min_val >= 0) ? bit_width : 32;
-      current_encoder_ = std::make_unique<RleEncoder>(width);
-      std::cout << "Adaptive: Selected RLE (width=" << width << ")"
-                << std::endl;
-    } else if (use_bitpack) {
-      current_encoder_ = std::make_unique<BitPackEncoder>(bit_width);
-      std::cout << "Adaptive: Selected BitPack (width=" << bit_width << ")"
-                << std::endl;
+    // Runs and narrow ranges both pack into DELTA_BINARY_PACKED miniblocks
+    // (a run is a miniblock of zero-width deltas). Unlike bare RLE or
+    // BIT_PACKED values, those pages carry their own bit widths, so any
+    // reader can decode them.
+    profile.choice =
+        profile.runs || use_bitpack ? Choice::kDelta : Choice::kPlain;
+
+  } else if constexpr (std::is_same_v<DType, BooleanType>) {
+    // Estimate the RLE size from runs of at least 32 identical values; the
+    // rest costs the same as PLAIN (1 bit per value).
+    int64_t run_values = 0;
+    int64_t num_runs = 0;
+    int i = 0;
+    while (i < num_values) {
+      bool v = values[i] != 0;
+      int j = i + 1;
+      while (j < num_values && (values[j] != 0) == v)
+        ++j;
+      if (j - i >= 32) {
+        run_values += j - i;
+        num_runs++;
+      }
+      i = j;
+    }
+    int64_t plain_bytes = (num_values + 7) / 8;
+    int64_t rle_bytes = 4 + (num_values - run_values) / 8 + 4 * num_runs;
+    profile.choice =
+        rle_bytes < plain_bytes * 3 / 4 ? Choice::kRle : Choice::kPlain;
+
+  } else if constexpr (DType::is_floating_point) {
+    profile.ratio = ByteStreamSplitRatio(
+        reinterpret_cast<const uint8_t *>(values), num_values,
+        DType::byte_width);
+    profile.choice =
+        profile.ratio < 0.9 ? Choice::kByteStreamSplit : Choice::kPlain;
+
+  } else if constexpr (std::is_same_v<DType, ByteArrayType>) {
+    // DELTA_BYTE_ARRAY stores each value's prefix shared with the previous
+    // one as a length instead of bytes. It pays when that saves more than
+    // the prefix stream costs (up to a byte per value) plus a margin;
+    // otherwise DELTA_LENGTH_BYTE_ARRAY, which never exceeds PLAIN.
+    size_t shared = 0;
+    size_t total = 0;
+    for (int i = 0; i < num_values; ++i) {
+      total += values[i].len;
+      if (i == 0)
+        continue;
+      const ByteArray &a = values[i - 1];
+      const ByteArray &b = values[i];
+      shared += CommonPrefixLength(a.ptr, b.ptr, std::min(a.len, b.len));
+    }
+    profile.ratio = static_cast<double>(shared) / std::max<size_t>(1, total);
+    profile.choice = shared > static_cast<size_t>(num_values) + total / 10
+                         ? Choice::kDeltaByteArray
+                         : Choice::kDeltaLengthByteArray;
+  }
+  return profile;
+}
+
+// Re-derives the profile from a sample of values_ and compares it with the
+// cached one.
+template <typename DType>
+bool TypedAdaptiveEncoder<DType>::Drifted(
+    const AdaptiveProfile &cached) const {
+  const int num_values = static_cast<int>(values_.size());
+  std::vector<c_type> sample;
+  sample.reserve(kSampleWindows * kSampleWindow);
+  for (int w = 0; w < kSampleWindows; ++w) {
+    const int64_t start = static_cast<int64_t>(w) *
+                          (num_values - kSampleWindow) / (kSampleWindows - 1);
+    sample.insert(sample.end(), values_.begin() + start,
+                  values_.begin() + start + kSampleWindow);
+  }
+  const AdaptiveProfile now =
+      Analyze(sample.data(), static_cast<int>(sample.size()));
+  if (now.choice != cached.choice)
+    return true;
+  if constexpr (std::is_same_v<DType, Int32Type>) {
+    // Negative values count as wider than any width
+    auto width = [](int w) { return w < 0 ? 33 : w; };
+    return width(now.bit_width) > width(cached.bit_width);
+  } else {
+    return std::abs(now.ratio - cached.ratio) > 0.1;
+  }
+}
+
+template <typename DType> void TypedAdaptiveEncoder<DType>::DecideAndEncode() {
+  const int num_values = static_cast<int>(values_.size());
+  if constexpr (std::is_same_v<DType, ByteArrayType>) {
+    const uint8_t *bytes = bytes_.data();
+    for (auto &v : values_) {
+      v.ptr = bytes;
+      bytes += v.len;
+    }
+  }
+
+  // Types with a choice to make: INT32, BOOLEAN, BYTE_ARRAY, and floating
+  // point when the page will be compressed.
+  constexpr bool kAnalyzed =
+      std::is_same_v<DType, Int32Type> ||
+      std::is_same_v<DType, BooleanType> || DType::is_floating_point ||
+      std::is_same_v<DType, ByteArrayType>;
+  const bool analyze =
+      kAnalyzed && !(DType::is_floating_point && codec_ == Codec::UNCOMPRESSED);
+
+  AdaptiveProfile profile;
+  if (analyze) {
+    bool cached = cache_ && num_values >= kMinSampledValues &&
+                  cache_->Get(&profile);
+    if (cached) {
+      HPQ_TRACE_SPAN("adaptive drift check");
+      cached = !Drifted(profile);
+    }
+    if (cached) {
+      cache_->CountReuse();
     } else {
-      current_encoder_ = MakePlainEncoder(type_);
-      std::cout << "Adaptive: Selected Plain" << std::endl;
+      HPQ_TRACE_SPAN("adaptive analysis");
+      profile = Analyze(values_.data(), num_values);
+      if (cache_)
+        cache_->Set(profile);
     }
+  }
+
+  using Choice = AdaptiveProfile::Choice;
+  if constexpr (std::is_same_v<DType, Int32Type>) {
+    if (profile.choice == Choice::kDelta)
+      current_encoder_ = std::make_unique<TypedDeltaEncoder<Int32Type>>();
+    else
+      current_encoder_ = std::make_unique<PlainEncoder<Int32Type>>();
+
+  } else if constexpr (std::is_same_v<DType, BooleanType>) {
+    current_encoder_ = std::make_unique<BooleanEncoder>(
+        profile.choice == Choice::kRle ? Encoding::RLE : Encoding::PLAIN);
+
+  } else if constexpr (DType::is_floating_point) {
+    if (profile.choice == Choice::kByteStreamSplit)
+      current_encoder_ = std::make_unique<ByteStreamSplitEncoder>(DType::type);
+    else
+      current_encoder_ = std::make_unique<PlainEncoder<DType>>();
+
+  } else if constexpr (std::is_same_v<DType, ByteArrayType>) {
+    if (profile.choice == Choice::kDeltaByteArray)
+      current_encoder_ = std::make_unique<DeltaByteArrayEncoder>();
+    else
+      current_encoder_ = std::make_unique<DeltaLengthByteArrayEncoder>();
 
   } else {
     // Default for other types
-    current_encoder_ = MakePlainEncoder(type_);
-    std::cout << "Adaptive: Selected Plain (Default)" << std::endl;
+    current_encoder_ = std::make_unique<PlainEncoder<DType>>();
   }
 
   // Encode
-  // Note: Our encoders expect typed pointers.
-  // We have raw bytes.
-  // For INT32, raw_buffer_.data() is correct.
-  current_encoder_->Put(raw_buffer_.data(), num_values_);
+  current_encoder_->Put(values_.data(), num_values);
 }
 
-std::pair<const uint8_t *, size_t> AdaptiveEncoder::Flush() {
-  if (num_values_ == 0)
+template <typename DType>
+std::pair<const uint8_t *, size_t> TypedAdaptiveEncoder<DType>::Flush() {
+  if (values_.empty())
     return {nullptr, 0};
 
   DecideAndEncode();
@@ -130,13 +290,25 @@ std::pair<const uint8_t *, size_t> AdaptiveEncoder::Flush() {
   return result;
 }
 
-void AdaptiveEncoder::Clear() {
-  raw_buffer_.clear();
-  num_values_ = 0;
+template <typename DType>
+Encoding TypedAdaptiveEncoder<DType>::encoding() const {
+  return current_encoder_ ? current_encoder_->encoding() : Encoding::PLAIN;
+}
+
+template <typename DType> void TypedAdaptiveEncoder<DType>::Clear() {
+  values_.clear();
+  bytes_.clear();
   if (current_encoder_) {
     current_encoder_->Clear();
     current_encoder_.reset();
   }
 }
 
+template class TypedAdaptiveEncoder<BooleanType>;
+template class TypedAdaptiveEncoder<Int32Type>;
+template class TypedAdaptiveEncoder<Int64Type>;
+template class TypedAdaptiveEncoder<FloatType>;
+template class TypedAdaptiveEncoder<DoubleType>;
+template class TypedAdaptiveEncoder<ByteArrayType>;
+
 } // namespace hpq
@@ -1,7 +1,14 @@
 #include "hpq/encodings/bitpack.h"
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #if defined(__ARM_NEON)
 #include <arm_neon.h>
@@ -95,7 +102,11 @@ void BitPackEncoder::Pack8Values(const uint32_t *in, uint8_t *out) {
 
 std::pair<const uint8_t *, size_t> BitPackEncoder::Flush() {
   FlushBufferedValues();
-  // TODO: Handle remaining values (padding)
+  if (!buffered_values_.empty()) {
+    // Zero-pad the last group; readers know the value count.
+    buffered_values_.resize(8, 0);
+    FlushBufferedValues();
+  }
   return {buffer_.data(), buffer_.size()};
 }
 
@@ -104,4 +115,179 @@ void BitPackEncoder::Clear() {
   buffered_values_.clear();
 }
 
+// Little-endian load of up to 8 bytes that never reads past `end`.
+static inline uint64_t LoadBits(const uint8_t *p, const uint8_t *end) {
+  uint64_t v = 0;
+  if (p + 8 <= end)
+    std::memcpy(&v, p, 8);
+  else if (p < end)
+    std::memcpy(&v, p, end - p);
+  return v;
+}
+
+template <int W>
+static void UnpackScalar(const uint8_t *in, const uint8_t *end, size_t begin,
+                         size_t n, uint32_t *out) {
+  constexpr uint64_t mask = (uint64_t(1) << W) - 1;
+  for (size_t i = begin; i < n; ++i) {
+    size_t bit = i * W;
+    out[i] = static_cast<uint32_t>(
+        (LoadBits(in + bit / 8, end) >> (bit % 8)) & mask);
+  }
+}
+
+#if defined(__AVX2__)
+// Every group of 8 values spans exactly W bytes. Value j of a group starts
+// at byte (j * W) / 8, bit (j * W) % 8 of it; both are compile-time vectors.
+// Widths up to 25 fit one 32-bit gather lane after the shift, wider ones
+// gather 64 bits per value. The loop stops while a full-width load at the
+// last offset could still run past the input.
+template <int W>
+static size_t UnpackAvx2(const uint8_t *in, size_t in_bytes, size_t n,
+                         uint32_t *out) {
+  const size_t groups = n / 8;
+  const size_t safe_groups =
+      in_bytes >= W + 8 ? std::min(groups, (in_bytes - W - 8) / W + 1) : 0;
+  if constexpr (W <= 25) {
+    const __m256i offsets = _mm256_setr_epi32(
+        0, W / 8, 2 * W / 8, 3 * W / 8, 4 * W / 8, 5 * W / 8, 6 * W / 8,
+        7 * W / 8);
+    const __m256i shifts =
+        _mm256_setr_epi32(0, W % 8, 2 * W % 8, 3 * W % 8, 4 * W % 8,
+                          5 * W % 8, 6 * W % 8, 7 * W % 8);
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>((1u << W) - 1));
+    for (size_t g = 0; g < safe_groups; ++g) {
+      __m256i v = _mm256_i32gather_epi32(
+          reinterpret_cast<const int *>(in + g * W), offsets, 1);
+      v = _mm256_and_si256(_mm256_srlv_epi32(v, shifts), mask);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + g * 8), v);
+    }
+  } else {
+    const __m128i offsets_lo =
+        _mm_setr_epi32(0, W / 8, 2 * W / 8, 3 * W / 8);
+    const __m128i offsets_hi =
+        _mm_setr_epi32(4 * W / 8, 5 * W / 8, 6 * W / 8, 7 * W / 8);
+    const __m256i shifts_lo =
+        _mm256_setr_epi64x(0, W % 8, 2 * W % 8, 3 * W % 8);
+    const __m256i shifts_hi =
+        _mm256_setr_epi64x(4 * W % 8, 5 * W % 8, 6 * W % 8, 7 * W % 8);
+    const __m256i mask =
+        _mm256_set1_epi64x(static_cast<long long>((uint64_t(1) << W) - 1));
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    for (size_t g = 0; g < safe_groups; ++g) {
+      const long long *base = reinterpret_cast<const long long *>(in + g * W);
+      __m256i lo = _mm256_i32gather_epi64(base, offsets_lo, 1);
+      __m256i hi = _mm256_i32gather_epi64(base, offsets_hi, 1);
+      lo = _mm256_and_si256(_mm256_srlv_epi64(lo, shifts_lo), mask);
+      hi = _mm256_and_si256(_mm256_srlv_epi64(hi, shifts_hi), mask);
+      lo = _mm256_permutevar8x32_epi32(lo, even);
+      hi = _mm256_permutevar8x32_epi32(hi, even);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + g * 8),
+                          _mm256_permute2x128_si256(lo, hi, 0x20));
+    }
+  }
+  return safe_groups * 8;
+}
+#endif
+
+template <int W>
+static void Unpack(const uint8_t *in, size_t n, uint32_t *out) {
+  const size_t in_bytes = (n * W + 7) / 8;
+  size_t done = 0;
+#if defined(__AVX2__)
+  done = UnpackAvx2<W>(in, in_bytes, n, out);
+#endif
+  UnpackScalar<W>(in, in + in_bytes, done, n, out);
+}
+
+using UnpackFn = void (*)(const uint8_t *, size_t, uint32_t *);
+
+template <size_t... W>
+static constexpr std::array<UnpackFn, sizeof...(W)>
+MakeUnpackTable(std::index_sequence<W...>) {
+  return {&Unpack<static_cast<int>(W) + 1>...};
+}
+
+static constexpr auto kUnpack = MakeUnpackTable(std::make_index_sequence<32>());
+
+void UnpackBits(const uint8_t *in, int bit_width, size_t n, uint32_t *out) {
+  if (bit_width == 0) {
+    std::fill_n(out, n, 0u);
+    return;
+  }
+  if (bit_width < 0 || bit_width > 32)
+    throw std::runtime_error("Bit width out of range: " +
+                             std::to_string(bit_width));
+  kUnpack[bit_width - 1](in, n, out);
+}
+
+void UnpackBits64(const uint8_t *in, int bit_width, size_t n, uint64_t *out) {
+  if (bit_width <= 32) {
+    // Narrow widths reuse the 32-bit kernels, widening in place from the back
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(out);
+    UnpackBits(in, bit_width, n, reinterpret_cast<uint32_t *>(bytes));
+    for (size_t i = n; i-- > 0;) {
+      uint32_t v;
+      std::memcpy(&v, bytes + i * 4, 4);
+      out[i] = v;
+    }
+    return;
+  }
+  if (bit_width > 64)
+    throw std::runtime_error("Bit width out of range: " +
+                             std::to_string(bit_width));
+  const uint8_t *end = in + (n * bit_width + 7) / 8;
+  const uint64_t mask =
+      bit_width == 64 ? ~uint64_t(0) : (uint64_t(1) << bit_width) - 1;
+  for (size_t i = 0; i < n; ++i) {
+    size_t bit = i * bit_width;
+    const uint8_t *p = in + bit / 8;
+    int shift = static_cast<int>(bit % 8);
+    uint64_t v = LoadBits(p, end) >> shift;
+    if (shift + bit_width > 64)
+      v |= static_cast<uint64_t>(p[8]) << (64 - shift);
+    out[i] = v & mask;
+  }
+}
+
+BitPackDecoder::BitPackDecoder(int bit_width) : bit_width_(bit_width) {
+  if (bit_width < 0 || bit_width > 32)
+    throw std::runtime_error("Bit width out of range: " +
+                             std::to_string(bit_width));
+}
+
+void BitPackDecoder::SetData(const uint8_t *data, size_t size,
+                             int num_values) {
+  // The encoder pads to whole groups of 8 values
+  if (size < static_cast<size_t>((num_values + 7) / 8) * bit_width_)
+    throw std::runtime_error("Truncated BIT_PACKED data");
+  data_ = data;
+  position_ = 0;
+  num_values_ = num_values;
+}
+
+int BitPackDecoder::DecodeTyped(int32_t *out, int max_values) {
+  const int n = std::min(max_values, num_values_ - position_);
+  uint32_t *dst = reinterpret_cast<uint32_t *>(out);
+  int done = 0;
+  // Groups of 8 start on byte boundaries; a batch that starts or ends inside
+  // a group goes through group_.
+  while (done < n) {
+    const int pos = position_ + done;
+    const uint8_t *group = data_ + static_cast<size_t>(pos / 8) * bit_width_;
+    if (pos % 8 == 0 && n - done >= 8) {
+      int whole = (n - done) / 8 * 8;
+      UnpackBits(group, bit_width_, whole, dst + done);
+      done += whole;
+      continue;
+    }
+    UnpackBits(group, bit_width_, 8, group_);
+    int take = std::min(8 - pos % 8, n - done);
+    std::memcpy(dst + done, group_ + pos % 8, take * sizeof(uint32_t));
+    done += take;
+  }
+  position_ += n;
+  return n;
+}
+
 } // namespace hpq
@@ -0,0 +1,208 @@
+#include "hpq/encodings/boolean.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace hpq {
+
+void PackBooleans(const uint8_t *values, size_t n, uint8_t *out) {
+  size_t i = 0;
+#if defined(__AVX512BW__)
+  // 64 booleans -> one 64-bit mask per instruction
+  for (; i + 64 <= n; i += 64) {
+    __m512i v = _mm512_loadu_si512(values + i);
+    uint64_t mask = _mm512_test_epi8_mask(v, v);
+    std::memcpy(out + i / 8, &mask, 8);
+  }
+#endif
+#if defined(__AVX2__)
+  const __m256i zero = _mm256_setzero_si256();
+  for (; i + 32 <= n; i += 32) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i));
+    uint32_t mask = ~static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, zero)));
+    std::memcpy(out + i / 8, &mask, 4);
+  }
+#elif defined(__SSE2__)
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + i));
+    uint16_t mask = static_cast<uint16_t>(
+        ~_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)));
+    std::memcpy(out + i / 8, &mask, 2);
+  }
+#endif
+  // Scalar tail (and non-x86 fallback); i is a multiple of 8 here.
+  for (; i < n; i += 8) {
+    uint8_t byte = 0;
+    size_t end = (n - i < 8) ? n - i : 8;
+    for (size_t b = 0; b < end; ++b)
+      byte |= static_cast<uint8_t>((values[i + b] != 0) << b);
+    out[i / 8] = byte;
+  }
+}
+
+BooleanEncoder::BooleanEncoder(Encoding encoding) : encoding_(encoding) {}
+
+void BooleanEncoder::PutTyped(const uint8_t *input, int num_values) {
+  size_t start = num_values_;
+  size_t total = num_values_ + num_values;
+  bits_.resize((total + 7) / 8, 0);
+
+  // Finish a partially filled byte bit by bit, then pack whole bytes.
+  size_t i = 0;
+  for (; i < static_cast<size_t>(num_values) && (start + i) % 8 != 0; ++i) {
+    size_t pos = start + i;
+    bits_[pos / 8] |= static_cast<uint8_t>((input[i] != 0) << (pos % 8));
+  }
+  if (i < static_cast<size_t>(num_values))
+    PackBooleans(input + i, num_values - i, bits_.data() + (start + i) / 8);
+  num_values_ = total;
+}
+
+static void WriteVarint(std::vector<uint8_t> &buf, uint32_t value) {
+  while (value >= 0x80) {
+    buf.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buf.push_back(static_cast<uint8_t>(value));
+}
+
+void BooleanEncoder::EncodeRle() {
+  // Works on the packed bytes: each byte is a group of 8 values, and a byte
+  // of 0x00/0xFF is a uniform group. Long stretches of the same uniform byte
+  // become RLE runs; everything else is copied verbatim as bit-packed groups
+  // (width 1 bit-packing is exactly the PLAIN bit layout).
+  constexpr size_t kMinRunBytes = 4; // 32 values
+  buffer_.assign(4, 0);              // Length prefix, patched below
+
+  const size_t num_bytes = bits_.size();
+  size_t literal_start = 0;
+  auto flush_literals = [&](size_t end) {
+    if (end <= literal_start)
+      return;
+    uint32_t groups = static_cast<uint32_t>(end - literal_start);
+    WriteVarint(buffer_, (groups << 1) | 1);
+    buffer_.insert(buffer_.end(), bits_.begin() + literal_start,
+                   bits_.begin() + end);
+  };
+
+  size_t i = 0;
+  while (i < num_bytes) {
+    uint8_t b = bits_[i];
+    // The last byte may be partial; keep it literal so padding bits stay 0.
+    bool full = (i + 1) * 8 <= num_values_;
+    if (!full || (b != 0x00 && b != 0xFF)) {
+      ++i;
+      continue;
+    }
+    size_t j = i + 1;
+    while (j < num_bytes && bits_[j] == b && (j + 1) * 8 <= num_values_)
+      ++j;
+    if (j - i >= kMinRunBytes) {
+      flush_literals(i);
+      WriteVarint(buffer_, static_cast<uint32_t>((j - i) * 8) << 1);
+      buffer_.push_back(b & 1);
+      literal_start = j;
+    }
+    i = j;
+  }
+  flush_literals(num_bytes);
+
+  uint32_t len = static_cast<uint32_t>(buffer_.size() - 4);
+  std::memcpy(buffer_.data(), &len, 4);
+}
+
+std::pair<const uint8_t *, size_t> BooleanEncoder::Flush() {
+  if (encoding_ == Encoding::RLE) {
+    EncodeRle();
+    return {buffer_.data(), buffer_.size()};
+  }
+  return {bits_.data(), bits_.size()};
+}
+
+void BooleanEncoder::Clear() {
+  bits_.clear();
+  buffer_.clear();
+  num_values_ = 0;
+}
+
+void UnpackBooleans(const uint8_t *bits, size_t n, uint8_t *out) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  // Broadcast 4 packed bytes so each output byte sees its source byte, then
+  // test one bit per lane.
+  const __m256i spread = _mm256_setr_epi8(
+      0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, //
+      2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i select =
+      _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201ull));
+  const __m256i one = _mm256_set1_epi8(1);
+  for (; i + 32 <= n; i += 32) {
+    uint32_t word;
+    std::memcpy(&word, bits + i / 8, 4);
+    __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(word)),
+                                    spread);
+    v = _mm256_cmpeq_epi8(_mm256_and_si256(v, select), select);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                        _mm256_and_si256(v, one));
+  }
+#endif
+  for (; i < n; ++i)
+    out[i] = (bits[i / 8] >> (i % 8)) & 1;
+}
+
+BooleanDecoder::BooleanDecoder(Encoding encoding) : encoding_(encoding) {
+  if (encoding != Encoding::PLAIN && encoding != Encoding::RLE)
+    throw std::runtime_error("BOOLEAN supports only PLAIN and RLE");
+}
+
+void BooleanDecoder::SetData(const uint8_t *data, size_t size,
+                             int num_values) {
+  remaining_ = num_values;
+  if (encoding_ == Encoding::PLAIN) {
+    if (size < (static_cast<size_t>(num_values) + 7) / 8)
+      throw std::runtime_error("Truncated BOOLEAN data");
+    bits_ = data;
+    position_ = 0;
+    return;
+  }
+  uint32_t len = 0;
+  if (size >= 4)
+    std::memcpy(&len, data, 4);
+  if (size < 4 || len > size - 4)
+    throw std::runtime_error("Truncated BOOLEAN RLE data");
+  reader_ = RleBitPackedReader(data + 4, len, 1);
+}
+
+int BooleanDecoder::DecodeTyped(uint8_t *out, int max_values) {
+  int n = std::min(max_values, remaining_);
+  if (encoding_ == Encoding::PLAIN) {
+    // Align to a byte, then expand whole bytes
+    int i = 0;
+    for (; i < n && position_ % 8 != 0; ++i, ++position_)
+      out[i] = (bits_[position_ / 8] >> (position_ % 8)) & 1;
+    UnpackBooleans(bits_ + position_ / 8, n - i, out + i);
+    position_ += n - i;
+  } else {
+    constexpr int kChunk = 1024;
+    scratch_.resize(kChunk);
+    for (int done = 0; done < n;) {
+      int got = reader_.GetBatch(scratch_.data(), std::min(kChunk, n - done));
+      if (got == 0)
+        throw std::runtime_error("Truncated BOOLEAN RLE data");
+      for (int k = 0; k < got; ++k)
+        out[done + k] = static_cast<uint8_t>(scratch_[k]);
+      done += got;
+    }
+  }
+  remaining_ -= n;
+  return n;
+}
+
+} // namespace hpq
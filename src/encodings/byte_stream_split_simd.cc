@@ -0,0 +1,224 @@
+#include "hpq/encodings/byte_stream_split.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace hpq {
+
+static void SplitScalar(const uint8_t *values, size_t begin, size_t n,
+                        size_t width, uint8_t *out) {
+  for (size_t i = begin; i < n; ++i)
+    for (size_t k = 0; k < width; ++k)
+      out[k * n + i] = values[i * width + k];
+}
+
+static void MergeScalar(const uint8_t *streams, size_t stride, size_t begin,
+                        size_t n, size_t width, uint8_t *out) {
+  for (size_t i = begin; i < n; ++i)
+    for (size_t k = 0; k < width; ++k)
+      out[i * width + k] = streams[k * stride + i];
+}
+
+#if defined(__AVX2__)
+static inline void Store8(uint8_t *dst, __m128i v, int half) {
+  uint64_t bits = half ? static_cast<uint64_t>(_mm_extract_epi64(v, 1))
+                       : static_cast<uint64_t>(_mm_cvtsi128_si64(v));
+  std::memcpy(dst, &bits, 8);
+}
+
+// 8 floats per iteration: an in-lane byte shuffle groups each lane's 4 values
+// by byte index, then a cross-lane dword permute joins the two lanes so every
+// stream gets 8 contiguous bytes.
+static size_t Split4(const uint8_t *values, size_t n, uint8_t *out) {
+  const __m256i shuffle = _mm256_setr_epi8(
+      0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15, //
+      0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+  const __m256i permute = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + i * 4));
+    v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, shuffle), permute);
+    __m128i lo = _mm256_castsi256_si128(v);
+    __m128i hi = _mm256_extracti128_si256(v, 1);
+    Store8(out + 0 * n + i, lo, 0);
+    Store8(out + 1 * n + i, lo, 1);
+    Store8(out + 2 * n + i, hi, 0);
+    Store8(out + 3 * n + i, hi, 1);
+  }
+  return i;
+}
+
+// 8 doubles per iteration: pair rows inside each lane, regroup lanes so one
+// vector holds rows 0,1|4,5 and the other 2,3|6,7, then 16-bit unpacks and a
+// dword permute leave 8 contiguous bytes per stream.
+static size_t Split8(const uint8_t *values, size_t n, uint8_t *out) {
+  const __m256i shuffle = _mm256_setr_epi8(
+      0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15, //
+      0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+  const __m256i permute = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i *src = reinterpret_cast<const __m256i *>(values + i * 8);
+    __m256i x0 = _mm256_shuffle_epi8(_mm256_loadu_si256(src), shuffle);
+    __m256i x1 = _mm256_shuffle_epi8(_mm256_loadu_si256(src + 1), shuffle);
+    __m256i y0 = _mm256_permute2x128_si256(x0, x1, 0x20); // rows 0,1 | 4,5
+    __m256i y1 = _mm256_permute2x128_si256(x0, x1, 0x31); // rows 2,3 | 6,7
+    __m256i s0 = _mm256_permutevar8x32_epi32(_mm256_unpacklo_epi16(y0, y1),
+                                             permute); // streams 0-3
+    __m256i s1 = _mm256_permutevar8x32_epi32(_mm256_unpackhi_epi16(y0, y1),
+                                             permute); // streams 4-7
+    __m128i parts[4] = {
+        _mm256_castsi256_si128(s0), _mm256_extracti128_si256(s0, 1),
+        _mm256_castsi256_si128(s1), _mm256_extracti128_si256(s1, 1)};
+    for (int k = 0; k < 8; ++k)
+      Store8(out + k * n + i, parts[k / 2], k % 2);
+  }
+  return i;
+}
+
+// 16 floats per iteration: byte then 16-bit interleaves of the four streams
+// rebuild whole values, 4 per register.
+static size_t Merge4(const uint8_t *streams, size_t stride, size_t n,
+                     uint8_t *out) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i s[4];
+    for (int k = 0; k < 4; ++k)
+      s[k] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(streams + k * stride + i));
+    __m128i ab_lo = _mm_unpacklo_epi8(s[0], s[1]);
+    __m128i ab_hi = _mm_unpackhi_epi8(s[0], s[1]);
+    __m128i cd_lo = _mm_unpacklo_epi8(s[2], s[3]);
+    __m128i cd_hi = _mm_unpackhi_epi8(s[2], s[3]);
+    __m128i *dst = reinterpret_cast<__m128i *>(out + i * 4);
+    _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(ab_lo, cd_lo));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(ab_lo, cd_lo));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(ab_hi, cd_hi));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(ab_hi, cd_hi));
+  }
+  return i;
+}
+
+// 16 doubles per iteration: the same interleave tree one level deeper
+// (8 -> 16 -> 32 -> 64 bits).
+static size_t Merge8(const uint8_t *streams, size_t stride, size_t n,
+                     uint8_t *out) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i s[8];
+    for (int k = 0; k < 8; ++k)
+      s[k] = _mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(streams + k * stride + i));
+    __m128i *dst = reinterpret_cast<__m128i *>(out + i * 8);
+    for (int half = 0; half < 2; ++half) {
+      __m128i t[4];
+      for (int j = 0; j < 4; ++j)
+        t[j] = half ? _mm_unpackhi_epi8(s[2 * j], s[2 * j + 1])
+                    : _mm_unpacklo_epi8(s[2 * j], s[2 * j + 1]);
+      __m128i u0 = _mm_unpacklo_epi16(t[0], t[1]); // values 0-3, bytes 0-3
+      __m128i u1 = _mm_unpackhi_epi16(t[0], t[1]); // values 4-7, bytes 0-3
+      __m128i u2 = _mm_unpacklo_epi16(t[2], t[3]); // values 0-3, bytes 4-7
+      __m128i u3 = _mm_unpackhi_epi16(t[2], t[3]); // values 4-7, bytes 4-7
+      __m128i *d = dst + half * 4;
+      _mm_storeu_si128(d + 0, _mm_unpacklo_epi32(u0, u2));
+      _mm_storeu_si128(d + 1, _mm_unpackhi_epi32(u0, u2));
+      _mm_storeu_si128(d + 2, _mm_unpacklo_epi32(u1, u3));
+      _mm_storeu_si128(d + 3, _mm_unpackhi_epi32(u1, u3));
+    }
+  }
+  return i;
+}
+#endif
+
+void MergeByteStreams(const uint8_t *streams, size_t stride, size_t n,
+                      size_t width, uint8_t *out) {
+  size_t done = 0;
+#if defined(__AVX2__)
+  if (width == 4)
+    done = Merge4(streams, stride, n, out);
+  else if (width == 8)
+    done = Merge8(streams, stride, n, out);
+#endif
+  MergeScalar(streams, stride, done, n, width, out);
+}
+
+void SplitByteStreams(const uint8_t *values, size_t n, size_t width,
+                      uint8_t *out) {
+  size_t done = 0;
+#if defined(__AVX2__)
+  if (width == 4)
+    done = Split4(values, n, out);
+  else if (width == 8)
+    done = Split8(values, n, out);
+#endif
+  SplitScalar(values, done, n, width, out);
+}
+
+ByteStreamSplitEncoder::ByteStreamSplitEncoder(Type type) {
+  switch (type) {
+  case Type::FLOAT:
+    width_ = 4;
+    break;
+  case Type::DOUBLE:
+    width_ = 8;
+    break;
+  default:
+    throw std::runtime_error(
+        "BYTE_STREAM_SPLIT supports only FLOAT and DOUBLE");
+  }
+}
+
+void ByteStreamSplitEncoder::Put(const void *values, int num_values) {
+  const uint8_t *input = static_cast<const uint8_t *>(values);
+  raw_buffer_.insert(raw_buffer_.end(), input, input + num_values * width_);
+}
+
+std::pair<const uint8_t *, size_t> ByteStreamSplitEncoder::Flush() {
+  buffer_.resize(raw_buffer_.size());
+  SplitByteStreams(raw_buffer_.data(), raw_buffer_.size() / width_, width_,
+                   buffer_.data());
+  return {buffer_.data(), buffer_.size()};
+}
+
+void ByteStreamSplitEncoder::Clear() {
+  raw_buffer_.clear();
+  buffer_.clear();
+}
+
+ByteStreamSplitDecoder::ByteStreamSplitDecoder(Type type) {
+  switch (type) {
+  case Type::FLOAT:
+    width_ = 4;
+    break;
+  case Type::DOUBLE:
+    width_ = 8;
+    break;
+  default:
+    throw std::runtime_error(
+        "BYTE_STREAM_SPLIT supports only FLOAT and DOUBLE");
+  }
+}
+
+void ByteStreamSplitDecoder::SetData(const uint8_t *data, size_t size,
+                                     int num_values) {
+  if (size < static_cast<size_t>(num_values) * width_)
+    throw std::runtime_error("Truncated BYTE_STREAM_SPLIT data");
+  data_ = data;
+  stride_ = static_cast<size_t>(num_values);
+  position_ = 0;
+}
+
+int ByteStreamSplitDecoder::Decode(void *out, int max_values) {
+  size_t n = std::min(static_cast<size_t>(max_values), stride_ - position_);
+  MergeByteStreams(data_ + position_, stride_, n, width_,
+                   static_cast<uint8_t *>(out));
+  position_ += n;
+  return static_cast<int>(n);
+}
+
+} // namespace hpq
@@ -0,0 +1,202 @@
+#include "hpq/encodings/delta_byte_array.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace hpq {
+
+size_t CommonPrefixLength(const uint8_t *a, const uint8_t *b, size_t n) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  for (; i + 32 <= n; i += 32) {
+    __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+    __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+    uint32_t equal =
+        static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+    if (equal != 0xFFFFFFFFu)
+      return i + __builtin_ctz(~equal);
+  }
+#endif
+#if defined(__SSE2__)
+  for (; i + 16 <= n; i += 16) {
+    __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+    __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+    uint32_t equal =
+        static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+    if (equal != 0xFFFFu)
+      return i + __builtin_ctz(~equal);
+  }
+#endif
+  // Tail (and non-x86 fallback)
+  while (i < n && a[i] == b[i])
+    ++i;
+  return i;
+}
+
+void DeltaLengthByteArrayEncoder::PutTyped(const ByteArray *values,
+                                           int num_values) {
+  std::vector<int32_t> lengths(num_values);
+  size_t bytes = 0;
+  for (int i = 0; i < num_values; ++i) {
+    lengths[i] = static_cast<int32_t>(values[i].len);
+    bytes += values[i].len;
+  }
+  lengths_.PutTyped(lengths.data(), num_values);
+  size_t offset = data_.size();
+  data_.resize(offset + bytes);
+  for (int i = 0; i < num_values; ++i) {
+    if (values[i].len > 0)
+      std::memcpy(data_.data() + offset, values[i].ptr, values[i].len);
+    offset += values[i].len;
+  }
+}
+
+std::pair<const uint8_t *, size_t> DeltaLengthByteArrayEncoder::Flush() {
+  auto lengths = lengths_.Flush();
+  buffer_.assign(lengths.first, lengths.first + lengths.second);
+  buffer_.insert(buffer_.end(), data_.begin(), data_.end());
+  return {buffer_.data(), buffer_.size()};
+}
+
+void DeltaLengthByteArrayEncoder::Clear() {
+  lengths_.Clear();
+  data_.clear();
+  buffer_.clear();
+}
+
+void DeltaByteArrayEncoder::PutTyped(const ByteArray *values,
+                                     int num_values) {
+  if (num_values == 0)
+    return;
+  std::vector<int32_t> prefixes(num_values);
+  std::vector<ByteArray> suffixes(num_values);
+  // Within a batch the previous value is still in the caller's memory; only
+  // the first one compares against the copy kept from the last batch.
+  const uint8_t *prev = last_.data();
+  size_t prev_len = last_.size();
+  for (int i = 0; i < num_values; ++i) {
+    const ByteArray &v = values[i];
+    size_t prefix =
+        CommonPrefixLength(prev, v.ptr, std::min<size_t>(prev_len, v.len));
+    prefixes[i] = static_cast<int32_t>(prefix);
+    suffixes[i] = {v.ptr + prefix, static_cast<uint32_t>(v.len - prefix)};
+    prev = v.ptr;
+    prev_len = v.len;
+  }
+  prefixes_.PutTyped(prefixes.data(), num_values);
+  suffixes_.PutTyped(suffixes.data(), num_values);
+  last_.assign(prev, prev + prev_len);
+}
+
+std::pair<const uint8_t *, size_t> DeltaByteArrayEncoder::Flush() {
+  auto prefixes = prefixes_.Flush();
+  auto suffixes = suffixes_.Flush();
+  buffer_.assign(prefixes.first, prefixes.first + prefixes.second);
+  buffer_.insert(buffer_.end(), suffixes.first,
+                 suffixes.first + suffixes.second);
+  return {buffer_.data(), buffer_.size()};
+}
+
+void DeltaByteArrayEncoder::Clear() {
+  prefixes_.Clear();
+  suffixes_.Clear();
+  last_.clear();
+  buffer_.clear();
+}
+
+// Decodes the num_values lengths at the start of data and returns where the
+// stream ends.
+static const uint8_t *DecodeLengths(const uint8_t *data, size_t size,
+                                    int num_values,
+                                    std::vector<int32_t> *out) {
+  out->resize(num_values);
+  if (num_values == 0)
+    return data;
+  TypedDeltaDecoder<Int32Type> decoder;
+  decoder.SetData(data, size, num_values);
+  if (decoder.DecodeTyped(out->data(), num_values) != num_values)
+    throw std::runtime_error("Truncated DELTA_BINARY_PACKED lengths");
+  return decoder.position();
+}
+
+void DeltaLengthByteArrayDecoder::SetData(const uint8_t *data, size_t size,
+                                          int num_values) {
+  const uint8_t *end = data + size;
+  data_ = DecodeLengths(data, size, num_values, &lengths_);
+  size_t total = 0;
+  for (int32_t len : lengths_) {
+    if (len < 0)
+      throw std::runtime_error("Negative DELTA_LENGTH_BYTE_ARRAY length");
+    total += static_cast<size_t>(len);
+  }
+  if (total > static_cast<size_t>(end - data_))
+    throw std::runtime_error("Truncated DELTA_LENGTH_BYTE_ARRAY data");
+  next_ = 0;
+}
+
+int DeltaLengthByteArrayDecoder::DecodeTyped(ByteArray *out,
+                                             int max_values) {
+  const int n =
+      static_cast<int>(std::min<size_t>(max_values, lengths_.size() - next_));
+  for (int i = 0; i < n; ++i) {
+    const uint32_t len = static_cast<uint32_t>(lengths_[next_++]);
+    out[i] = {data_, len};
+    data_ += len;
+  }
+  return n;
+}
+
+void DeltaByteArrayDecoder::SetData(const uint8_t *data, size_t size,
+                                    int num_values) {
+  const uint8_t *suffixes = DecodeLengths(data, size, num_values, &prefixes_);
+  suffixes_.SetData(suffixes, size - (suffixes - data), num_values);
+  last_.clear();
+  next_ = 0;
+}
+
+int DeltaByteArrayDecoder::DecodeTyped(ByteArray *out, int max_values) {
+  const int n =
+      static_cast<int>(std::min<size_t>(max_values, prefixes_.size() - next_));
+  if (n == 0)
+    return 0;
+  suffix_batch_.resize(n);
+  if (suffixes_.DecodeTyped(suffix_batch_.data(), n) != n)
+    throw std::runtime_error("Truncated DELTA_BYTE_ARRAY suffixes");
+
+  // Sized up front: out[] points into values_, which must not move.
+  size_t total = 0;
+  for (int i = 0; i < n; ++i) {
+    if (prefixes_[next_ + i] < 0)
+      throw std::runtime_error("Negative DELTA_BYTE_ARRAY prefix length");
+    total += static_cast<size_t>(prefixes_[next_ + i]) + suffix_batch_[i].len;
+  }
+  values_.resize(total);
+
+  const uint8_t *prev = last_.data();
+  size_t prev_len = last_.size();
+  uint8_t *dst = values_.data();
+  for (int i = 0; i < n; ++i) {
+    const size_t prefix = static_cast<size_t>(prefixes_[next_ + i]);
+    if (prefix > prev_len)
+      throw std::runtime_error("DELTA_BYTE_ARRAY prefix longer than the "
+                               "previous value");
+    const ByteArray &suffix = suffix_batch_[i];
+    if (prefix > 0)
+      std::memcpy(dst, prev, prefix);
+    if (suffix.len > 0)
+      std::memcpy(dst + prefix, suffix.ptr, suffix.len);
+    out[i] = {dst, static_cast<uint32_t>(prefix + suffix.len)};
+    prev = dst;
+    prev_len = out[i].len;
+    dst += out[i].len;
+  }
+  last_.assign(prev, prev + prev_len);
+  next_ += n;
+  return n;
+}
+
+} // namespace hpq
@@ -1,47 +1,35 @@
 #include "hpq/encodings/dict_encoding.h"
+#include "hpq/encodings/transpose.h"
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <cstring>
-#include <iostream>
+#include <stdexcept>
 
 namespace hpq {
 
-DictEncoder::DictEncoder(Type type) : type_(type) {}
-
-void DictEncoder::Put(const void *values, int num_values) {
-  if (type_ == Type::INT64) {
-    const int64_t *input = static_cast<const int64_t *>(values);
-    for (int i = 0; i < num_values; ++i) {
-      int64_t val = input[i];
-      if (dict_int64_.find(val) == dict_int64_.end()) {
-        int32_t new_index = static_cast<int32_t>(dict_values_int64_.size());
-        dict_int64_[val] = new_index;
-        dict_values_int64_.push_back(val);
-        indices_.push_back(new_index);
-      } else {
-        indices_.push_back(dict_int64_[val]);
-      }
-    }
+DictEncoder::DictEncoder(Type type, int type_length,
+                         MemoryConsumer *memory) {
+  if (type == Type::FIXED_LEN_BYTE_ARRAY) {
+    impl_ = std::make_unique<FixedLenDictEncoder>(type_length, memory);
+    return;
   }
-  // TODO: Handle other types
+  impl_ = VisitFixedWidthType(
+      type, [memory](auto dtype) -> std::unique_ptr<Encoder> {
+        using DType = decltype(dtype);
+        if constexpr (DType::is_integer || DType::is_floating_point) {
+          return std::make_unique<TypedDictEncoder<DType>>(memory);
+        } else {
+          throw std::runtime_error(
+              "Dictionary encoding needs a numeric type");
+        }
+      });
 }
 
-std::pair<const uint8_t *, size_t> DictEncoder::Flush() {
-  buffer_.clear();
-
-  // 1. Write Dictionary Page (The actual values)
-  // In a real Parquet file, this is a separate page.
-  // For this writer, we'll prefix the data with the dictionary for simplicity
-  // of the demo. Format: [NumEntries: 4 bytes] [Value1] [Value2] ... [BitWidth:
-  // 1 byte] [RLE/BitPacked Indices]
-
-  int32_t num_entries = static_cast<int32_t>(dict_values_int64_.size());
-  buffer_.resize(sizeof(int32_t) + num_entries * sizeof(int64_t));
-
-  std::memcpy(buffer_.data(), &num_entries, sizeof(int32_t));
-  std::memcpy(buffer_.data() + sizeof(int32_t), dict_values_int64_.data(),
-              num_entries * sizeof(int64_t));
-
-  // 2. Encode Indices
+// Appends [BitWidth: 1 byte] [BitPacked Indices] for a dictionary of
+// num_entries values.
+static void AppendIndices(const std::vector<int32_t> &indices,
+                          int32_t num_entries, std::vector<uint8_t> *buffer) {
   // Calculate required bit width
   int bit_width = 1;
   if (num_entries > 0) {
@@ -60,31 +48,310 @@ std::pair<const uint8_t *, size_t> DictEncoder::Flush() {
 
   BitPackEncoder index_encoder(bit_width);
   // BitPackEncoder expects uint32_t
-  // indices_ are int32_t, safe to cast
-  index_encoder.Put(indices_.data(), indices_.size());
+  // indices are int32_t, safe to cast
+  index_encoder.Put(indices.data(), indices.size());
   auto encoded_indices = index_encoder.Flush();
 
   // Append BitWidth
   uint8_t bw_byte = static_cast<uint8_t>(bit_width);
-  buffer_.push_back(bw_byte);
+  buffer->push_back(bw_byte);
 
   // Append Encoded Indices
-  size_t dict_offset = buffer_.size();
-  buffer_.resize(dict_offset + encoded_indices.second);
-  std::memcpy(buffer_.data() + dict_offset, encoded_indices.first,
+  size_t dict_offset = buffer->size();
+  buffer->resize(dict_offset + encoded_indices.second);
+  std::memcpy(buffer->data() + dict_offset, encoded_indices.first,
               encoded_indices.second);
+}
+
+// Drift check at the end of a chunk: drop the persisted table once the
+// chunk used under a quarter of it, which also bounds it for ever-growing
+// keys (ids, timestamps). Also on generation wraparound, so stale tags can
+// never match.
+static bool ShouldResetDictionary(size_t persisted, size_t chunk_entries,
+                                  uint32_t generation) {
+  constexpr size_t kMinResetSize = 1024;
+  return persisted > std::max(kMinResetSize, 4 * chunk_entries) ||
+         generation == UINT32_MAX;
+}
 
-  std::cout << "DictEncoder: " << indices_.size() << " values -> "
-            << num_entries << " unique entries." << std::endl;
+template <typename DType>
+void TypedDictEncoder<DType>::PutTyped(const c_type *values, int num_values) {
+  indices_.reserve(indices_.size() + num_values);
+  for (int i = 0; i < num_values; ++i) {
+    key_type key;
+    std::memcpy(&key, &values[i], sizeof(key));
+    auto [it, inserted] =
+        dict_.try_emplace(key, static_cast<uint32_t>(slots_.size()));
+    if (inserted)
+      slots_.emplace_back();
+    // Warm keys cost one hash probe plus a tag check; the first occurrence
+    // in this chunk takes the next chunk-local index.
+    DictSlot &slot = slots_[it->second];
+    if (slot.generation != generation_) {
+      slot.generation = generation_;
+      slot.index = static_cast<int32_t>(dict_values_.size());
+      dict_values_.push_back(values[i]);
+    }
+    indices_.push_back(slot.index);
+  }
+}
+
+template <typename DType>
+std::pair<const uint8_t *, size_t> TypedDictEncoder<DType>::Flush() {
+  buffer_.clear();
 
+  // 1. Write Dictionary Page (The actual values)
+  // In a real Parquet file, this is a separate page.
+  // For this writer, we'll prefix the data with the dictionary for simplicity
+  // of the demo. Format: [NumEntries: 4 bytes] [Value1] [Value2] ... [BitWidth:
+  // 1 byte] [RLE/BitPacked Indices]
+
+  int32_t num_entries = static_cast<int32_t>(dict_values_.size());
+  buffer_.resize(sizeof(int32_t) + num_entries * sizeof(c_type));
+
+  std::memcpy(buffer_.data(), &num_entries, sizeof(int32_t));
+  std::memcpy(buffer_.data() + sizeof(int32_t), dict_values_.data(),
+              num_entries * sizeof(c_type));
+
+  // 2. Encode Indices
+  AppendIndices(indices_, num_entries, &buffer_);
+
+  memory_.Set(Footprint());
   return {buffer_.data(), buffer_.size()};
 }
 
-void DictEncoder::Clear() {
-  dict_int64_.clear();
-  dict_values_int64_.clear();
+template <typename DType> void TypedDictEncoder<DType>::Clear() {
+  if (ShouldResetDictionary(dict_.size(), dict_values_.size(), generation_)) {
+    dict_.clear();
+    slots_.clear();
+    generation_ = 0;
+  }
+  ++generation_;
+  dict_values_.clear();
   indices_.clear();
   buffer_.clear();
+  memory_.Set(Footprint());
+}
+
+template <typename DType> size_t TypedDictEncoder<DType>::Footprint() const {
+  // Hash nodes hold the key, the slot number and a next pointer.
+  const size_t node = sizeof(key_type) + sizeof(uint32_t) + sizeof(void *);
+  return dict_.bucket_count() * sizeof(void *) + dict_.size() * node +
+         slots_.capacity() * sizeof(DictSlot) +
+         dict_values_.capacity() * sizeof(c_type) +
+         indices_.capacity() * sizeof(int32_t) + buffer_.capacity();
+}
+
+template class TypedDictEncoder<Int32Type>;
+template class TypedDictEncoder<Int64Type>;
+template class TypedDictEncoder<FloatType>;
+template class TypedDictEncoder<DoubleType>;
+
+static size_t CheckTypeLength(int type_length) {
+  if (type_length <= 0)
+    throw std::runtime_error("FIXED_LEN_BYTE_ARRAY needs a positive length");
+  return static_cast<size_t>(type_length);
+}
+
+static uint64_t HashBytes(const uint8_t *data, size_t n) {
+  uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+    h ^= h >> 32;
+  }
+  uint64_t tail = 0;
+  std::memcpy(&tail, data + i, n - i);
+  h = (h ^ tail) * 0xC4CEB9FE1A85EC53ull;
+  return h ^ (h >> 29);
+}
+
+FixedLenDictEncoder::FixedLenDictEncoder(int type_length,
+                                         MemoryConsumer *memory)
+    : width_(CheckTypeLength(type_length)), memory_(memory) {}
+
+void FixedLenDictEncoder::Rehash(size_t buckets) {
+  table_.assign(buckets, 0);
+  const size_t mask = buckets - 1;
+  for (uint32_t slot = 0; slot < slots_.size(); ++slot) {
+    size_t b = HashBytes(keys_.data() + slot * width_, width_) & mask;
+    while (table_[b] != 0)
+      b = (b + 1) & mask;
+    table_[b] = slot + 1;
+  }
+}
+
+uint32_t FixedLenDictEncoder::FindOrInsert(const uint8_t *value) {
+  // At most half full, so probe runs stay short.
+  if (2 * (slots_.size() + 1) > table_.size())
+    Rehash(std::max<size_t>(1024, 2 * table_.size()));
+  const size_t mask = table_.size() - 1;
+  for (size_t b = HashBytes(value, width_) & mask;; b = (b + 1) & mask) {
+    const uint32_t entry = table_[b];
+    if (entry == 0) {
+      keys_.insert(keys_.end(), value, value + width_);
+      slots_.emplace_back();
+      table_[b] = static_cast<uint32_t>(slots_.size());
+      return table_[b] - 1;
+    }
+    if (std::memcmp(keys_.data() + (entry - 1) * width_, value, width_) == 0)
+      return entry - 1;
+  }
+}
+
+void FixedLenDictEncoder::Put(const void *values, int num_values) {
+  const uint8_t *src = static_cast<const uint8_t *>(values);
+  indices_.reserve(indices_.size() + num_values);
+  for (int i = 0; i < num_values; ++i, src += width_) {
+    DictSlot &slot = slots_[FindOrInsert(src)];
+    if (slot.generation != generation_) {
+      slot.generation = generation_;
+      slot.index = num_entries_++;
+      dict_values_.insert(dict_values_.end(), src, src + width_);
+    }
+    indices_.push_back(slot.index);
+  }
+}
+
+std::pair<const uint8_t *, size_t> FixedLenDictEncoder::Flush() {
+  // Same layout as TypedDictEncoder, with type_length-byte entries.
+  buffer_.resize(sizeof(int32_t));
+  std::memcpy(buffer_.data(), &num_entries_, sizeof(int32_t));
+  buffer_.insert(buffer_.end(), dict_values_.begin(), dict_values_.end());
+  AppendIndices(indices_, num_entries_, &buffer_);
+  memory_.Set(Footprint());
+  return {buffer_.data(), buffer_.size()};
+}
+
+void FixedLenDictEncoder::Clear() {
+  if (ShouldResetDictionary(slots_.size(), num_entries_, generation_)) {
+    keys_.clear();
+    table_.clear();
+    slots_.clear();
+    generation_ = 0;
+  }
+  ++generation_;
+  dict_values_.clear();
+  num_entries_ = 0;
+  indices_.clear();
+  buffer_.clear();
+  memory_.Set(Footprint());
+}
+
+size_t FixedLenDictEncoder::Footprint() const {
+  return keys_.capacity() + table_.capacity() * sizeof(uint32_t) +
+         slots_.capacity() * sizeof(DictSlot) + dict_values_.capacity() +
+         indices_.capacity() * sizeof(int32_t) + buffer_.capacity();
+}
+
+DictDecoder::DictDecoder(Type type, int type_length) {
+  if (type == Type::FIXED_LEN_BYTE_ARRAY) {
+    impl_ = std::make_unique<FixedLenDictDecoder>(type_length);
+    return;
+  }
+  impl_ = VisitFixedWidthType(type, [](auto dtype) -> std::unique_ptr<Decoder> {
+    using DType = decltype(dtype);
+    if constexpr (DType::is_integer || DType::is_floating_point) {
+      return std::make_unique<TypedDictDecoder<DType>>();
+    } else {
+      throw std::runtime_error("Dictionary encoding needs a numeric type");
+    }
+  });
+}
+
+template <typename DType>
+void TypedDictDecoder<DType>::SetData(const uint8_t *data, size_t size,
+                                      int num_values) {
+  int32_t num_entries;
+  if (size < sizeof(int32_t))
+    throw std::runtime_error("Truncated dictionary data");
+  std::memcpy(&num_entries, data, sizeof(int32_t));
+  const size_t dict_bytes = static_cast<size_t>(num_entries) * sizeof(c_type);
+  if (num_entries < 0 || size < sizeof(int32_t) + dict_bytes + 1)
+    throw std::runtime_error("Truncated dictionary data");
+
+  dict_ = data + sizeof(int32_t);
+  dict_size_ = num_entries;
+  const uint8_t *indices = dict_ + dict_bytes;
+  index_decoder_ = std::make_unique<BitPackDecoder>(indices[0]);
+  index_decoder_->SetData(indices + 1, size - (indices + 1 - data),
+                          num_values);
+  remaining_ = num_values;
+}
+
+template <typename DType>
+int TypedDictDecoder<DType>::DecodeTyped(c_type *out, int max_values) {
+  constexpr int kChunk = 1024;
+  const int n = std::min(max_values, remaining_);
+  indices_.resize(kChunk);
+  for (int done = 0; done < n;) {
+    int got = index_decoder_->DecodeTyped(indices_.data(),
+                                          std::min(kChunk, n - done));
+    // One unsigned max over the chunk guards the gather against corrupt
+    // indices without a branch per value.
+    uint32_t max_index = 0;
+    for (int k = 0; k < got; ++k)
+      max_index = std::max(max_index, static_cast<uint32_t>(indices_[k]));
+    if (got > 0 && max_index >= static_cast<uint32_t>(dict_size_))
+      throw std::runtime_error("Dictionary index out of range");
+    GatherIndexed(dict_, sizeof(c_type),
+                  reinterpret_cast<const uint32_t *>(indices_.data()), got,
+                  reinterpret_cast<uint8_t *>(out + done));
+    done += got;
+  }
+  remaining_ -= n;
+  return n;
+}
+
+template class TypedDictDecoder<Int32Type>;
+template class TypedDictDecoder<Int64Type>;
+template class TypedDictDecoder<FloatType>;
+template class TypedDictDecoder<DoubleType>;
+
+FixedLenDictDecoder::FixedLenDictDecoder(int type_length)
+    : width_(CheckTypeLength(type_length)) {}
+
+void FixedLenDictDecoder::SetData(const uint8_t *data, size_t size,
+                                  int num_values) {
+  int32_t num_entries;
+  if (size < sizeof(int32_t))
+    throw std::runtime_error("Truncated dictionary data");
+  std::memcpy(&num_entries, data, sizeof(int32_t));
+  const size_t dict_bytes = static_cast<size_t>(num_entries) * width_;
+  if (num_entries < 0 || size < sizeof(int32_t) + dict_bytes + 1)
+    throw std::runtime_error("Truncated dictionary data");
+
+  dict_ = data + sizeof(int32_t);
+  dict_size_ = num_entries;
+  const uint8_t *indices = dict_ + dict_bytes;
+  index_decoder_ = std::make_unique<BitPackDecoder>(indices[0]);
+  index_decoder_->SetData(indices + 1, size - (indices + 1 - data),
+                          num_values);
+  remaining_ = num_values;
+}
+
+int FixedLenDictDecoder::Decode(void *out, int max_values) {
+  constexpr int kChunk = 1024;
+  uint8_t *dst = static_cast<uint8_t *>(out);
+  const int n = std::min(max_values, remaining_);
+  indices_.resize(kChunk);
+  for (int done = 0; done < n;) {
+    int got = index_decoder_->DecodeTyped(indices_.data(),
+                                          std::min(kChunk, n - done));
+    uint32_t max_index = 0;
+    for (int k = 0; k < got; ++k)
+      max_index = std::max(max_index, static_cast<uint32_t>(indices_[k]));
+    if (got > 0 && max_index >= static_cast<uint32_t>(dict_size_))
+      throw std::runtime_error("Dictionary index out of range");
+    GatherIndexed(dict_, width_,
+                  reinterpret_cast<const uint32_t *>(indices_.data()), got,
+                  dst + done * width_);
+    done += got;
+  }
+  remaining_ -= n;
+  return n;
 }
 
 } // namespace hpq
@@ -1,56 +1,172 @@
 #include "hpq/encodings/encoding_base.h"
+#include "hpq/encodings/boolean.h"
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
 namespace hpq {
 
-template <typename T> class PlainEncoder : public Encoder {
-public:
-  void Put(const void *values, int num_values) override {
-    const T *input = static_cast<const T *>(values);
-    size_t current_size = buffer_.size();
-    size_t bytes_to_add = num_values * sizeof(T);
-    buffer_.resize(current_size + bytes_to_add);
-    std::memcpy(buffer_.data() + current_size, input, bytes_to_add);
-  }
+template <typename DType>
+void PlainEncoder<DType>::PutTyped(const c_type *values, int num_values) {
+  size_t current_size = buffer_.size();
+  size_t bytes_to_add = num_values * sizeof(c_type);
+  buffer_.resize(current_size + bytes_to_add);
+  std::memcpy(buffer_.data() + current_size, values, bytes_to_add);
+}
 
-  std::pair<const uint8_t *, size_t> Flush() override {
-    return {buffer_.data(), buffer_.size()};
+template <typename DType>
+std::pair<const uint8_t *, size_t> PlainEncoder<DType>::Flush() {
+  return {buffer_.data(), buffer_.size()};
+}
+
+template <>
+void PlainEncoder<ByteArrayType>::PutTyped(const ByteArray *values,
+                                           int num_values) {
+  size_t bytes = 0;
+  for (int i = 0; i < num_values; ++i)
+    bytes += 4 + values[i].len;
+  size_t offset = buffer_.size();
+  buffer_.resize(offset + bytes);
+  uint8_t *dst = buffer_.data() + offset;
+  for (int i = 0; i < num_values; ++i) {
+    std::memcpy(dst, &values[i].len, 4);
+    if (values[i].len > 0)
+      std::memcpy(dst + 4, values[i].ptr, values[i].len);
+    dst += 4 + values[i].len;
   }
+}
 
-  void Clear() override { buffer_.clear(); }
+template class PlainEncoder<Int32Type>;
+template class PlainEncoder<Int64Type>;
+template class PlainEncoder<FloatType>;
+template class PlainEncoder<DoubleType>;
+template class PlainEncoder<ByteArrayType>;
 
-private:
-  std::vector<uint8_t> buffer_;
-};
+static size_t CheckTypeLength(int type_length) {
+  if (type_length <= 0)
+    throw std::runtime_error("FIXED_LEN_BYTE_ARRAY needs a positive length");
+  return static_cast<size_t>(type_length);
+}
+
+FixedLenPlainEncoder::FixedLenPlainEncoder(int type_length)
+    : width_(CheckTypeLength(type_length)) {}
 
-// Specialization for BYTE_ARRAY (strings) could go here, but keeping it simple
-// for now.
+void FixedLenPlainEncoder::Put(const void *values, int num_values) {
+  const uint8_t *src = static_cast<const uint8_t *>(values);
+  buffer_.insert(buffer_.end(), src, src + num_values * width_);
+}
 
-std::unique_ptr<Encoder> MakePlainEncoder(Type type) {
+std::unique_ptr<Encoder> MakePlainEncoder(Type type, int type_length) {
   switch (type) {
   case Type::INT32:
-    return std::make_unique<PlainEncoder<int32_t>>();
+    return std::make_unique<PlainEncoder<Int32Type>>();
   case Type::INT64:
-    return std::make_unique<PlainEncoder<int64_t>>();
+    return std::make_unique<PlainEncoder<Int64Type>>();
   case Type::FLOAT:
-    return std::make_unique<PlainEncoder<float>>();
+    return std::make_unique<PlainEncoder<FloatType>>();
   case Type::DOUBLE:
-    return std::make_unique<PlainEncoder<double>>();
+    return std::make_unique<PlainEncoder<DoubleType>>();
   case Type::BOOLEAN:
-    return std::make_unique<PlainEncoder<
-        uint8_t>>(); // Boolean as 1 byte for now (Parquet uses bitpacking
-                     // usually but PLAIN can be byte-wise for simplicity in
-                     // some contexts, though spec says PLAIN for boolean is
-                     // bitpacked. Let's stick to simple byte storage for this
-                     // "Plain" encoder for now and refine later or use
-                     // BitPacking encoder for bools properly).
-  // Actually, Parquet PLAIN encoding for BOOLEAN *is* bit packed.
-  // For this "Minimal" phase, let's treat it as bytes and fix it when we do the
-  // actual Parquet format compliance check.
+    return std::make_unique<BooleanEncoder>(Encoding::PLAIN);
+  case Type::BYTE_ARRAY:
+    return std::make_unique<PlainEncoder<ByteArrayType>>();
+  case Type::FIXED_LEN_BYTE_ARRAY:
+    return std::make_unique<FixedLenPlainEncoder>(type_length);
   default:
     throw std::runtime_error("Unsupported type for PlainEncoder");
   }
 }
 
+template <typename DType>
+void PlainDecoder<DType>::SetData(const uint8_t *data, size_t size,
+                                  int num_values) {
+  if (size < static_cast<size_t>(num_values) * sizeof(c_type))
+    throw std::runtime_error("Truncated PLAIN data");
+  data_ = data;
+  end_ = data + size;
+  remaining_ = num_values;
+}
+
+template <>
+void PlainDecoder<ByteArrayType>::SetData(const uint8_t *data, size_t size,
+                                          int num_values) {
+  if (size < static_cast<size_t>(num_values) * 4)
+    throw std::runtime_error("Truncated PLAIN data");
+  data_ = data;
+  end_ = data + size;
+  remaining_ = num_values;
+}
+
+template <>
+int PlainDecoder<ByteArrayType>::DecodeTyped(ByteArray *out, int max_values) {
+  int n = std::min(max_values, remaining_);
+  for (int i = 0; i < n; ++i) {
+    uint32_t len;
+    if (end_ - data_ < 4)
+      throw std::runtime_error("Truncated PLAIN data");
+    std::memcpy(&len, data_, 4);
+    if (static_cast<size_t>(end_ - data_ - 4) < len)
+      throw std::runtime_error("Truncated PLAIN data");
+    out[i] = {data_ + 4, len};
+    data_ += 4 + len;
+  }
+  remaining_ -= n;
+  return n;
+}
+
+template <typename DType>
+int PlainDecoder<DType>::DecodeTyped(c_type *out, int max_values) {
+  int n = std::min(max_values, remaining_);
+  std::memcpy(out, data_, n * sizeof(c_type));
+  data_ += n * sizeof(c_type);
+  remaining_ -= n;
+  return n;
+}
+
+template class PlainDecoder<Int32Type>;
+template class PlainDecoder<Int64Type>;
+template class PlainDecoder<FloatType>;
+template class PlainDecoder<DoubleType>;
+template class PlainDecoder<ByteArrayType>;
+
+FixedLenPlainDecoder::FixedLenPlainDecoder(int type_length)
+    : width_(CheckTypeLength(type_length)) {}
+
+void FixedLenPlainDecoder::SetData(const uint8_t *data, size_t size,
+                                   int num_values) {
+  if (size < static_cast<size_t>(num_values) * width_)
+    throw std::runtime_error("Truncated PLAIN data");
+  data_ = data;
+  remaining_ = num_values;
+}
+
+int FixedLenPlainDecoder::Decode(void *out, int max_values) {
+  int n = std::min(max_values, remaining_);
+  std::memcpy(out, data_, n * width_);
+  data_ += n * width_;
+  remaining_ -= n;
+  return n;
+}
+
+std::unique_ptr<Decoder> MakePlainDecoder(Type type, int type_length) {
+  switch (type) {
+  case Type::INT32:
+    return std::make_unique<PlainDecoder<Int32Type>>();
+  case Type::INT64:
+    return std::make_unique<PlainDecoder<Int64Type>>();
+  case Type::FLOAT:
+    return std::make_unique<PlainDecoder<FloatType>>();
+  case Type::DOUBLE:
+    return std::make_unique<PlainDecoder<DoubleType>>();
+  case Type::BOOLEAN:
+    return std::make_unique<BooleanDecoder>(Encoding::PLAIN);
+  case Type::BYTE_ARRAY:
+    return std::make_unique<PlainDecoder<ByteArrayType>>();
+  case Type::FIXED_LEN_BYTE_ARRAY:
+    return std::make_unique<FixedLenPlainDecoder>(type_length);
+  default:
+    throw std::runtime_error("Unsupported type for PlainDecoder");
+  }
+}
+
 } // namespace hpq
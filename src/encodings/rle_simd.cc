@@ -1,9 +1,17 @@
 #include "hpq/encodings/rle.h"
+#include <algorithm>
 #include <cstring>
-#include <iostream>
+#include <stdexcept>
 
 namespace hpq {
-// RLE SIMD implementation stub
+
+static void WriteVarint(std::vector<uint8_t> &buf, uint32_t value) {
+  while (value >= 0x80) {
+    buf.push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  buf.push_back(static_cast<uint8_t>(value));
+}
 
 RleEncoder::RleEncoder(int bit_width)
     : bit_width_(bit_width),
@@ -11,130 +19,67 @@ RleEncoder::RleEncoder(int bit_width)
 
 void RleEncoder::Put(const void *values, int num_values) {
   const uint32_t *input = static_cast<const uint32_t *>(values);
-
   for (int i = 0; i < num_values; ++i) {
-    uint32_t val = input[i];
-
-    if (run_length_ == 0) {
-      current_value_ = val;
-      run_length_ = 1;
-    } else if (val == current_value_) {
-      run_length_++;
-    } else {
-      // Value changed
-      if (run_length_ >= 8) {
-        // It was a run, flush it
-        FlushRun();
-        current_value_ = val;
-        run_length_ = 1;
-      } else {
-        // Not a long enough run, treat as literals
-        // But wait, we might have had a short run of previous value.
-        // For simplicity in this "Minimal" phase, let's just buffer literals
-        // if we break a run.
-        // A real RLE encoder is more complex (buffering literals until 8, etc.)
-        // Let's implement a simple greedy approach:
-        // If run >= 8, emit RLE. Else, emit literals.
-
-        // If we are here, the previous run ended.
-        // If it was short, add to literals.
-        for (int k = 0; k < run_length_; ++k) {
-          literal_buffer_.push_back(current_value_);
-        }
-
-        // If literal buffer gets too big (e.g. 512 values), flush it as
-        // bitpacked
-        if (literal_buffer_.size() >= 512) { // Arbitrary chunk size
-          FlushLiterals();
-        }
-
-        current_value_ = val;
-        run_length_ = 1;
-      }
+    if (run_length_ > 0 && input[i] == current_value_) {
+      ++run_length_;
+      continue;
     }
+    EndRun();
+    current_value_ = input[i];
+    run_length_ = 1;
   }
 }
 
-void RleEncoder::FlushRun() {
-  // Parquet RLE format:
-  // header: (run_length << 1) | 0
-  // value: stored based on bit_width
-  // But wait, Parquet RLE header is varint.
-  // For this "High Performance" demo, let's stick to a simplified format or
-  // just use the BitPacker for everything if we want to be lazy, BUT the prompt
-  // asks for RLE. Let's just output [header, value] for now.
-
-  // Note: This is NOT fully Parquet spec compliant yet, but demonstrates the
-  // logic. To be compliant, we need varint encoding.
-
-  // Simplified: 4 bytes length, 4 bytes value (bad compression but works)
-  // Or better: use the bit_width.
-
-  // Let's just append to buffer for now.
-  // We need to distinguish RLE from BitPacked.
-  // Parquet uses a header for each run.
-
-  // Header (varint): (count << 1) | 0
-  uint32_t header = (run_length_ << 1) | 0;
-  // Write header (simplified varint - just 4 bytes for now)
-  size_t current_size = buffer_.size();
-  buffer_.resize(current_size + 4 +
-                 (bit_width_ + 7) / 8); // Header + Value bytes
-
-  // Write header
-  std::memcpy(buffer_.data() + current_size, &header, 4);
-
-  // Write value (simplified)
-  // We should pack it properly.
-  std::memcpy(buffer_.data() + current_size + 4, &current_value_,
-              (bit_width_ + 7) / 8);
+// Runs of 8 or more become RLE runs. Literal runs must hold whole groups of
+// 8, so a run first tops the pending literals up to a group boundary, and
+// shorter runs are appended to the literals.
+void RleEncoder::EndRun() {
+  if (run_length_ >= 8) {
+    int top_up = static_cast<int>((8 - literal_buffer_.size() % 8) % 8);
+    literal_buffer_.insert(literal_buffer_.end(), top_up, current_value_);
+    run_length_ -= top_up;
+    FlushLiterals(false);
+    if (run_length_ > 0)
+      FlushRun();
+  } else {
+    literal_buffer_.insert(literal_buffer_.end(), run_length_, current_value_);
+    if (literal_buffer_.size() >= 512)
+      FlushLiterals(false);
+  }
+  run_length_ = 0;
+}
 
+void RleEncoder::FlushRun() {
+  WriteVarint(buffer_, static_cast<uint32_t>(run_length_) << 1);
+  const size_t value_bytes = (bit_width_ + 7) / 8;
+  size_t offset = buffer_.size();
+  buffer_.resize(offset + value_bytes);
+  std::memcpy(buffer_.data() + offset, &current_value_, value_bytes);
   run_length_ = 0;
 }
 
-void RleEncoder::FlushLiterals() {
-  if (literal_buffer_.empty())
+// Writes the literals as one bit-packed run. Unless this is the end of the
+// data only whole groups go out; the remainder waits for more values.
+void RleEncoder::FlushLiterals(bool final) {
+  size_t count = literal_buffer_.size();
+  if (!final)
+    count -= count % 8;
+  if (count == 0)
     return;
 
-  // Parquet Bit-Packed run:
-  // header: ((num_groups) << 1) | 1
-  // followed by bit-packed data.
-
-  size_t num_values = literal_buffer_.size();
-  // Round up to multiple of 8
-  size_t padding = (8 - (num_values % 8)) % 8;
-  for (size_t i = 0; i < padding; ++i)
-    literal_buffer_.push_back(0);
-
-  size_t num_groups = literal_buffer_.size() / 8;
-  uint32_t header = (num_groups << 1) | 1;
-
-  size_t current_size = buffer_.size();
-  buffer_.resize(current_size + 4);
-  std::memcpy(buffer_.data() + current_size, &header, 4);
-
-  // Use BitPacker to pack literals
+  uint32_t groups = static_cast<uint32_t>((count + 7) / 8);
+  WriteVarint(buffer_, (groups << 1) | 1);
   bit_packer_->Clear();
-  bit_packer_->Put(literal_buffer_.data(), literal_buffer_.size());
-  auto packed = bit_packer_->Flush();
-
+  bit_packer_->Put(literal_buffer_.data(), static_cast<int>(count));
+  auto packed = bit_packer_->Flush(); // Pads the final group with zeros
   buffer_.insert(buffer_.end(), packed.first, packed.first + packed.second);
-
-  literal_buffer_.clear();
+  literal_buffer_.erase(literal_buffer_.begin(),
+                        literal_buffer_.begin() + count);
 }
 
 std::pair<const uint8_t *, size_t> RleEncoder::Flush() {
-  // Flush any remaining run or literals
-  if (run_length_ >= 8) {
-    FlushRun();
-  } else if (run_length_ > 0) {
-    for (int k = 0; k < run_length_; ++k) {
-      literal_buffer_.push_back(current_value_);
-    }
-    run_length_ = 0;
-  }
-  FlushLiterals();
-
+  EndRun();
+  FlushLiterals(true);
   return {buffer_.data(), buffer_.size()};
 }
 
@@ -145,4 +90,88 @@ void RleEncoder::Clear() {
   bit_packer_->Clear();
 }
 
+RleBitPackedReader::RleBitPackedReader(const uint8_t *data, size_t size,
+                                       int bit_width)
+    : data_(data), end_(data + size), bit_width_(bit_width) {
+  if (bit_width < 0 || bit_width > 32)
+    throw std::runtime_error("RLE bit width out of range");
+}
+
+bool RleBitPackedReader::NextRun() {
+  if (data_ >= end_)
+    return false;
+  uint64_t header = 0;
+  for (int shift = 0;; shift += 7) {
+    if (data_ >= end_ || shift > 35)
+      throw std::runtime_error("Malformed RLE run header");
+    uint8_t b = *data_++;
+    header |= static_cast<uint64_t>(b & 0x7F) << shift;
+    if (!(b & 0x80))
+      break;
+  }
+
+  if (header & 1) {
+    int64_t groups = static_cast<int64_t>(header >> 1);
+    size_t bytes = static_cast<size_t>(groups) * bit_width_;
+    if (bytes > static_cast<size_t>(end_ - data_))
+      throw std::runtime_error("Truncated RLE literal run");
+    literals_ = data_;
+    literal_count_ = groups * 8;
+    literal_pos_ = 0;
+    data_ += bytes;
+  } else {
+    size_t value_bytes = (bit_width_ + 7) / 8;
+    if (value_bytes > static_cast<size_t>(end_ - data_))
+      throw std::runtime_error("Truncated RLE run");
+    repeat_value_ = 0;
+    std::memcpy(&repeat_value_, data_, value_bytes);
+    repeat_count_ = static_cast<int64_t>(header >> 1);
+    data_ += value_bytes;
+  }
+  return true;
+}
+
+int RleBitPackedReader::GetBatch(uint32_t *out, int n) {
+  int done = 0;
+  while (done < n) {
+    if (repeat_count_ > 0) {
+      int take = static_cast<int>(std::min<int64_t>(repeat_count_, n - done));
+      std::fill_n(out + done, take, repeat_value_);
+      repeat_count_ -= take;
+      done += take;
+    } else if (literal_pos_ < literal_count_) {
+      int64_t left = literal_count_ - literal_pos_;
+      const uint8_t *group = literals_ + (literal_pos_ / 8) * bit_width_;
+      if (literal_pos_ % 8 == 0 && n - done >= 8 && left >= 8) {
+        int whole = static_cast<int>(std::min<int64_t>(n - done, left)) / 8 * 8;
+        UnpackBits(group, bit_width_, whole, out + done);
+        literal_pos_ += whole;
+        done += whole;
+      } else {
+        UnpackBits(group, bit_width_, 8, group_);
+        int offset = static_cast<int>(literal_pos_ % 8);
+        int take = std::min(8 - offset, n - done);
+        std::memcpy(out + done, group_ + offset, take * sizeof(uint32_t));
+        literal_pos_ += take;
+        done += take;
+      }
+    } else if (!NextRun()) {
+      break;
+    }
+  }
+  return done;
+}
+
+void RleDecoder::SetData(const uint8_t *data, size_t size, int num_values) {
+  reader_ = RleBitPackedReader(data, size, bit_width_);
+  remaining_ = num_values;
+}
+
+int RleDecoder::DecodeTyped(int32_t *out, int max_values) {
+  int n = reader_.GetBatch(reinterpret_cast<uint32_t *>(out),
+                           std::min(max_values, remaining_));
+  remaining_ -= n;
+  return n;
+}
+
 } // namespace hpq
@@ -0,0 +1,137 @@
+#include "hpq/encodings/transpose.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace hpq {
+
+template <size_t W>
+static void GatherScalar(const uint8_t *rows, size_t stride, size_t n,
+                         uint8_t *out) {
+  for (size_t i = 0; i < n; ++i)
+    std::memcpy(out + i * W, rows + i * stride, W);
+}
+
+#if defined(__AVX2__)
+// 32-bit gather offsets: callers keep 8 * stride well inside INT32_MAX (the
+// writer tiles rows), otherwise we fall back to scalar.
+static void Gather32(const uint8_t *rows, size_t stride, size_t n,
+                     uint8_t *out) {
+  const int s = static_cast<int>(stride);
+  const __m256i offsets =
+      _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i v = _mm256_i32gather_epi32(
+        reinterpret_cast<const int *>(rows + i * stride), offsets, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 4), v);
+  }
+  GatherScalar<4>(rows + i * stride, stride, n - i, out + i * 4);
+}
+
+static void Gather64(const uint8_t *rows, size_t stride, size_t n,
+                     uint8_t *out) {
+  const int s = static_cast<int>(stride);
+  const __m128i offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_i32gather_epi64(
+        reinterpret_cast<const long long *>(rows + i * stride), offsets, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 8), v);
+  }
+  GatherScalar<8>(rows + i * stride, stride, n - i, out + i * 8);
+}
+
+static void GatherIndexed32(const uint8_t *values, const uint32_t *indices,
+                            size_t n, uint8_t *out) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256i idx =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(indices + i));
+    __m256i v = _mm256_i32gather_epi32(
+        reinterpret_cast<const int *>(values), idx, 4);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 4), v);
+  }
+  for (; i < n; ++i)
+    std::memcpy(out + i * 4, values + size_t(indices[i]) * 4, 4);
+}
+
+static void GatherIndexed64(const uint8_t *values, const uint32_t *indices,
+                            size_t n, uint8_t *out) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128i idx =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i));
+    __m256i v = _mm256_i32gather_epi64(
+        reinterpret_cast<const long long *>(values), idx, 8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 8), v);
+  }
+  for (; i < n; ++i)
+    std::memcpy(out + i * 8, values + size_t(indices[i]) * 8, 8);
+}
+#endif
+
+template <size_t W>
+static void GatherIndexedScalar(const uint8_t *values, const uint32_t *indices,
+                                size_t n, uint8_t *out) {
+  for (size_t i = 0; i < n; ++i)
+    std::memcpy(out + i * W, values + size_t(indices[i]) * W, W);
+}
+
+void GatherIndexed(const uint8_t *values, size_t width,
+                   const uint32_t *indices, size_t n, uint8_t *out) {
+#if defined(__AVX2__)
+  if (width == 4)
+    return GatherIndexed32(values, indices, n, out);
+  if (width == 8)
+    return GatherIndexed64(values, indices, n, out);
+#endif
+  switch (width) {
+  case 1:
+    return GatherIndexedScalar<1>(values, indices, n, out);
+  case 2:
+    return GatherIndexedScalar<2>(values, indices, n, out);
+  case 4:
+    return GatherIndexedScalar<4>(values, indices, n, out);
+  case 8:
+    return GatherIndexedScalar<8>(values, indices, n, out);
+  default:
+    for (size_t i = 0; i < n; ++i)
+      std::memcpy(out + i * width, values + size_t(indices[i]) * width,
+                  width);
+  }
+}
+
+void GatherField(const uint8_t *rows, size_t stride, size_t width, size_t n,
+                 uint8_t *out) {
+  if (stride == width) {
+    // Single-field rows are already columnar.
+    std::memcpy(out, rows, n * width);
+    return;
+  }
+#if defined(__AVX2__)
+  if (stride <= (1u << 27)) {
+    if (width == 4)
+      return Gather32(rows, stride, n, out);
+    if (width == 8)
+      return Gather64(rows, stride, n, out);
+  }
+#endif
+  switch (width) {
+  case 1:
+    return GatherScalar<1>(rows, stride, n, out);
+  case 2:
+    return GatherScalar<2>(rows, stride, n, out);
+  case 4:
+    return GatherScalar<4>(rows, stride, n, out);
+  case 8:
+    return GatherScalar<8>(rows, stride, n, out);
+  default:
+    for (size_t i = 0; i < n; ++i)
+      std::memcpy(out + i * width, rows + i * stride, width);
+  }
+}
+
+} // namespace hpq
@@ -1,151 +1,159 @@
 #include "hpq/bloom_filter.h"
 #include <cmath>
 #include <cstring>
-#include <iostream>
+#include <stdexcept>
 
 namespace hpq {
 
-// MurmurHash3 64-bit implementation (simplified for standalone use)
-static uint64_t MurmurHash3_x64_64(const void *key, int len, uint32_t seed) {
-  const uint64_t m = 0xc6a4a7935bd1e995ULL;
-  const int r = 47;
+namespace {
 
-  uint64_t h = seed ^ (len * m);
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
 
-  const uint64_t *data = (const uint64_t *)key;
-  const uint64_t *end = data + (len / 8);
+// Per-word multipliers from the Parquet spec.
+constexpr uint32_t kSalt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                               0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                               0x9efc4947U, 0x5c6bfb31U};
 
-  while (data != end) {
-    uint64_t k = *data++;
+inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
 
-    k *= m;
-    k ^= k >> r;
-    k *= m;
-
-    h ^= k;
-    h *= m;
-  }
+inline uint64_t Load64(const uint8_t *p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
 
-  const unsigned char *data2 = (const unsigned char *)data;
-
-  switch (len & 7) {
-  case 7:
-    h ^= (uint64_t)data2[6] << 48;
-    [[fallthrough]];
-  case 6:
-    h ^= (uint64_t)data2[5] << 40;
-    [[fallthrough]];
-  case 5:
-    h ^= (uint64_t)data2[4] << 32;
-    [[fallthrough]];
-  case 4:
-    h ^= (uint64_t)data2[3] << 24;
-    [[fallthrough]];
-  case 3:
-    h ^= (uint64_t)data2[2] << 16;
-    [[fallthrough]];
-  case 2:
-    h ^= (uint64_t)data2[1] << 8;
-    [[fallthrough]];
-  case 1:
-    h ^= (uint64_t)data2[0];
-    h *= m;
-  };
-
-  h ^= h >> r;
-  h *= m;
-  h ^= h >> r;
+inline uint32_t Load32(const uint8_t *p) {
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
 
-  return h;
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime2;
+  return Rotl(acc, 31) * kPrime1;
 }
 
-BloomFilter::BloomFilter(int expected_items, double fpp) {
-  // Optimal number of bits: m = -(n * ln(p)) / (ln(2)^2)
-  num_bits_ = static_cast<int>(-(expected_items * std::log(fpp)) /
-                               (std::pow(std::log(2), 2)));
+inline uint64_t MergeRound(uint64_t acc, uint64_t value) {
+  acc ^= Round(0, value);
+  return acc * kPrime1 + kPrime4;
+}
 
-  // Optimal number of hash functions: k = (m / n) * ln(2)
-  num_hashes_ = static_cast<int>((num_bits_ / expected_items) * std::log(2));
+} // namespace
+
+// xxHash64 with seed 0, as required for Parquet Bloom filters.
+uint64_t BloomFilter::Hash(const void *data, size_t size) {
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  const uint8_t *end = p + size;
+  uint64_t h;
+
+  if (size >= 32) {
+    uint64_t v1 = kPrime1 + kPrime2;
+    uint64_t v2 = kPrime2;
+    uint64_t v3 = 0;
+    uint64_t v4 = 0 - kPrime1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = Round(v1, Load64(p));
+      v2 = Round(v2, Load64(p + 8));
+      v3 = Round(v3, Load64(p + 16));
+      v4 = Round(v4, Load64(p + 24));
+    }
+    h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+    h = MergeRound(h, v1);
+    h = MergeRound(h, v2);
+    h = MergeRound(h, v3);
+    h = MergeRound(h, v4);
+  } else {
+    h = kPrime5;
+  }
 
-  // Ensure minimums
-  if (num_bits_ < 64)
-    num_bits_ = 64;
-  if (num_hashes_ < 1)
-    num_hashes_ = 1;
+  h += size;
+  for (; p + 8 <= end; p += 8) {
+    h ^= Round(0, Load64(p));
+    h = Rotl(h, 27) * kPrime1 + kPrime4;
+  }
+  if (p + 4 <= end) {
+    h ^= static_cast<uint64_t>(Load32(p)) * kPrime1;
+    h = Rotl(h, 23) * kPrime2 + kPrime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    h ^= *p * kPrime5;
+    h = Rotl(h, 11) * kPrime1;
+  }
 
-  // Round up to byte boundary
-  int num_bytes = (num_bits_ + 7) / 8;
-  bitset_.resize(num_bytes, 0);
-  num_bits_ = num_bytes * 8; // Adjust to actual size
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
 }
 
-uint64_t BloomFilter::Hash(int64_t value) const {
-  return MurmurHash3_x64_64(&value, sizeof(int64_t), 0x9747b28c);
+size_t BloomFilter::OptimalNumBytes(int64_t ndv, double fpp) {
+  // m = -8 * ndv / ln(1 - fpp^(1/8)) bits for eight bits set per value.
+  double bits =
+      -8.0 * static_cast<double>(ndv) / std::log(1.0 - std::pow(fpp, 1.0 / 8));
+  size_t bytes = kMinBytes;
+  while (bytes < kMaxBytes && bytes * 8 < bits)
+    bytes *= 2;
+  return bytes;
 }
 
-uint64_t BloomFilter::Hash(const std::string &value) const {
-  return MurmurHash3_x64_64(value.data(), value.size(), 0x9747b28c);
+BloomFilter::BloomFilter(int expected_items, double fpp)
+    : words_(OptimalNumBytes(expected_items, fpp) / sizeof(uint32_t), 0) {}
+
+BloomFilter::BloomFilter(const std::vector<uint8_t> &bitset) {
+  size_t n = bitset.size();
+  if (n < kMinBytes || n > kMaxBytes || (n & (n - 1)) != 0)
+    throw std::runtime_error("Invalid Bloom filter size");
+  words_.resize(n / sizeof(uint32_t));
+  std::memcpy(words_.data(), bitset.data(), n); // Little endian on disk
 }
 
-void BloomFilter::SetBit(int index) {
-  bitset_[index / 8] |= (1 << (index % 8));
+void BloomFilter::InsertHash(uint64_t hash) {
+  const uint64_t num_blocks = words_.size() / 8;
+  uint32_t *block = words_.data() + ((hash >> 32) * num_blocks >> 32) * 8;
+  const uint32_t key = static_cast<uint32_t>(hash);
+  for (int i = 0; i < 8; ++i)
+    block[i] |= 1u << ((key * kSalt[i]) >> 27);
 }
 
-bool BloomFilter::GetBit(int index) const {
-  return (bitset_[index / 8] & (1 << (index % 8))) != 0;
+bool BloomFilter::FindHash(uint64_t hash) const {
+  const uint64_t num_blocks = words_.size() / 8;
+  const uint32_t *block =
+      words_.data() + ((hash >> 32) * num_blocks >> 32) * 8;
+  const uint32_t key = static_cast<uint32_t>(hash);
+  // Branch-free over the block so the loop vectorizes.
+  uint32_t missing = 0;
+  for (int i = 0; i < 8; ++i)
+    missing |= ~block[i] & (1u << ((key * kSalt[i]) >> 27));
+  return missing == 0;
 }
 
 void BloomFilter::Insert(int64_t value) {
-  uint64_t h = Hash(value);
-  uint32_t h1 = h & 0xFFFFFFFF;
-  uint32_t h2 = h >> 32;
-
-  for (int i = 0; i < num_hashes_; ++i) {
-    // Double hashing: h(i) = (h1 + i * h2) % num_bits
-    uint32_t combined = h1 + i * h2;
-    SetBit(combined % num_bits_);
-  }
+  InsertHash(Hash(&value, sizeof(value)));
 }
 
 void BloomFilter::Insert(const std::string &value) {
-  uint64_t h = Hash(value);
-  uint32_t h1 = h & 0xFFFFFFFF;
-  uint32_t h2 = h >> 32;
-
-  for (int i = 0; i < num_hashes_; ++i) {
-    uint32_t combined = h1 + i * h2;
-    SetBit(combined % num_bits_);
-  }
+  InsertHash(Hash(value.data(), value.size()));
 }
 
 bool BloomFilter::Find(int64_t value) const {
-  uint64_t h = Hash(value);
-  uint32_t h1 = h & 0xFFFFFFFF;
-  uint32_t h2 = h >> 32;
-
-  for (int i = 0; i < num_hashes_; ++i) {
-    uint32_t combined = h1 + i * h2;
-    if (!GetBit(combined % num_bits_)) {
-      return false;
-    }
-  }
-  return true;
+  return FindHash(Hash(&value, sizeof(value)));
 }
 
 bool BloomFilter::Find(const std::string &value) const {
-  uint64_t h = Hash(value);
-  uint32_t h1 = h & 0xFFFFFFFF;
-  uint32_t h2 = h >> 32;
-
-  for (int i = 0; i < num_hashes_; ++i) {
-    uint32_t combined = h1 + i * h2;
-    if (!GetBit(combined % num_bits_)) {
-      return false;
-    }
-  }
-  return true;
+  return FindHash(Hash(value.data(), value.size()));
 }
 
-std::vector<uint8_t> BloomFilter::Serialize() const { return bitset_; }
+std::vector<uint8_t> BloomFilter::Serialize() const {
+  std::vector<uint8_t> out(num_bytes());
+  std::memcpy(out.data(), words_.data(), out.size());
+  return out;
+}
 
 } // namespace hpq
@@ -1,3 +1,92 @@
+#include "hpq/format/parquet_layout.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
 namespace hpq {
-// Parquet layout implementation stub
+
+void WriteFileHeader(OutputStream &out) {
+  out.Write(kParquetMagic, sizeof(kParquetMagic));
 }
+
+void WriteFileFooter(OutputStream &out, const FileMetaData &metadata) {
+  std::vector<uint8_t> footer;
+  SerializeFileMetaData(metadata, &footer);
+
+  uint32_t footer_len = static_cast<uint32_t>(footer.size());
+  uint8_t len_bytes[4];
+  std::memcpy(len_bytes, &footer_len, 4); // Little endian on supported hosts
+  footer.insert(footer.end(), len_bytes, len_bytes + 4);
+  footer.insert(footer.end(), kParquetMagic, kParquetMagic + 4);
+  out.Write(footer.data(), footer.size());
+}
+
+static void ReadAt(int fd, const std::string &filename, int64_t offset,
+                   size_t size, uint8_t *out) {
+  size_t done = 0;
+  while (done < size) {
+    ssize_t n = ::pread(fd, out + done, size - done, offset + done);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0)
+      throw std::runtime_error("Read failed on " + filename + ": " +
+                               std::strerror(errno));
+    if (n == 0)
+      throw std::runtime_error("Unexpected end of file in " + filename);
+    done += static_cast<size_t>(n);
+  }
+}
+
+FileMetaData ReadFileFooter(int fd, const std::string &filename,
+                            int64_t *footer_offset) {
+  struct stat st;
+  if (::fstat(fd, &st) != 0)
+    throw std::runtime_error("Failed to stat " + filename);
+  const int64_t file_size = st.st_size;
+  if (file_size < 12)
+    throw std::runtime_error(filename + " is too small for Parquet");
+
+  uint8_t tail[8];
+  ReadAt(fd, filename, file_size - 8, sizeof(tail), tail);
+  if (std::memcmp(tail + 4, kParquetMagic, 4) != 0)
+    throw std::runtime_error(filename + " has no Parquet footer");
+  uint32_t footer_len;
+  std::memcpy(&footer_len, tail, 4);
+  if (footer_len > static_cast<uint64_t>(file_size - 12))
+    throw std::runtime_error("Corrupt footer length in " + filename);
+
+  *footer_offset = file_size - 8 - footer_len;
+  std::vector<uint8_t> footer(footer_len);
+  ReadAt(fd, filename, *footer_offset, footer_len, footer.data());
+  FileMetaData metadata = ParseFileMetaData(footer.data(), footer.size());
+  for (const auto &rg : metadata.row_groups) {
+    if (rg.columns.size() != metadata.schema.size())
+      throw std::runtime_error("Row group column count does not match the "
+                               "schema in " + filename);
+  }
+  return metadata;
+}
+
+void AppendAllDefinedLevels(std::vector<uint8_t> *out, int32_t num_values) {
+  // One RLE run: varint header (count << 1), then the value (1) in
+  // ceil(bit_width / 8) = 1 byte.
+  uint8_t run[6];
+  int len = 0;
+  uint32_t header = static_cast<uint32_t>(num_values) << 1;
+  while (header >= 0x80) {
+    run[len++] = static_cast<uint8_t>(header | 0x80);
+    header >>= 7;
+  }
+  run[len++] = static_cast<uint8_t>(header);
+  run[len++] = 1;
+
+  uint32_t run_bytes = static_cast<uint32_t>(len);
+  size_t pos = out->size();
+  out->resize(pos + 4 + len);
+  std::memcpy(out->data() + pos, &run_bytes, 4);
+  std::memcpy(out->data() + pos + 4, run, len);
+}
+
+} // namespace hpq
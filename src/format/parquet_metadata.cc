@@ -1,3 +1,790 @@
+#include "hpq/format/parquet_metadata.h"
+#include "hpq/format/thrift_compact.h"
+#include <stdexcept>
+
 namespace hpq {
-// Parquet metadata implementation stub
+
+Codec ParseCodec(const std::string &name) {
+  if (name == "SNAPPY")
+    return Codec::SNAPPY;
+  if (name == "GZIP")
+    return Codec::GZIP;
+  if (name == "ZSTD")
+    return Codec::ZSTD;
+  return Codec::UNCOMPRESSED;
 }
+
+// Parquet physical Type enum values (parquet.thrift); hpq::Type has no INT96.
+static int32_t ToThriftType(Type type) {
+  switch (type) {
+  case Type::BOOLEAN:
+    return 0;
+  case Type::INT32:
+    return 1;
+  case Type::INT64:
+    return 2;
+  case Type::FLOAT:
+    return 4;
+  case Type::DOUBLE:
+    return 5;
+  case Type::BYTE_ARRAY:
+    return 6;
+  case Type::FIXED_LEN_BYTE_ARRAY:
+    return 7;
+  }
+  return 0;
+}
+
+static Type FromThriftType(int32_t type) {
+  switch (type) {
+  case 0:
+    return Type::BOOLEAN;
+  case 1:
+    return Type::INT32;
+  case 2:
+    return Type::INT64;
+  case 4:
+    return Type::FLOAT;
+  case 5:
+    return Type::DOUBLE;
+  case 6:
+    return Type::BYTE_ARRAY;
+  case 7:
+    return Type::FIXED_LEN_BYTE_ARRAY;
+  }
+  throw std::runtime_error("Unsupported Parquet physical type " +
+                           std::to_string(type));
+}
+
+static void WriteDataPageHeader(ThriftCompactWriter &w,
+                                const DataPageHeader &header) {
+  w.WriteFieldI32(1, header.num_values);
+  w.WriteFieldI32(2, static_cast<int32_t>(header.encoding));
+  w.WriteFieldI32(3, static_cast<int32_t>(header.definition_level_encoding));
+  w.WriteFieldI32(4, static_cast<int32_t>(header.repetition_level_encoding));
+}
+
+void SerializePageHeader(const PageHeader &header, std::vector<uint8_t> *out) {
+  ThriftCompactWriter w(out);
+  w.BeginStruct();
+  w.WriteFieldI32(1, static_cast<int32_t>(header.type));
+  w.WriteFieldI32(2, header.uncompressed_page_size);
+  w.WriteFieldI32(3, header.compressed_page_size);
+  if (header.crc)
+    w.WriteFieldI32(4, *header.crc);
+  w.WriteFieldStructBegin(5);
+  WriteDataPageHeader(w, header.data_page_header);
+  w.EndStruct();
+  w.EndStruct();
+}
+
+// Legacy ConvertedType (parquet.thrift) for readers that predate
+// LogicalType; 0 when there is none.
+static int32_t ToConvertedType(const LogicalType &t) {
+  switch (t.kind) {
+  case LogicalType::Kind::kDecimal:
+    return 5;
+  case LogicalType::Kind::kDate:
+    return 6;
+  case LogicalType::Kind::kTimestamp:
+    if (!t.adjusted_to_utc || t.unit == TimeUnit::kNanos)
+      return 0;
+    return t.unit == TimeUnit::kMillis ? 9 : 10;
+  case LogicalType::Kind::kInt:
+    if (t.bit_width == 8)
+      return t.is_signed ? 15 : 11;
+    return t.is_signed ? 16 : 12;
+  default:
+    return 0;
+  }
+}
+
+static LogicalType FromConvertedType(int32_t converted, int32_t precision,
+                                     int32_t scale) {
+  switch (converted) {
+  case 5:
+    return LogicalType::Decimal(precision, scale);
+  case 6:
+    return LogicalType::Date();
+  case 9:
+    return LogicalType::Timestamp(TimeUnit::kMillis);
+  case 10:
+    return LogicalType::Timestamp(TimeUnit::kMicros);
+  case 11:
+    return LogicalType::Int(8, false);
+  case 12:
+    return LogicalType::Int(16, false);
+  case 15:
+    return LogicalType::Int(8);
+  case 16:
+    return LogicalType::Int(16);
+  default:
+    return LogicalType();
+  }
+}
+
+// LogicalType union member, as field 10 of the SchemaElement.
+static void WriteLogicalType(ThriftCompactWriter &w, const LogicalType &t) {
+  w.WriteFieldStructBegin(10);
+  switch (t.kind) {
+  case LogicalType::Kind::kDecimal:
+    w.WriteFieldStructBegin(5);
+    w.WriteFieldI32(1, t.scale);
+    w.WriteFieldI32(2, t.precision);
+    w.EndStruct();
+    break;
+  case LogicalType::Kind::kDate:
+    w.WriteFieldStructBegin(6);
+    w.EndStruct();
+    break;
+  case LogicalType::Kind::kTimestamp:
+    w.WriteFieldStructBegin(8);
+    w.WriteFieldBool(1, t.adjusted_to_utc);
+    w.WriteFieldStructBegin(2); // TimeUnit union
+    w.WriteFieldStructBegin(static_cast<int16_t>(t.unit) + 1);
+    w.EndStruct();
+    w.EndStruct();
+    w.EndStruct();
+    break;
+  case LogicalType::Kind::kInt:
+    w.WriteFieldStructBegin(10);
+    w.WriteFieldI8(1, static_cast<int8_t>(t.bit_width));
+    w.WriteFieldBool(2, t.is_signed);
+    w.EndStruct();
+    break;
+  case LogicalType::Kind::kUuid:
+    w.WriteFieldStructBegin(14);
+    w.EndStruct();
+    break;
+  case LogicalType::Kind::kNone:
+    break;
+  }
+  w.EndStruct();
+}
+
+static void WriteSchemaElements(ThriftCompactWriter &w,
+                                const std::vector<ColumnSchema> &columns) {
+  w.WriteFieldListBegin(2, ThriftType::STRUCT,
+                        static_cast<int32_t>(columns.size() + 1));
+  // Root group node
+  w.BeginStruct();
+  w.WriteFieldString(4, "schema");
+  w.WriteFieldI32(5, static_cast<int32_t>(columns.size()));
+  w.EndStruct();
+
+  for (const auto &col : columns) {
+    w.BeginStruct();
+    w.WriteFieldI32(1, ToThriftType(col.type));
+    if (col.type == Type::FIXED_LEN_BYTE_ARRAY)
+      w.WriteFieldI32(2, col.type_length);
+    w.WriteFieldI32(3, col.nullable ? 1 : 0); // OPTIONAL : REQUIRED
+    w.WriteFieldString(4, col.name);
+    const LogicalType &logical = col.logical_type;
+    if (int32_t converted = ToConvertedType(logical))
+      w.WriteFieldI32(6, converted);
+    if (logical.kind == LogicalType::Kind::kDecimal) {
+      w.WriteFieldI32(7, logical.scale);
+      w.WriteFieldI32(8, logical.precision);
+    }
+    if (logical.kind != LogicalType::Kind::kNone)
+      WriteLogicalType(w, logical);
+    w.EndStruct();
+  }
+}
+
+static void WriteColumnChunk(ThriftCompactWriter &w,
+                             const ColumnChunkMetaData &col) {
+  w.BeginStruct();
+  // ColumnChunk.file_offset points at the column metadata in old writers;
+  // modern readers ignore it, so we record the first page offset.
+  w.WriteFieldI64(2, col.data_page_offset);
+  w.WriteFieldStructBegin(3);
+  w.WriteFieldI32(1, ToThriftType(col.type));
+  w.WriteFieldListBegin(2, ThriftType::I32,
+                        static_cast<int32_t>(col.encodings.size()));
+  for (Encoding e : col.encodings)
+    w.WriteI32(static_cast<int32_t>(e));
+  w.WriteFieldListBegin(3, ThriftType::BINARY,
+                        static_cast<int32_t>(col.path_in_schema.size()));
+  for (const auto &p : col.path_in_schema)
+    w.WriteString(p);
+  w.WriteFieldI32(4, static_cast<int32_t>(col.codec));
+  w.WriteFieldI64(5, col.num_values);
+  w.WriteFieldI64(6, col.total_uncompressed_size);
+  w.WriteFieldI64(7, col.total_compressed_size);
+  w.WriteFieldI64(9, col.data_page_offset);
+  if (col.dictionary_page_offset)
+    w.WriteFieldI64(11, *col.dictionary_page_offset);
+  if (col.statistics) {
+    const Statistics &stats = *col.statistics;
+    w.WriteFieldStructBegin(12);
+    if (stats.null_count)
+      w.WriteFieldI64(3, *stats.null_count);
+    if (stats.max_value)
+      w.WriteFieldString(5, *stats.max_value);
+    if (stats.min_value)
+      w.WriteFieldString(6, *stats.min_value);
+    w.EndStruct();
+  }
+  if (col.bloom_filter_offset) {
+    w.WriteFieldI64(14, *col.bloom_filter_offset);
+    if (col.bloom_filter_length)
+      w.WriteFieldI32(15, *col.bloom_filter_length);
+  }
+  w.EndStruct(); // ColumnMetaData
+  if (col.offset_index_offset) {
+    w.WriteFieldI64(4, *col.offset_index_offset);
+    w.WriteFieldI32(5, col.offset_index_length.value_or(0));
+  }
+  if (col.column_index_offset) {
+    w.WriteFieldI64(6, *col.column_index_offset);
+    w.WriteFieldI32(7, col.column_index_length.value_or(0));
+  }
+  w.EndStruct(); // ColumnChunk
+}
+
+void SerializeFileMetaData(const FileMetaData &metadata,
+                           std::vector<uint8_t> *out) {
+  ThriftCompactWriter w(out);
+  w.BeginStruct();
+  w.WriteFieldI32(1, metadata.version);
+  WriteSchemaElements(w, metadata.schema);
+  w.WriteFieldI64(3, metadata.num_rows);
+  w.WriteFieldListBegin(4, ThriftType::STRUCT,
+                        static_cast<int32_t>(metadata.row_groups.size()));
+  for (const auto &rg : metadata.row_groups) {
+    w.BeginStruct();
+    w.WriteFieldListBegin(1, ThriftType::STRUCT,
+                          static_cast<int32_t>(rg.columns.size()));
+    for (const auto &col : rg.columns)
+      WriteColumnChunk(w, col);
+    w.WriteFieldI64(2, rg.total_byte_size);
+    w.WriteFieldI64(3, rg.num_rows);
+    if (!rg.sorting_columns.empty()) {
+      w.WriteFieldListBegin(4, ThriftType::STRUCT,
+                            static_cast<int32_t>(rg.sorting_columns.size()));
+      for (const auto &sc : rg.sorting_columns) {
+        w.BeginStruct();
+        w.WriteFieldI32(1, sc.column_idx);
+        w.WriteFieldBool(2, sc.descending);
+        w.WriteFieldBool(3, sc.nulls_first);
+        w.EndStruct();
+      }
+    }
+    w.WriteFieldI64(5, rg.file_offset);
+    w.WriteFieldI64(6, rg.total_compressed_size);
+    w.WriteFieldI16(7, rg.ordinal);
+    w.EndStruct();
+  }
+  w.WriteFieldString(6, metadata.created_by);
+  // TypeDefinedOrder for every column; without it readers ignore
+  // Statistics.min_value / max_value.
+  w.WriteFieldListBegin(7, ThriftType::STRUCT,
+                        static_cast<int32_t>(metadata.schema.size()));
+  for (size_t i = 0; i < metadata.schema.size(); ++i) {
+    w.BeginStruct();
+    w.WriteFieldStructBegin(1);
+    w.EndStruct();
+    w.EndStruct();
+  }
+  w.EndStruct();
+}
+
+void SerializeColumnIndex(const ColumnIndex &index, std::vector<uint8_t> *out) {
+  ThriftCompactWriter w(out);
+  w.BeginStruct();
+  w.WriteFieldListBegin(1, ThriftType::BOOL_TRUE,
+                        static_cast<int32_t>(index.null_pages.size()));
+  for (bool null_page : index.null_pages)
+    w.WriteBool(null_page);
+  w.WriteFieldListBegin(2, ThriftType::BINARY,
+                        static_cast<int32_t>(index.min_values.size()));
+  for (const auto &v : index.min_values)
+    w.WriteString(v);
+  w.WriteFieldListBegin(3, ThriftType::BINARY,
+                        static_cast<int32_t>(index.max_values.size()));
+  for (const auto &v : index.max_values)
+    w.WriteString(v);
+  w.WriteFieldI32(4, static_cast<int32_t>(index.boundary_order));
+  if (!index.null_counts.empty()) {
+    w.WriteFieldListBegin(5, ThriftType::I64,
+                          static_cast<int32_t>(index.null_counts.size()));
+    for (int64_t n : index.null_counts)
+      w.WriteI64(n);
+  }
+  w.EndStruct();
+}
+
+void SerializeOffsetIndex(const OffsetIndex &index, std::vector<uint8_t> *out) {
+  ThriftCompactWriter w(out);
+  w.BeginStruct();
+  w.WriteFieldListBegin(1, ThriftType::STRUCT,
+                        static_cast<int32_t>(index.page_locations.size()));
+  for (const auto &loc : index.page_locations) {
+    w.BeginStruct();
+    w.WriteFieldI64(1, loc.offset);
+    w.WriteFieldI32(2, loc.compressed_page_size);
+    w.WriteFieldI64(3, loc.first_row_index);
+    w.EndStruct();
+  }
+  w.EndStruct();
+}
+
+void SerializeBloomFilterHeader(int32_t num_bytes, std::vector<uint8_t> *out) {
+  ThriftCompactWriter w(out);
+  w.BeginStruct();
+  w.WriteFieldI32(1, num_bytes);
+  // algorithm, hash and compression are unions of empty structs
+  for (int16_t id = 2; id <= 4; ++id) {
+    w.WriteFieldStructBegin(id);
+    w.WriteFieldStructBegin(1);
+    w.EndStruct();
+    w.EndStruct();
+  }
+  w.EndStruct();
+}
+
+// Reads the fields of the struct the reader is positioned at; `field` is
+// called for each one and must consume its value.
+template <typename FieldFn>
+static void ReadStruct(ThriftCompactReader &r, FieldFn &&field) {
+  r.BeginStruct();
+  int16_t id;
+  ThriftType type;
+  while (r.ReadFieldHeader(&id, &type))
+    field(id, type);
+  r.EndStruct();
+}
+
+template <typename ElemFn>
+static void ReadList(ThriftCompactReader &r, ElemFn &&elem) {
+  ThriftType elem_type;
+  int32_t size;
+  r.ReadListBegin(&elem_type, &size);
+  for (int32_t i = 0; i < size; ++i)
+    elem(elem_type);
+}
+
+static Statistics ReadStatistics(ThriftCompactReader &r) {
+  Statistics stats;
+  std::optional<std::string> legacy_min, legacy_max;
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 1:
+      legacy_max = r.ReadString();
+      break;
+    case 2:
+      legacy_min = r.ReadString();
+      break;
+    case 3:
+      stats.null_count = r.ReadI64();
+      break;
+    case 5:
+      stats.max_value = r.ReadString();
+      break;
+    case 6:
+      stats.min_value = r.ReadString();
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+  // Legacy bounds use signed comparison, which is correct for every
+  // physical type hpq reads.
+  if (!stats.min_value && !stats.max_value) {
+    stats.min_value = legacy_min;
+    stats.max_value = legacy_max;
+  }
+  return stats;
+}
+
+static void ReadDataPageHeader(ThriftCompactReader &r, DataPageHeader *dph) {
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 1:
+      dph->num_values = r.ReadI32();
+      break;
+    case 2:
+      dph->encoding = static_cast<Encoding>(r.ReadI32());
+      break;
+    case 3:
+      dph->definition_level_encoding = static_cast<Encoding>(r.ReadI32());
+      break;
+    case 4:
+      dph->repetition_level_encoding = static_cast<Encoding>(r.ReadI32());
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+}
+
+size_t ParsePageHeader(const uint8_t *data, size_t size, PageHeader *header) {
+  ThriftCompactReader r(data, size);
+  *header = PageHeader();
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 1:
+      header->type = static_cast<PageType>(r.ReadI32());
+      break;
+    case 2:
+      header->uncompressed_page_size = r.ReadI32();
+      break;
+    case 3:
+      header->compressed_page_size = r.ReadI32();
+      break;
+    case 4:
+      header->crc = r.ReadI32();
+      break;
+    case 5:
+      ReadDataPageHeader(r, &header->data_page_header);
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+  return r.bytes_read();
+}
+
+static ColumnChunkMetaData ReadColumnChunk(ThriftCompactReader &r) {
+  ColumnChunkMetaData col;
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 3:
+      ReadStruct(r, [&](int16_t mid, ThriftType mtype) {
+        switch (mid) {
+        case 1:
+          col.type = FromThriftType(r.ReadI32());
+          break;
+        case 2:
+          ReadList(r, [&](ThriftType) {
+            col.encodings.push_back(static_cast<Encoding>(r.ReadI32()));
+          });
+          break;
+        case 3:
+          ReadList(r, [&](ThriftType) {
+            col.path_in_schema.push_back(r.ReadString());
+          });
+          break;
+        case 4:
+          col.codec = static_cast<Codec>(r.ReadI32());
+          break;
+        case 5:
+          col.num_values = r.ReadI64();
+          break;
+        case 6:
+          col.total_uncompressed_size = r.ReadI64();
+          break;
+        case 7:
+          col.total_compressed_size = r.ReadI64();
+          break;
+        case 9:
+          col.data_page_offset = r.ReadI64();
+          break;
+        case 11:
+          col.dictionary_page_offset = r.ReadI64();
+          break;
+        case 12:
+          col.statistics = ReadStatistics(r);
+          break;
+        case 14:
+          col.bloom_filter_offset = r.ReadI64();
+          break;
+        case 15:
+          col.bloom_filter_length = r.ReadI32();
+          break;
+        default:
+          r.Skip(mtype);
+        }
+      });
+      break;
+    case 4:
+      col.offset_index_offset = r.ReadI64();
+      break;
+    case 5:
+      col.offset_index_length = r.ReadI32();
+      break;
+    case 6:
+      col.column_index_offset = r.ReadI64();
+      break;
+    case 7:
+      col.column_index_length = r.ReadI32();
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+  return col;
+}
+
+static RowGroupMetaData ReadRowGroup(ThriftCompactReader &r) {
+  RowGroupMetaData rg;
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 1:
+      ReadList(r,
+               [&](ThriftType) { rg.columns.push_back(ReadColumnChunk(r)); });
+      break;
+    case 2:
+      rg.total_byte_size = r.ReadI64();
+      break;
+    case 3:
+      rg.num_rows = r.ReadI64();
+      break;
+    case 4:
+      ReadList(r, [&](ThriftType) {
+        SortingColumn &sc = rg.sorting_columns.emplace_back();
+        ReadStruct(r, [&](int16_t sid, ThriftType stype) {
+          switch (sid) {
+          case 1:
+            sc.column_idx = r.ReadI32();
+            break;
+          case 2:
+            sc.descending = ThriftCompactReader::FieldBool(stype);
+            break;
+          case 3:
+            sc.nulls_first = ThriftCompactReader::FieldBool(stype);
+            break;
+          default:
+            r.Skip(stype);
+          }
+        });
+      });
+      break;
+    case 5:
+      rg.file_offset = r.ReadI64();
+      break;
+    case 6:
+      rg.total_compressed_size = r.ReadI64();
+      break;
+    case 7:
+      rg.ordinal = r.ReadI16();
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+  return rg;
+}
+
+static LogicalType ReadLogicalType(ThriftCompactReader &r) {
+  LogicalType t;
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 5:
+      t.kind = LogicalType::Kind::kDecimal;
+      ReadStruct(r, [&](int16_t fid, ThriftType ftype) {
+        if (fid == 1)
+          t.scale = r.ReadI32();
+        else if (fid == 2)
+          t.precision = r.ReadI32();
+        else
+          r.Skip(ftype);
+      });
+      break;
+    case 6:
+      t.kind = LogicalType::Kind::kDate;
+      r.Skip(type);
+      break;
+    case 8:
+      t.kind = LogicalType::Kind::kTimestamp;
+      ReadStruct(r, [&](int16_t fid, ThriftType ftype) {
+        if (fid == 1) {
+          t.adjusted_to_utc = ThriftCompactReader::FieldBool(ftype);
+        } else if (fid == 2) {
+          ReadStruct(r, [&](int16_t uid, ThriftType utype) {
+            if (uid >= 1 && uid <= 3)
+              t.unit = static_cast<TimeUnit>(uid - 1);
+            r.Skip(utype);
+          });
+        } else {
+          r.Skip(ftype);
+        }
+      });
+      break;
+    case 10:
+      t.kind = LogicalType::Kind::kInt;
+      ReadStruct(r, [&](int16_t fid, ThriftType ftype) {
+        if (fid == 1)
+          t.bit_width = r.ReadI8();
+        else if (fid == 2)
+          t.is_signed = ThriftCompactReader::FieldBool(ftype);
+        else
+          r.Skip(ftype);
+      });
+      break;
+    case 14:
+      t.kind = LogicalType::Kind::kUuid;
+      r.Skip(type);
+      break;
+    default: // Annotations hpq does not model
+      r.Skip(type);
+    }
+  });
+  return t;
+}
+
+// Flat schemas only: group nodes (the root) are dropped, leaves become
+// columns.
+static void ReadSchemaElement(ThriftCompactReader &r,
+                              std::vector<ColumnSchema> *columns) {
+  ColumnSchema col;
+  col.nullable = false; // REQUIRED unless stated
+  std::optional<int32_t> type;
+  int32_t num_children = 0;
+  int32_t converted = 0, scale = 0, precision = 0;
+  ReadStruct(r, [&](int16_t id, ThriftType ftype) {
+    switch (id) {
+    case 1:
+      type = r.ReadI32();
+      break;
+    case 2:
+      col.type_length = r.ReadI32();
+      break;
+    case 3:
+      col.nullable = r.ReadI32() == 1; // OPTIONAL
+      break;
+    case 4:
+      col.name = r.ReadString();
+      break;
+    case 5:
+      num_children = r.ReadI32();
+      break;
+    case 6:
+      converted = r.ReadI32();
+      break;
+    case 7:
+      scale = r.ReadI32();
+      break;
+    case 8:
+      precision = r.ReadI32();
+      break;
+    case 10:
+      col.logical_type = ReadLogicalType(r);
+      break;
+    default:
+      r.Skip(ftype);
+    }
+  });
+  if (num_children > 0 || !type)
+    return;
+  if (col.logical_type.kind == LogicalType::Kind::kNone)
+    col.logical_type = FromConvertedType(converted, precision, scale);
+  col.type = FromThriftType(*type);
+  columns->push_back(std::move(col));
+}
+
+FileMetaData ParseFileMetaData(const uint8_t *data, size_t size) {
+  ThriftCompactReader r(data, size);
+  FileMetaData metadata;
+  metadata.created_by.clear();
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 1:
+      metadata.version = r.ReadI32();
+      break;
+    case 2:
+      ReadList(r,
+               [&](ThriftType) { ReadSchemaElement(r, &metadata.schema); });
+      break;
+    case 3:
+      metadata.num_rows = r.ReadI64();
+      break;
+    case 4:
+      ReadList(r, [&](ThriftType) {
+        metadata.row_groups.push_back(ReadRowGroup(r));
+      });
+      break;
+    case 6:
+      metadata.created_by = r.ReadString();
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+  return metadata;
+}
+
+ColumnIndex ParseColumnIndex(const uint8_t *data, size_t size) {
+  ThriftCompactReader r(data, size);
+  ColumnIndex index;
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    switch (id) {
+    case 1:
+      ReadList(r,
+               [&](ThriftType) { index.null_pages.push_back(r.ReadBool()); });
+      break;
+    case 2:
+      ReadList(r,
+               [&](ThriftType) { index.min_values.push_back(r.ReadString()); });
+      break;
+    case 3:
+      ReadList(r,
+               [&](ThriftType) { index.max_values.push_back(r.ReadString()); });
+      break;
+    case 4:
+      index.boundary_order = static_cast<BoundaryOrder>(r.ReadI32());
+      break;
+    case 5:
+      ReadList(r,
+               [&](ThriftType) { index.null_counts.push_back(r.ReadI64()); });
+      break;
+    default:
+      r.Skip(type);
+    }
+  });
+  if (index.min_values.size() != index.null_pages.size() ||
+      index.max_values.size() != index.null_pages.size())
+    throw std::runtime_error("Inconsistent column index");
+  return index;
+}
+
+OffsetIndex ParseOffsetIndex(const uint8_t *data, size_t size) {
+  ThriftCompactReader r(data, size);
+  OffsetIndex index;
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    if (id != 1) {
+      r.Skip(type);
+      return;
+    }
+    ReadList(r, [&](ThriftType) {
+      PageLocation loc;
+      ReadStruct(r, [&](int16_t lid, ThriftType ltype) {
+        switch (lid) {
+        case 1:
+          loc.offset = r.ReadI64();
+          break;
+        case 2:
+          loc.compressed_page_size = r.ReadI32();
+          break;
+        case 3:
+          loc.first_row_index = r.ReadI64();
+          break;
+        default:
+          r.Skip(ltype);
+        }
+      });
+      index.page_locations.push_back(loc);
+    });
+  });
+  return index;
+}
+
+size_t ParseBloomFilterHeader(const uint8_t *data, size_t size,
+                              int32_t *num_bytes) {
+  ThriftCompactReader r(data, size);
+  *num_bytes = -1;
+  // Only split block / xxHash64 / uncompressed exist in the format today, so
+  // the union fields are skipped rather than checked.
+  ReadStruct(r, [&](int16_t id, ThriftType type) {
+    if (id == 1)
+      *num_bytes = r.ReadI32();
+    else
+      r.Skip(type);
+  });
+  if (*num_bytes < 0)
+    throw std::runtime_error("Bloom filter header without size");
+  return r.bytes_read();
+}
+
+} // namespace hpq
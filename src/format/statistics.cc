@@ -0,0 +1,62 @@
+#include "hpq/format/statistics.h"
+#include "hpq/type_traits.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace hpq {
+
+template <typename T> static std::string EncodeValue(T value) {
+  return std::string(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> static T DecodeValue(const std::string &bytes) {
+  if (bytes.size() != sizeof(T))
+    throw std::runtime_error("Statistics value has the wrong size");
+  T value;
+  std::memcpy(&value, bytes.data(), sizeof(T));
+  return value;
+}
+
+bool ComputeMinMax(Type type, const void *values, size_t n, std::string *min,
+                   std::string *max) {
+  return VisitFixedWidthType(type, [&](auto dtype) {
+    using T = typename decltype(dtype)::c_type;
+    const T *v = static_cast<const T *>(values);
+    size_t i = 0;
+    if constexpr (std::is_floating_point_v<T>) {
+      while (i < n && std::isnan(v[i]))
+        ++i;
+    }
+    if (i == n)
+      return false;
+
+    T lo = v[i];
+    T hi = v[i];
+    for (; i < n; ++i) {
+      // NaN fails both comparisons, so it never becomes a bound.
+      lo = v[i] < lo ? v[i] : lo;
+      hi = v[i] > hi ? v[i] : hi;
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+      if (lo == 0)
+        lo = -T(0);
+      if (hi == 0)
+        hi = T(0);
+    }
+    *min = EncodeValue(lo);
+    *max = EncodeValue(hi);
+    return true;
+  });
+}
+
+int CompareValues(Type type, const std::string &a, const std::string &b) {
+  return VisitFixedWidthType(type, [&](auto dtype) {
+    using T = typename decltype(dtype)::c_type;
+    T x = DecodeValue<T>(a);
+    T y = DecodeValue<T>(b);
+    return x < y ? -1 : (y < x ? 1 : 0);
+  });
+}
+
+} // namespace hpq
@@ -0,0 +1,263 @@
+#include "hpq/format/thrift_compact.h"
+#include <stdexcept>
+
+namespace hpq {
+
+static uint64_t ZigZag64(int64_t n) {
+  return (static_cast<uint64_t>(n) << 1) ^ static_cast<uint64_t>(n >> 63);
+}
+
+void ThriftCompactWriter::WriteVarint(uint64_t value) {
+  while (value >= 0x80) {
+    out_->push_back(static_cast<uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  out_->push_back(static_cast<uint8_t>(value));
+}
+
+void ThriftCompactWriter::WriteFieldHeader(int16_t id, ThriftType type) {
+  int delta = id - last_field_;
+  if (delta > 0 && delta <= 15) {
+    out_->push_back(static_cast<uint8_t>((delta << 4) |
+                                         static_cast<uint8_t>(type)));
+  } else {
+    out_->push_back(static_cast<uint8_t>(type));
+    WriteVarint(ZigZag64(id));
+  }
+  last_field_ = id;
+}
+
+void ThriftCompactWriter::BeginStruct() {
+  last_field_stack_.push_back(last_field_);
+  last_field_ = 0;
+}
+
+void ThriftCompactWriter::EndStruct() {
+  out_->push_back(static_cast<uint8_t>(ThriftType::STOP));
+  last_field_ = last_field_stack_.back();
+  last_field_stack_.pop_back();
+}
+
+void ThriftCompactWriter::WriteFieldBool(int16_t id, bool value) {
+  WriteFieldHeader(id, value ? ThriftType::BOOL_TRUE : ThriftType::BOOL_FALSE);
+}
+
+void ThriftCompactWriter::WriteFieldI8(int16_t id, int8_t value) {
+  WriteFieldHeader(id, ThriftType::BYTE);
+  out_->push_back(static_cast<uint8_t>(value));
+}
+
+void ThriftCompactWriter::WriteFieldI16(int16_t id, int16_t value) {
+  WriteFieldHeader(id, ThriftType::I16);
+  WriteVarint(ZigZag64(value));
+}
+
+void ThriftCompactWriter::WriteFieldI32(int16_t id, int32_t value) {
+  WriteFieldHeader(id, ThriftType::I32);
+  WriteI32(value);
+}
+
+void ThriftCompactWriter::WriteFieldI64(int16_t id, int64_t value) {
+  WriteFieldHeader(id, ThriftType::I64);
+  WriteI64(value);
+}
+
+void ThriftCompactWriter::WriteFieldBinary(int16_t id, const void *data,
+                                           size_t size) {
+  WriteFieldHeader(id, ThriftType::BINARY);
+  WriteBinary(data, size);
+}
+
+void ThriftCompactWriter::WriteFieldStructBegin(int16_t id) {
+  WriteFieldHeader(id, ThriftType::STRUCT);
+  BeginStruct();
+}
+
+void ThriftCompactWriter::WriteFieldListBegin(int16_t id, ThriftType elem_type,
+                                              int32_t size) {
+  WriteFieldHeader(id, ThriftType::LIST);
+  WriteListBegin(elem_type, size);
+}
+
+void ThriftCompactWriter::WriteBool(bool value) {
+  out_->push_back(static_cast<uint8_t>(value ? ThriftType::BOOL_TRUE
+                                             : ThriftType::BOOL_FALSE));
+}
+
+void ThriftCompactWriter::WriteI32(int32_t value) { WriteVarint(ZigZag64(value)); }
+
+void ThriftCompactWriter::WriteI64(int64_t value) { WriteVarint(ZigZag64(value)); }
+
+void ThriftCompactWriter::WriteBinary(const void *data, size_t size) {
+  WriteVarint(size);
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  out_->insert(out_->end(), bytes, bytes + size);
+}
+
+void ThriftCompactWriter::WriteListBegin(ThriftType elem_type, int32_t size) {
+  if (size < 15) {
+    out_->push_back(
+        static_cast<uint8_t>((size << 4) | static_cast<uint8_t>(elem_type)));
+  } else {
+    out_->push_back(static_cast<uint8_t>(0xF0 | static_cast<uint8_t>(elem_type)));
+    WriteVarint(static_cast<uint64_t>(size));
+  }
+}
+
+static int64_t ZigZagDecode64(uint64_t n) {
+  return static_cast<int64_t>(n >> 1) ^ -static_cast<int64_t>(n & 1);
+}
+
+uint8_t ThriftCompactReader::ReadByte() {
+  if (pos_ >= end_)
+    throw std::runtime_error("Truncated Thrift data");
+  return *pos_++;
+}
+
+uint64_t ThriftCompactReader::ReadVarint() {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    uint8_t b = ReadByte();
+    value |= static_cast<uint64_t>(b & 0x7F) << shift;
+    if (!(b & 0x80))
+      return value;
+  }
+  throw std::runtime_error("Malformed Thrift varint");
+}
+
+void ThriftCompactReader::BeginStruct() {
+  last_field_stack_.push_back(last_field_);
+  last_field_ = 0;
+}
+
+void ThriftCompactReader::EndStruct() {
+  last_field_ = last_field_stack_.back();
+  last_field_stack_.pop_back();
+}
+
+bool ThriftCompactReader::ReadFieldHeader(int16_t *id, ThriftType *type) {
+  uint8_t header = ReadByte();
+  *type = static_cast<ThriftType>(header & 0x0F);
+  if (*type == ThriftType::STOP)
+    return false;
+  int delta = header >> 4;
+  if (delta != 0)
+    last_field_ = static_cast<int16_t>(last_field_ + delta);
+  else
+    last_field_ = static_cast<int16_t>(ZigZagDecode64(ReadVarint()));
+  *id = last_field_;
+  return true;
+}
+
+bool ThriftCompactReader::ReadBool() {
+  return ReadByte() == static_cast<uint8_t>(ThriftType::BOOL_TRUE);
+}
+
+int8_t ThriftCompactReader::ReadI8() {
+  return static_cast<int8_t>(ReadByte());
+}
+
+int16_t ThriftCompactReader::ReadI16() {
+  return static_cast<int16_t>(ZigZagDecode64(ReadVarint()));
+}
+
+int32_t ThriftCompactReader::ReadI32() {
+  return static_cast<int32_t>(ZigZagDecode64(ReadVarint()));
+}
+
+int64_t ThriftCompactReader::ReadI64() { return ZigZagDecode64(ReadVarint()); }
+
+std::string ThriftCompactReader::ReadString() {
+  uint64_t size = ReadVarint();
+  if (size > static_cast<uint64_t>(end_ - pos_))
+    throw std::runtime_error("Truncated Thrift data");
+  std::string value(reinterpret_cast<const char *>(pos_), size);
+  pos_ += size;
+  return value;
+}
+
+void ThriftCompactReader::ReadListBegin(ThriftType *elem_type,
+                                        int32_t *size) {
+  uint8_t header = ReadByte();
+  *elem_type = static_cast<ThriftType>(header & 0x0F);
+  uint64_t n = header >> 4;
+  if (n == 15)
+    n = ReadVarint();
+  // Every element takes at least one byte, which bounds corrupt sizes.
+  if (n > static_cast<uint64_t>(end_ - pos_))
+    throw std::runtime_error("Truncated Thrift list");
+  *size = static_cast<int32_t>(n);
+}
+
+void ThriftCompactReader::Skip(ThriftType type) { SkipDepth(type, 0); }
+
+// Container elements have no field header, so bools take a byte of their own.
+void ThriftCompactReader::SkipElement(ThriftType type, int depth) {
+  if (type == ThriftType::BOOL_TRUE || type == ThriftType::BOOL_FALSE)
+    ReadByte();
+  else
+    SkipDepth(type, depth);
+}
+
+void ThriftCompactReader::SkipDepth(ThriftType type, int depth) {
+  if (depth > 64)
+    throw std::runtime_error("Thrift nesting too deep");
+  switch (type) {
+  case ThriftType::BOOL_TRUE:
+  case ThriftType::BOOL_FALSE:
+    return; // Value is in the field header
+  case ThriftType::BYTE:
+    ReadByte();
+    return;
+  case ThriftType::I16:
+  case ThriftType::I32:
+  case ThriftType::I64:
+    ReadVarint();
+    return;
+  case ThriftType::DOUBLE:
+    if (end_ - pos_ < 8)
+      throw std::runtime_error("Truncated Thrift data");
+    pos_ += 8;
+    return;
+  case ThriftType::BINARY: {
+    uint64_t size = ReadVarint();
+    if (size > static_cast<uint64_t>(end_ - pos_))
+      throw std::runtime_error("Truncated Thrift data");
+    pos_ += size;
+    return;
+  }
+  case ThriftType::LIST:
+  case ThriftType::SET: {
+    ThriftType elem;
+    int32_t size;
+    ReadListBegin(&elem, &size);
+    for (int32_t i = 0; i < size; ++i)
+      SkipElement(elem, depth + 1);
+    return;
+  }
+  case ThriftType::MAP: {
+    uint64_t size = ReadVarint();
+    if (size == 0)
+      return;
+    uint8_t types = ReadByte();
+    for (uint64_t i = 0; i < size; ++i) {
+      SkipElement(static_cast<ThriftType>(types >> 4), depth + 1);
+      SkipElement(static_cast<ThriftType>(types & 0x0F), depth + 1);
+    }
+    return;
+  }
+  case ThriftType::STRUCT: {
+    BeginStruct();
+    int16_t id;
+    ThriftType field;
+    while (ReadFieldHeader(&id, &field))
+      SkipDepth(field, depth + 1);
+    EndStruct();
+    return;
+  }
+  default:
+    throw std::runtime_error("Unknown Thrift type");
+  }
+}
+
+} // namespace hpq
@@ -1,12 +1,105 @@
 #include "hpq/gpu/gpu_compress.h"
+#include "hpq/util/thread_pool.h"
+#include "hpq/writer/page.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace hpq {
 
+#ifndef HPQ_USE_CUDA
 size_t CompressGPU(const uint8_t *input, size_t input_size, uint8_t *output,
                    size_t output_capacity) {
-  // Fallback implementation (no-op)
-  // In a real scenario, we might fallback to CPU compression (Snappy/LZ4) here.
+  // Fallback implementation (no-op); CPU compression goes through
+  // MakeCpuCompressBackend().
   return 0;
 }
+#endif
+
+namespace {
+
+// One CompressBatch() call. Shared with the pool tasks, which may start
+// after the caller has already finished every page.
+class CpuBatch {
+public:
+  CpuBatch(std::span<Page> pages, CodecSelector *codecs)
+      : pages_(pages), codecs_(codecs) {}
+
+  // Compresses pages until none are left unclaimed.
+  void Run() {
+    thread_local std::vector<uint8_t> scratch;
+    size_t finished = 0;
+    std::exception_ptr error;
+    for (size_t i; (i = next_.fetch_add(1)) < pages_.size(); ++finished) {
+      try {
+        CompressPage(codecs_, &pages_[i], &scratch);
+      } catch (...) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+    if (finished == 0)
+      return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ += finished;
+    if (error && !error_)
+      error_ = error;
+    if (done_ == pages_.size())
+      all_done_.notify_all();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    all_done_.wait(lock, [this] { return done_ == pages_.size(); });
+    if (error_)
+      std::rethrow_exception(error_);
+  }
+
+private:
+  std::span<Page> pages_;
+  CodecSelector *codecs_;
+  std::atomic<size_t> next_{0};
+  std::mutex mutex_;
+  std::condition_variable all_done_;
+  size_t done_ = 0;
+  std::exception_ptr error_;
+};
+
+class CpuCompressBackend final : public CompressBackend {
+public:
+  explicit CpuCompressBackend(int num_threads) {
+    if (num_threads <= 0)
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (num_threads > 1)
+      pool_ = std::make_unique<ThreadPool>(num_threads - 1);
+  }
+
+  void CompressBatch(std::span<Page> pages, CodecSelector *codecs) override {
+    if (pages.empty())
+      return;
+    auto batch = std::make_shared<CpuBatch>(pages, codecs);
+    // The caller works on the batch too, so it always makes progress even
+    // when other writers' batches occupy the pool.
+    size_t helpers = pool_ ? std::min<size_t>(pool_->num_threads(),
+                                              pages.size() - 1)
+                           : 0;
+    for (size_t i = 0; i < helpers; ++i)
+      pool_->Submit([batch] { batch->Run(); });
+    batch->Run();
+    batch->Wait();
+  }
+
+private:
+  std::unique_ptr<ThreadPool> pool_;
+};
+
+} // namespace
+
+std::unique_ptr<CompressBackend> MakeCpuCompressBackend(int num_threads) {
+  return std::make_unique<CpuCompressBackend>(num_threads);
+}
 
 } // namespace hpq
@@ -1,3 +1,33 @@
+#include "hpq/io/output_stream.h"
+#include <algorithm>
+#include <cstring>
+
 namespace hpq {
-// Buffer implementation stub
+
+BufferOutputStream::BufferOutputStream(size_t initial_capacity) {
+  buffer_.reserve(initial_capacity);
 }
+
+void BufferOutputStream::Write(const void *data, size_t size) {
+  const uint8_t *bytes = static_cast<const uint8_t *>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void BufferOutputStream::Writev(const iovec *iov, int count) {
+  size_t total = 0;
+  for (int i = 0; i < count; ++i)
+    total += iov[i].iov_len;
+  size_t offset = buffer_.size();
+  // One growth step for the whole batch
+  if (buffer_.capacity() < offset + total)
+    buffer_.reserve(std::max(offset + total, 2 * buffer_.capacity()));
+  buffer_.resize(offset + total);
+  for (int i = 0; i < count; ++i) {
+    if (iov[i].iov_len == 0)
+      continue;
+    std::memcpy(buffer_.data() + offset, iov[i].iov_base, iov[i].iov_len);
+    offset += iov[i].iov_len;
+  }
+}
+
+} // namespace hpq
@@ -1,3 +1,340 @@
+#include "hpq/io/file_writer.h"
+#include "hpq/util/bounded_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
 namespace hpq {
-// File writer implementation stub
+
+namespace {
+
+constexpr size_t kRingDepth = 4;
+
+size_t AlignUp(size_t n, size_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
 }
+
+} // namespace
+
+// Buffers cycle free -> caller fills -> full -> I/O thread writes -> free.
+// The I/O thread owns the file offset; after a failure it keeps recycling
+// buffers so the caller never blocks, and the error surfaces on the caller's
+// next buffer switch or on Close().
+struct FileWriter::DirectRing {
+  struct Block {
+    int index = -1;
+    size_t bytes = 0;
+  };
+
+  size_t buffer_size = 0;
+  std::vector<uint8_t *> buffers;
+  BoundedQueue<Block> free{kRingDepth};
+  BoundedQueue<Block> full{kRingDepth};
+  int current = -1;
+  size_t fill = 0;
+
+  std::atomic<bool> direct{false};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::thread io;
+
+  // Makes sure the caller owns a buffer to fill
+  void Acquire() {
+    if (current >= 0)
+      return;
+    Block block;
+    free.Pop(block);
+    if (failed.load(std::memory_order_acquire))
+      std::rethrow_exception(error);
+    current = block.index;
+    fill = 0;
+  }
+
+  ~DirectRing() {
+    full.Close();
+    if (io.joinable())
+      io.join();
+    for (uint8_t *buf : buffers) {
+      ::munlock(buf, buffer_size);
+      std::free(buf);
+    }
+  }
+};
+
+FileWriter::FileWriter() = default;
+
+FileWriter::~FileWriter() {
+  ring_.reset();
+  if (map_)
+    ::munmap(map_, capacity_);
+  if (fd_ >= 0)
+    ::close(fd_);
+}
+
+bool FileWriter::direct() const { return ring_ && ring_->direct.load(); }
+
+void FileWriter::Fail(const char *what) const {
+  throw std::runtime_error(std::string("Failed to ") + what + " " + filename_ +
+                           ": " + std::strerror(errno));
+}
+
+void FileWriter::Open(const std::string &filename, Mode mode,
+                      size_t block_size) {
+  OpenFile(filename, mode, block_size, -1);
+}
+
+void FileWriter::OpenAt(const std::string &filename, int64_t offset,
+                        Mode mode, size_t block_size) {
+  if (offset < 0)
+    throw std::invalid_argument("FileWriter::OpenAt: negative offset");
+  OpenFile(filename, mode, block_size, offset);
+}
+
+// offset < 0 creates or truncates the file; otherwise the existing file is
+// cut at `offset` and written from there.
+void FileWriter::OpenFile(const std::string &filename, Mode mode,
+                          size_t block_size, int64_t offset) {
+  filename_ = filename;
+  mode_ = mode;
+  position_ = std::max<int64_t>(offset, 0);
+  capacity_ = 0;
+  extent_size_ = block_size > 0 ? block_size : (64 << 20);
+
+  int flags = mode == Mode::kMmap ? O_RDWR : O_WRONLY;
+  if (offset < 0)
+    flags |= O_CREAT | O_TRUNC;
+  bool direct = false;
+#ifdef O_DIRECT
+  if (mode == Mode::kDirect) {
+    fd_ = ::open(filename.c_str(), flags | O_DIRECT, 0644);
+    direct = fd_ >= 0;
+  }
+#endif
+  // tmpfs and some FUSE filesystems refuse O_DIRECT at open time
+  if (!direct)
+    fd_ = ::open(filename.c_str(), flags, 0644);
+  if (fd_ < 0)
+    Fail("open");
+  if (offset >= 0) {
+    if (::ftruncate(fd_, offset) != 0)
+      Fail("truncate");
+    if (mode == Mode::kWrite && ::lseek(fd_, offset, SEEK_SET) < 0)
+      Fail("seek");
+  }
+  if (mode == Mode::kDirect) {
+    OpenDirect(extent_size_, position_);
+    ring_->direct = direct;
+  }
+}
+
+void FileWriter::OpenDirect(size_t buffer_size, int64_t start) {
+  ring_ = std::make_unique<DirectRing>();
+  DirectRing &ring = *ring_;
+  ring.buffer_size = AlignUp(buffer_size, kDirectAlignment);
+  for (size_t i = 0; i < kRingDepth; ++i) {
+    void *buf = std::aligned_alloc(kDirectAlignment, ring.buffer_size);
+    if (!buf)
+      throw std::bad_alloc();
+    // Best effort: the ring is small and reused, so keeping it resident
+    // avoids faulting it back in under memory pressure.
+    ::mlock(buf, ring.buffer_size);
+    ring.buffers.push_back(static_cast<uint8_t *>(buf));
+    ring.free.Push({static_cast<int>(i), 0});
+  }
+
+  // Block-sized I/O must start on a block boundary: when appending inside a
+  // block, the first buffer begins with the existing bytes of that block.
+  const int64_t base = start / kDirectAlignment * kDirectAlignment;
+  if (start > base) {
+    int in = ::open(filename_.c_str(), O_RDONLY);
+    if (in < 0)
+      Fail("open");
+    ring.Acquire();
+    size_t head = static_cast<size_t>(start - base);
+    ssize_t n = ::pread(in, ring.buffers[ring.current], head, base);
+    ::close(in);
+    if (n != static_cast<ssize_t>(head))
+      Fail("read");
+    ring.fill = head;
+  }
+
+  ring.io = std::thread([this, &ring, base] {
+    off_t offset = base;
+    DirectRing::Block block;
+    while (ring.full.Pop(block)) {
+      const uint8_t *ptr = ring.buffers[block.index];
+      size_t left = block.bytes;
+      try {
+        while (left > 0 && !ring.failed.load(std::memory_order_relaxed)) {
+          ssize_t n = ::pwrite(fd_, ptr, left, offset);
+          if (n >= 0) {
+            ptr += n;
+            left -= static_cast<size_t>(n);
+            offset += n;
+            continue;
+          }
+          if (errno == EINTR)
+            continue;
+#ifdef O_DIRECT
+          // Some filesystems accept O_DIRECT at open but reject the I/O
+          if (errno == EINVAL && ring.direct.load()) {
+            int fl = ::fcntl(fd_, F_GETFL);
+            if (fl >= 0 && ::fcntl(fd_, F_SETFL, fl & ~O_DIRECT) == 0) {
+              ring.direct = false;
+              continue;
+            }
+          }
+#endif
+          Fail("write");
+        }
+      } catch (...) {
+        ring.error = std::current_exception();
+        ring.failed.store(true, std::memory_order_release);
+      }
+      ring.free.Push({block.index, 0});
+    }
+  });
+}
+
+void FileWriter::WriteRing(const uint8_t *data, size_t size) {
+  DirectRing &ring = *ring_;
+  while (size > 0) {
+    ring.Acquire();
+    size_t n = std::min(size, ring.buffer_size - ring.fill);
+    std::memcpy(ring.buffers[ring.current] + ring.fill, data, n);
+    ring.fill += n;
+    data += n;
+    size -= n;
+    position_ += n;
+    if (ring.fill == ring.buffer_size) {
+      ring.full.Push({ring.current, ring.fill});
+      ring.current = -1;
+    }
+  }
+}
+
+void FileWriter::CloseDirect() {
+  DirectRing &ring = *ring_;
+  if (ring.current >= 0 && ring.fill > 0) {
+    // O_DIRECT needs block-sized I/O: pad the tail, truncate afterwards
+    size_t padded = AlignUp(ring.fill, kDirectAlignment);
+    std::memset(ring.buffers[ring.current] + ring.fill, 0, padded - ring.fill);
+    ring.full.Push({ring.current, padded});
+    ring.current = -1;
+  }
+  ring.full.Close();
+  ring.io.join();
+  if (ring.failed.load(std::memory_order_acquire))
+    std::rethrow_exception(ring.error);
+  if (::ftruncate(fd_, position_) != 0)
+    Fail("truncate");
+}
+
+void FileWriter::EnsureCapacity(size_t end) {
+  if (end <= capacity_)
+    return;
+  size_t new_capacity =
+      (end + extent_size_ - 1) / extent_size_ * extent_size_;
+
+  // Reserve real blocks up front so stores into the mapping never hit a
+  // SIGBUS on a full disk; filesystems without fallocate just get a sparse
+  // ftruncate.
+  int rc = ::posix_fallocate(fd_, capacity_, new_capacity - capacity_);
+  if (rc != 0) {
+    if (rc != EOPNOTSUPP && rc != EINVAL) {
+      errno = rc;
+      Fail("preallocate");
+    }
+    if (::ftruncate(fd_, new_capacity) != 0)
+      Fail("extend");
+  }
+
+  void *map;
+#ifdef __linux__
+  if (map_)
+    map = ::mremap(map_, capacity_, new_capacity, MREMAP_MAYMOVE);
+  else
+#endif
+  {
+    if (map_)
+      ::munmap(map_, capacity_);
+    map = ::mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_SHARED,
+                 fd_, 0);
+  }
+  if (map == MAP_FAILED) {
+    map_ = nullptr;
+    capacity_ = 0;
+    Fail("map");
+  }
+  map_ = static_cast<uint8_t *>(map);
+  capacity_ = new_capacity;
+}
+
+void FileWriter::WriteAll(const uint8_t *ptr, size_t size) {
+  while (size > 0) {
+    ssize_t n = ::write(fd_, ptr, size);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      Fail("write");
+    }
+    ptr += n;
+    size -= static_cast<size_t>(n);
+    position_ += n;
+  }
+}
+
+void FileWriter::Write(const void *data, size_t size) {
+  if (ring_) {
+    WriteRing(static_cast<const uint8_t *>(data), size);
+    return;
+  }
+  if (mode_ == Mode::kMmap) {
+    EnsureCapacity(position_ + size);
+    std::memcpy(map_ + position_, data, size);
+    position_ += size;
+    return;
+  }
+  WriteAll(static_cast<const uint8_t *>(data), size);
+}
+
+void FileWriter::Writev(const iovec *iov, int count) {
+  if (ring_ || mode_ == Mode::kMmap) {
+    OutputStream::Writev(iov, count);
+    return;
+  }
+  if (!WritevAll(fd_, iov, count))
+    Fail("write");
+  for (int i = 0; i < count; ++i)
+    position_ += static_cast<int64_t>(iov[i].iov_len);
+}
+
+void FileWriter::Close() {
+  if (fd_ < 0)
+    return;
+  if (map_) {
+    ::munmap(map_, capacity_);
+    map_ = nullptr;
+    capacity_ = 0;
+  }
+  if (mode_ == Mode::kMmap && ::ftruncate(fd_, position_) != 0)
+    Fail("truncate");
+  if (ring_) {
+    CloseDirect();
+    ring_.reset();
+  }
+  int rc = ::close(fd_);
+  fd_ = -1;
+  if (rc != 0)
+    Fail("close");
+}
+
+} // namespace hpq
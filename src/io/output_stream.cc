@@ -0,0 +1,85 @@
+#include "hpq/io/output_stream.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace hpq {
+
+void OutputStream::Writev(const iovec *iov, int count) {
+  for (int i = 0; i < count; ++i)
+    Write(iov[i].iov_base, iov[i].iov_len);
+}
+
+bool WritevAll(int fd, const iovec *iov, int count) {
+  // Short writes advance through a copy; the caller's array is left alone.
+  std::vector<iovec> rest(iov, iov + count);
+  size_t next = 0;
+  while (next < rest.size()) {
+    if (rest[next].iov_len == 0) {
+      ++next;
+      continue;
+    }
+    const int n_iov = static_cast<int>(
+        std::min<size_t>(rest.size() - next, IOV_MAX));
+    ssize_t n = ::writev(fd, rest.data() + next, n_iov);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    size_t written = static_cast<size_t>(n);
+    while (written > 0 && written >= rest[next].iov_len) {
+      written -= rest[next].iov_len;
+      ++next;
+    }
+    if (written > 0) {
+      iovec &head = rest[next];
+      head.iov_base = static_cast<uint8_t *>(head.iov_base) + written;
+      head.iov_len -= written;
+    }
+  }
+  return true;
+}
+
+FdOutputStream::FdOutputStream(int fd, bool owns_fd)
+    : fd_(fd), owns_fd_(owns_fd) {
+  if (fd < 0)
+    throw std::invalid_argument("FdOutputStream: invalid descriptor");
+}
+
+FdOutputStream::~FdOutputStream() {
+  if (owns_fd_ && fd_ >= 0)
+    ::close(fd_);
+}
+
+void FdOutputStream::Write(const void *data, size_t size) {
+  iovec iov{const_cast<void *>(data), size};
+  Writev(&iov, 1);
+}
+
+void FdOutputStream::Writev(const iovec *iov, int count) {
+  if (fd_ < 0)
+    throw std::runtime_error("FdOutputStream: write after Close()");
+  if (!WritevAll(fd_, iov, count))
+    throw std::runtime_error(std::string("Failed to write to descriptor: ") +
+                             std::strerror(errno));
+  for (int i = 0; i < count; ++i)
+    position_ += static_cast<int64_t>(iov[i].iov_len);
+}
+
+void FdOutputStream::Close() {
+  if (fd_ < 0)
+    return;
+  const int fd = fd_;
+  fd_ = -1;
+  if (owns_fd_ && ::close(fd) != 0)
+    throw std::runtime_error(std::string("Failed to close descriptor: ") +
+                             std::strerror(errno));
+}
+
+} // namespace hpq
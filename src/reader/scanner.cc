@@ -0,0 +1,679 @@
+#include "hpq/scanner.h"
+#include "hpq/bloom_filter.h"
+#include "hpq/compression/codec.h"
+#include "hpq/encodings/boolean.h"
+#include "hpq/encodings/byte_stream_split.h"
+#include "hpq/encodings/delta.h"
+#include "hpq/encodings/rle.h"
+#include "hpq/format/parquet_layout.h"
+#include "hpq/type_traits.h"
+#include "hpq/util/crc32.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hpq {
+
+using Op = ColumnPredicate::Op;
+
+static ColumnPredicate MakePredicate(const std::string &column, Op op,
+                                     std::vector<ScalarValue> values) {
+  ColumnPredicate p;
+  p.column = column;
+  p.op = op;
+  p.values = std::move(values);
+  return p;
+}
+
+ColumnPredicate ColumnPredicate::Equal(const std::string &column,
+                                       ScalarValue value) {
+  return MakePredicate(column, Op::kEqual, {value});
+}
+
+ColumnPredicate ColumnPredicate::Less(const std::string &column,
+                                      ScalarValue value) {
+  return MakePredicate(column, Op::kLess, {value});
+}
+
+ColumnPredicate ColumnPredicate::LessEqual(const std::string &column,
+                                           ScalarValue value) {
+  return MakePredicate(column, Op::kLessEqual, {value});
+}
+
+ColumnPredicate ColumnPredicate::Greater(const std::string &column,
+                                         ScalarValue value) {
+  return MakePredicate(column, Op::kGreater, {value});
+}
+
+ColumnPredicate ColumnPredicate::GreaterEqual(const std::string &column,
+                                              ScalarValue value) {
+  return MakePredicate(column, Op::kGreaterEqual, {value});
+}
+
+ColumnPredicate ColumnPredicate::Between(const std::string &column,
+                                         ScalarValue lo, ScalarValue hi) {
+  return MakePredicate(column, Op::kBetween, {lo, hi});
+}
+
+ColumnPredicate ColumnPredicate::In(const std::string &column,
+                                    std::vector<ScalarValue> values) {
+  return MakePredicate(column, Op::kIn, std::move(values));
+}
+
+static int Compare(const ScalarValue &a, const ScalarValue &b) {
+  if (std::holds_alternative<int64_t>(a) &&
+      std::holds_alternative<int64_t>(b)) {
+    int64_t x = std::get<int64_t>(a);
+    int64_t y = std::get<int64_t>(b);
+    return x < y ? -1 : (y < x ? 1 : 0);
+  }
+  auto as_double = [](const ScalarValue &v) {
+    return std::visit([](auto x) { return static_cast<double>(x); }, v);
+  };
+  double x = as_double(a);
+  double y = as_double(b);
+  return x < y ? -1 : (y < x ? 1 : 0);
+}
+
+// Decodes a PLAIN-encoded statistics value.
+static ScalarValue StatValue(Type type, const std::string &bytes) {
+  return VisitFixedWidthType(type, [&](auto dtype) -> ScalarValue {
+    using T = typename decltype(dtype)::c_type;
+    if (bytes.size() != sizeof(T))
+      throw std::runtime_error("Statistics value has the wrong size");
+    T v;
+    std::memcpy(&v, bytes.data(), sizeof(T));
+    if constexpr (std::is_floating_point_v<T>)
+      return static_cast<double>(v);
+    else
+      return static_cast<int64_t>(v);
+  });
+}
+
+// Whether any value in [min, max] can satisfy the predicate.
+static bool RangeMayMatch(const ColumnPredicate &pred, const ScalarValue &min,
+                          const ScalarValue &max) {
+  const auto &v = pred.values;
+  switch (pred.op) {
+  case Op::kEqual:
+    return Compare(min, v[0]) <= 0 && Compare(v[0], max) <= 0;
+  case Op::kLess:
+    return Compare(min, v[0]) < 0;
+  case Op::kLessEqual:
+    return Compare(min, v[0]) <= 0;
+  case Op::kGreater:
+    return Compare(max, v[0]) > 0;
+  case Op::kGreaterEqual:
+    return Compare(max, v[0]) >= 0;
+  case Op::kBetween:
+    return Compare(min, v[1]) <= 0 && Compare(v[0], max) <= 0;
+  case Op::kIn:
+    for (const auto &x : v) {
+      if (Compare(min, x) <= 0 && Compare(x, max) <= 0)
+        return true;
+    }
+    return false;
+  }
+  return true;
+}
+
+// Converts a predicate operand to the column's C type. Returns false when
+// the column cannot hold that exact value.
+template <typename T>
+static bool ToColumnValue(const ScalarValue &value, T *out) {
+  return std::visit(
+      [out](auto x) {
+        using X = decltype(x);
+        if constexpr (std::is_floating_point_v<X> &&
+                      !std::is_floating_point_v<T>) {
+          // Out-of-range double -> integer casts are undefined.
+          if (!(x >= static_cast<X>(std::numeric_limits<T>::min()) &&
+                x < -static_cast<X>(std::numeric_limits<T>::min())))
+            return false;
+        } else if constexpr (!std::is_floating_point_v<X> &&
+                             !std::is_floating_point_v<T>) {
+          if (x < std::numeric_limits<T>::min() ||
+              x > std::numeric_limits<T>::max())
+            return false;
+        }
+        *out = static_cast<T>(x);
+        // long double holds every int64, float and double exactly.
+        return static_cast<long double>(*out) == static_cast<long double>(x);
+      },
+      value);
+}
+
+// Bloom filter probe for `value`: sets *present to false when the column
+// cannot hold it, else *hash. Returns false when the filter cannot decide:
+// BOOLEAN columns, and float zeros, whose two encodings hash differently.
+static bool ProbeHash(Type type, const ScalarValue &value, bool *present,
+                      uint64_t *hash) {
+  return VisitFixedWidthType(type, [&](auto dtype) {
+    using T = typename decltype(dtype)::c_type;
+    if constexpr (std::is_same_v<decltype(dtype), BooleanType>) {
+      return false;
+    } else {
+      T v;
+      *present = ToColumnValue(value, &v);
+      if (!*present)
+        return true;
+      if constexpr (std::is_floating_point_v<T>) {
+        if (v == 0)
+          return false;
+      }
+      *hash = BloomFilter::Hash(&v, sizeof(T));
+      return true;
+    }
+  });
+}
+
+static void MergeRange(std::vector<RowRange> *ranges, int64_t begin,
+                       int64_t end) {
+  if (!ranges->empty() && ranges->back().end == begin)
+    ranges->back().end = end;
+  else
+    ranges->push_back({begin, end});
+}
+
+static std::vector<RowRange> Intersect(const std::vector<RowRange> &a,
+                                       const std::vector<RowRange> &b) {
+  std::vector<RowRange> out;
+  size_t i = 0, j = 0;
+  while (i < a.size() && j < b.size()) {
+    int64_t lo = std::max(a[i].begin, b[j].begin);
+    int64_t hi = std::min(a[i].end, b[j].end);
+    if (lo < hi)
+      MergeRange(&out, lo, hi);
+    if (a[i].end < b[j].end)
+      ++i;
+    else
+      ++j;
+  }
+  return out;
+}
+
+static std::unique_ptr<Decoder> MakeDecoder(const ColumnSchema &column,
+                                            Encoding encoding) {
+  const Type type = column.type;
+  switch (encoding) {
+  case Encoding::PLAIN:
+    return MakePlainDecoder(type, column.type_length);
+  case Encoding::DELTA_BINARY_PACKED:
+    return std::make_unique<DeltaDecoder>(type);
+  case Encoding::BYTE_STREAM_SPLIT:
+    return std::make_unique<ByteStreamSplitDecoder>(type);
+  case Encoding::RLE:
+    if (type == Type::BOOLEAN)
+      return std::make_unique<BooleanDecoder>(Encoding::RLE);
+    break;
+  default:
+    break;
+  }
+  throw std::runtime_error("Unsupported page encoding " +
+                           std::to_string(static_cast<int>(encoding)));
+}
+
+static size_t ValueWidth(const ColumnSchema &column) {
+  if (column.type == Type::FIXED_LEN_BYTE_ARRAY)
+    return static_cast<size_t>(column.type_length);
+  return VisitFixedWidthType(
+      column.type, [](auto dtype) { return decltype(dtype)::byte_width; });
+}
+
+class ParquetScanner::Impl {
+public:
+  Impl(const std::string &filename, const ScanOptions &options)
+      : filename_(filename), options_(options) {
+    fd_ = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0)
+      throw std::runtime_error("Failed to open " + filename + ": " +
+                               std::strerror(errno));
+    try {
+      ReadFooter();
+      ResolveColumns();
+    } catch (...) {
+      ::close(fd_);
+      throw;
+    }
+  }
+
+  ~Impl() { ::close(fd_); }
+
+  const FileMetaData &metadata() const { return metadata_; }
+  const ScanStats &stats() const { return stats_; }
+
+  bool Next(ScanBatch *batch) {
+    while (next_row_group_ < metadata_.row_groups.size()) {
+      const int rg = static_cast<int>(next_row_group_++);
+      const RowGroupMetaData &meta = metadata_.row_groups[rg];
+      const int64_t first_row = first_row_;
+      first_row_ += meta.num_rows;
+      offset_indexes_.clear();
+      ++stats_.row_groups;
+
+      if (options_.use_statistics && !StatisticsMayMatch(meta)) {
+        ++stats_.row_groups_skipped_by_statistics;
+        continue;
+      }
+      if (options_.use_bloom_filters && !BloomFiltersMayMatch(meta)) {
+        ++stats_.row_groups_skipped_by_bloom_filter;
+        continue;
+      }
+      std::vector<RowRange> ranges;
+      if (meta.num_rows > 0)
+        ranges.push_back({0, meta.num_rows});
+      if (options_.use_page_index)
+        ranges = PageIndexRanges(meta, std::move(ranges));
+      if (ranges.empty()) {
+        ++stats_.row_groups_skipped_by_page_index;
+        continue;
+      }
+
+      batch->row_group = rg;
+      batch->first_row = first_row;
+      batch->ranges = ranges;
+      batch->num_rows = 0;
+      for (const RowRange &r : ranges)
+        batch->num_rows += r.end - r.begin;
+      batch->columns.resize(projection_.size());
+      for (size_t i = 0; i < projection_.size(); ++i)
+        ReadColumn(meta, projection_[i], ranges, batch->num_rows,
+                   &batch->columns[i]);
+      return true;
+    }
+    return false;
+  }
+
+private:
+  struct BoundPredicate {
+    const ColumnPredicate *predicate;
+    int column;
+  };
+
+  std::string filename_;
+  ScanOptions options_;
+  int fd_ = -1;
+  FileMetaData metadata_;
+  std::vector<int> projection_;
+  std::vector<BoundPredicate> predicates_;
+  size_t next_row_group_ = 0;
+  int64_t first_row_ = 0;
+  ScanStats stats_;
+  std::map<int, OffsetIndex> offset_indexes_; // Current row group
+  std::vector<uint8_t> scratch_;
+  std::vector<uint8_t> page_buf_; // Decompressed page body
+
+  void ReadAt(int64_t offset, size_t size, std::vector<uint8_t> *out) {
+    out->resize(size);
+    size_t done = 0;
+    while (done < size) {
+      ssize_t n = ::pread(fd_, out->data() + done, size - done, offset + done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        throw std::runtime_error("Read failed on " + filename_ + ": " +
+                                 std::strerror(errno));
+      if (n == 0)
+        throw std::runtime_error("Unexpected end of file in " + filename_);
+      done += static_cast<size_t>(n);
+    }
+    stats_.bytes_read += static_cast<int64_t>(size);
+  }
+
+  void ReadFooter() {
+    int64_t footer_offset = 0;
+    metadata_ = ReadFileFooter(fd_, filename_, &footer_offset);
+    struct stat st;
+    if (::fstat(fd_, &st) == 0)
+      stats_.bytes_read += st.st_size - footer_offset;
+  }
+
+  int FindColumn(const std::string &name) const {
+    for (size_t i = 0; i < metadata_.schema.size(); ++i) {
+      if (metadata_.schema[i].name == name)
+        return static_cast<int>(i);
+    }
+    throw std::runtime_error("Unknown column " + name);
+  }
+
+  void ResolveColumns() {
+    if (options_.columns.empty()) {
+      for (size_t i = 0; i < metadata_.schema.size(); ++i)
+        projection_.push_back(static_cast<int>(i));
+    } else {
+      for (const auto &name : options_.columns)
+        projection_.push_back(FindColumn(name));
+    }
+    for (const auto &p : options_.predicates) {
+      size_t expected = p.op == Op::kBetween ? 2 : 1;
+      if (p.op == Op::kIn ? p.values.empty() : p.values.size() != expected)
+        throw std::runtime_error("Wrong operand count in predicate on " +
+                                 p.column);
+      const int column = FindColumn(p.column);
+      if (metadata_.schema[column].type == Type::FIXED_LEN_BYTE_ARRAY)
+        throw std::runtime_error("Predicates on FIXED_LEN_BYTE_ARRAY column " +
+                                 p.column + " are not supported");
+      predicates_.push_back({&p, column});
+    }
+  }
+
+  bool StatisticsMayMatch(const RowGroupMetaData &meta) const {
+    for (const auto &bp : predicates_) {
+      const ColumnChunkMetaData &col = meta.columns[bp.column];
+      if (!col.statistics || !col.statistics->min_value ||
+          !col.statistics->max_value)
+        continue;
+      Type type = metadata_.schema[bp.column].type;
+      if (!RangeMayMatch(*bp.predicate,
+                         StatValue(type, *col.statistics->min_value),
+                         StatValue(type, *col.statistics->max_value)))
+        return false;
+    }
+    return true;
+  }
+
+  bool BloomFiltersMayMatch(const RowGroupMetaData &meta) {
+    for (const auto &bp : predicates_) {
+      const ColumnPredicate &pred = *bp.predicate;
+      const ColumnChunkMetaData &col = meta.columns[bp.column];
+      if ((pred.op != Op::kEqual && pred.op != Op::kIn) ||
+          !col.bloom_filter_offset)
+        continue;
+
+      // Hash the operands first: a value the column type cannot hold needs
+      // no filter at all.
+      Type type = metadata_.schema[bp.column].type;
+      std::vector<uint64_t> hashes;
+      bool maybe = false;
+      for (const auto &value : pred.values) {
+        bool present;
+        uint64_t hash;
+        if (!ProbeHash(type, value, &present, &hash)) {
+          maybe = true;
+          break;
+        }
+        if (present)
+          hashes.push_back(hash);
+      }
+      if (maybe)
+        continue;
+
+      if (!hashes.empty()) {
+        BloomFilter filter = ReadBloomFilter(col);
+        maybe = std::any_of(hashes.begin(), hashes.end(),
+                            [&](uint64_t h) { return filter.FindHash(h); });
+      }
+      if (!maybe)
+        return false;
+    }
+    return true;
+  }
+
+  BloomFilter ReadBloomFilter(const ColumnChunkMetaData &col) {
+    // Without a recorded length, read enough for the header and fetch the
+    // bitset once its size is known.
+    constexpr size_t kHeaderGuess = 64;
+    std::vector<uint8_t> buf;
+    ReadAt(*col.bloom_filter_offset,
+           col.bloom_filter_length ? *col.bloom_filter_length : kHeaderGuess,
+           &buf);
+    int32_t num_bytes;
+    size_t header = ParseBloomFilterHeader(buf.data(), buf.size(), &num_bytes);
+    if (buf.size() < header + num_bytes) {
+      std::vector<uint8_t> bitset;
+      ReadAt(*col.bloom_filter_offset + header, num_bytes, &bitset);
+      return BloomFilter(bitset);
+    }
+    return BloomFilter(std::vector<uint8_t>(buf.begin() + header,
+                                            buf.begin() + header + num_bytes));
+  }
+
+  const OffsetIndex *GetOffsetIndex(const RowGroupMetaData &meta, int column) {
+    auto it = offset_indexes_.find(column);
+    if (it != offset_indexes_.end())
+      return &it->second;
+    const ColumnChunkMetaData &col = meta.columns[column];
+    if (!col.offset_index_offset || !col.offset_index_length)
+      return nullptr;
+    std::vector<uint8_t> buf;
+    ReadAt(*col.offset_index_offset, *col.offset_index_length, &buf);
+    return &offset_indexes_
+                .emplace(column, ParseOffsetIndex(buf.data(), buf.size()))
+                .first->second;
+  }
+
+  static int64_t PageEnd(const OffsetIndex &index, size_t page,
+                         int64_t num_rows) {
+    return page + 1 < index.page_locations.size()
+               ? index.page_locations[page + 1].first_row_index
+               : num_rows;
+  }
+
+  // Narrows `ranges` to the pages whose bounds may satisfy each predicate.
+  std::vector<RowRange> PageIndexRanges(const RowGroupMetaData &meta,
+                                        std::vector<RowRange> ranges) {
+    for (const auto &bp : predicates_) {
+      const ColumnChunkMetaData &col = meta.columns[bp.column];
+      if (!col.column_index_offset || !col.column_index_length)
+        continue;
+      const OffsetIndex *offsets = GetOffsetIndex(meta, bp.column);
+      if (!offsets)
+        continue;
+      std::vector<uint8_t> buf;
+      ReadAt(*col.column_index_offset, *col.column_index_length, &buf);
+      ColumnIndex index = ParseColumnIndex(buf.data(), buf.size());
+      if (index.null_pages.size() != offsets->page_locations.size())
+        continue;
+
+      Type type = metadata_.schema[bp.column].type;
+      std::vector<RowRange> keep;
+      for (size_t p = 0; p < index.null_pages.size(); ++p) {
+        // An all-null page matches no comparison.
+        if (index.null_pages[p] ||
+            !RangeMayMatch(*bp.predicate,
+                           StatValue(type, index.min_values[p]),
+                           StatValue(type, index.max_values[p])))
+          continue;
+        MergeRange(&keep, offsets->page_locations[p].first_row_index,
+                   PageEnd(*offsets, p, meta.num_rows));
+      }
+      ranges = Intersect(ranges, keep);
+      if (ranges.empty())
+        break;
+    }
+    return ranges;
+  }
+
+  // Decodes one data page (header at `data`) and appends the rows of
+  // `ranges` that fall in [page_first_row, ...) to `out`. Returns the bytes
+  // consumed.
+  size_t DecodePage(const ColumnSchema &column, Codec codec,
+                    const uint8_t *data, size_t size, int64_t page_first_row,
+                    const std::vector<RowRange> &ranges, ColumnVector *out,
+                    int64_t *out_rows) {
+    PageHeader header;
+    size_t header_len = ParsePageHeader(data, size, &header);
+    if (header.type != PageType::DATA_PAGE)
+      throw std::runtime_error("Only v1 data pages are supported (column " +
+                               column.name + ")");
+    if (header.compressed_page_size < 0 ||
+        header_len + header.compressed_page_size > size)
+      throw std::runtime_error("Truncated page in column " + column.name);
+
+    const uint8_t *body = data + header_len;
+    size_t body_size = header.compressed_page_size;
+    if (header.crc && options_.verify_checksums &&
+        static_cast<int32_t>(Crc32(body, body_size)) != *header.crc)
+      throw std::runtime_error("Page checksum mismatch in column " +
+                               column.name);
+    if (codec != Codec::UNCOMPRESSED) {
+      if (header.uncompressed_page_size < 0)
+        throw std::runtime_error("Corrupt page in column " + column.name);
+      page_buf_.resize(header.uncompressed_page_size);
+      DecompressBuffer(codec, body, body_size, page_buf_.data(),
+                       page_buf_.size());
+      body = page_buf_.data();
+      body_size = page_buf_.size();
+    }
+    const int32_t num_values = header.data_page_header.num_values;
+    if (column.nullable) {
+      uint32_t levels_len;
+      if (body_size < 4)
+        throw std::runtime_error("Truncated definition levels");
+      std::memcpy(&levels_len, body, 4);
+      if (levels_len > body_size - 4)
+        throw std::runtime_error("Truncated definition levels");
+      CheckAllDefined(body + 4, levels_len, num_values, column);
+      body += 4 + levels_len;
+      body_size -= 4 + levels_len;
+    }
+
+    const size_t width = ValueWidth(column);
+    const int64_t page_end = page_first_row + num_values;
+    auto decoder = MakeDecoder(column, header.data_page_header.encoding);
+    decoder->SetData(body, body_size, num_values);
+
+    // A page inside one range decodes straight into the output.
+    auto covering = std::find_if(ranges.begin(), ranges.end(), [&](auto &r) {
+      return r.begin <= page_first_row && page_end <= r.end;
+    });
+    if (covering != ranges.end()) {
+      if (decoder->Decode(out->data.data() + *out_rows * width, num_values) !=
+          num_values)
+        throw std::runtime_error("Short page in column " + column.name);
+      *out_rows += num_values;
+      return header_len + header.compressed_page_size;
+    }
+
+    scratch_.resize(static_cast<size_t>(num_values) * width);
+    if (decoder->Decode(scratch_.data(), num_values) != num_values)
+      throw std::runtime_error("Short page in column " + column.name);
+    for (const RowRange &r : ranges) {
+      int64_t lo = std::max(r.begin, page_first_row);
+      int64_t hi = std::min(r.end, page_end);
+      if (lo >= hi)
+        continue;
+      std::memcpy(out->data.data() + *out_rows * width,
+                  scratch_.data() + (lo - page_first_row) * width,
+                  (hi - lo) * width);
+      *out_rows += hi - lo;
+    }
+    return header_len + header.compressed_page_size;
+  }
+
+  void CheckAllDefined(const uint8_t *levels, size_t size, int32_t num_values,
+                       const ColumnSchema &column) {
+    RleBitPackedReader reader(levels, size, 1);
+    uint32_t buf[256];
+    for (int32_t done = 0; done < num_values;) {
+      int got = reader.GetBatch(buf, std::min(256, num_values - done));
+      if (got == 0)
+        throw std::runtime_error("Truncated definition levels");
+      for (int k = 0; k < got; ++k) {
+        if (buf[k] != 1)
+          throw std::runtime_error("Null values are not supported (column " +
+                                   column.name + ")");
+      }
+      done += got;
+    }
+  }
+
+  void ReadColumn(const RowGroupMetaData &meta, int column,
+                  const std::vector<RowRange> &ranges, int64_t num_rows,
+                  ColumnVector *out) {
+    const ColumnSchema &schema = metadata_.schema[column];
+    const ColumnChunkMetaData &col = meta.columns[column];
+    if (!CodecAvailable(col.codec))
+      throw std::runtime_error("Unsupported codec in column " + schema.name);
+    out->name = schema.name;
+    out->type = schema.type;
+    out->length = num_rows;
+    out->data.resize(static_cast<size_t>(num_rows) * ValueWidth(schema));
+    int64_t out_rows = 0;
+    std::vector<uint8_t> buf;
+
+    const OffsetIndex *offsets =
+        options_.use_page_index ? GetOffsetIndex(meta, column) : nullptr;
+    if (!offsets) {
+      // Whole chunk in one read; pages are walked in order.
+      int64_t start = col.dictionary_page_offset
+                          ? std::min(*col.dictionary_page_offset,
+                                     col.data_page_offset)
+                          : col.data_page_offset;
+      ReadAt(start, col.total_compressed_size, &buf);
+      size_t pos = 0;
+      int64_t row = 0;
+      while (row < meta.num_rows) {
+        PageHeader header;
+        ParsePageHeader(buf.data() + pos, buf.size() - pos, &header);
+        ++stats_.pages;
+        pos += DecodePage(schema, col.codec, buf.data() + pos,
+                          buf.size() - pos, row, ranges, out, &out_rows);
+        row += header.data_page_header.num_values;
+      }
+    } else {
+      // Runs of consecutive wanted pages are fetched with one pread each.
+      const auto &pages = offsets->page_locations;
+      stats_.pages += pages.size();
+      size_t p = 0;
+      while (p < pages.size()) {
+        if (!PageWanted(*offsets, p, meta.num_rows, ranges)) {
+          ++stats_.pages_skipped;
+          ++p;
+          continue;
+        }
+        size_t q = p + 1;
+        while (q < pages.size() &&
+               PageWanted(*offsets, q, meta.num_rows, ranges))
+          ++q;
+        int64_t begin = pages[p].offset;
+        int64_t end = pages[q - 1].offset + pages[q - 1].compressed_page_size;
+        ReadAt(begin, end - begin, &buf);
+        for (size_t i = p; i < q; ++i) {
+          size_t pos = pages[i].offset - begin;
+          DecodePage(schema, col.codec, buf.data() + pos, buf.size() - pos,
+                     pages[i].first_row_index, ranges, out, &out_rows);
+        }
+        p = q;
+      }
+    }
+    if (out_rows != num_rows)
+      throw std::runtime_error("Column " + schema.name +
+                               " does not cover the selected rows");
+  }
+
+  static bool PageWanted(const OffsetIndex &index, size_t page,
+                         int64_t num_rows,
+                         const std::vector<RowRange> &ranges) {
+    int64_t begin = index.page_locations[page].first_row_index;
+    int64_t end = PageEnd(index, page, num_rows);
+    for (const RowRange &r : ranges) {
+      if (r.begin < end && begin < r.end)
+        return true;
+    }
+    return false;
+  }
+};
+
+ParquetScanner::ParquetScanner(const std::string &filename,
+                               const ScanOptions &options)
+    : impl_(std::make_unique<Impl>(filename, options)) {}
+
+ParquetScanner::~ParquetScanner() = default;
+
+const FileMetaData &ParquetScanner::metadata() const {
+  return impl_->metadata();
+}
+
+bool ParquetScanner::Next(ScanBatch *batch) { return impl_->Next(batch); }
+
+const ScanStats &ParquetScanner::stats() const { return impl_->stats(); }
+
+} // namespace hpq
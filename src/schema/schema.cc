@@ -1,10 +1,113 @@
 #include "hpq/schema.h"
+#include <cmath>
 #include <iostream>
+#include <stdexcept>
 
 namespace hpq {
 
+LogicalType LogicalType::Decimal(int precision, int scale) {
+  LogicalType t;
+  t.kind = Kind::kDecimal;
+  t.precision = precision;
+  t.scale = scale;
+  return t;
+}
+
+LogicalType LogicalType::Date() {
+  LogicalType t;
+  t.kind = Kind::kDate;
+  return t;
+}
+
+LogicalType LogicalType::Timestamp(TimeUnit unit, bool adjusted_to_utc) {
+  LogicalType t;
+  t.kind = Kind::kTimestamp;
+  t.unit = unit;
+  t.adjusted_to_utc = adjusted_to_utc;
+  return t;
+}
+
+LogicalType LogicalType::Uuid() {
+  LogicalType t;
+  t.kind = Kind::kUuid;
+  return t;
+}
+
+LogicalType LogicalType::Int(int bit_width, bool is_signed) {
+  LogicalType t;
+  t.kind = Kind::kInt;
+  t.bit_width = bit_width;
+  t.is_signed = is_signed;
+  return t;
+}
+
+// Bytes of a two's complement value holding every unscaled value of
+// `precision` digits.
+static int DecimalBytes(int precision) {
+  const double bits = precision * std::log2(10.0) + 1; // Plus the sign bit
+  return static_cast<int>(std::ceil(bits / 8));
+}
+
 void Schema::AddColumn(const std::string &name, Type type, bool nullable) {
   columns_.push_back({name, type, nullable});
 }
 
+void Schema::AddColumn(const std::string &name,
+                       const LogicalType &logical_type, bool nullable) {
+  ColumnSchema col{name, Type::INT32, nullable};
+  col.logical_type = logical_type;
+  switch (logical_type.kind) {
+  case LogicalType::Kind::kNone:
+    throw std::invalid_argument("Column " + name + " has no logical type");
+  case LogicalType::Kind::kDecimal:
+    if (logical_type.precision < 1 || logical_type.precision > 38 ||
+        logical_type.scale < 0 || logical_type.scale > logical_type.precision)
+      throw std::invalid_argument("Bad DECIMAL precision or scale for " +
+                                  name);
+    if (logical_type.precision > 18) {
+      col.type = Type::FIXED_LEN_BYTE_ARRAY;
+      col.type_length = DecimalBytes(logical_type.precision);
+    } else if (logical_type.precision > 9) {
+      col.type = Type::INT64;
+    }
+    break;
+  case LogicalType::Kind::kDate:
+    break;
+  case LogicalType::Kind::kTimestamp:
+    col.type = Type::INT64;
+    break;
+  case LogicalType::Kind::kUuid:
+    col.type = Type::FIXED_LEN_BYTE_ARRAY;
+    col.type_length = 16;
+    break;
+  case LogicalType::Kind::kInt:
+    if (logical_type.bit_width != 8 && logical_type.bit_width != 16)
+      throw std::invalid_argument("INT logical type of " + name +
+                                  " must be 8 or 16 bits wide");
+    break;
+  }
+  columns_.push_back(std::move(col));
+}
+
+void Schema::AddFixedLenColumn(const std::string &name, int type_length,
+                               bool nullable) {
+  if (type_length <= 0)
+    throw std::invalid_argument("FIXED_LEN_BYTE_ARRAY column " + name +
+                                " needs a positive length");
+  ColumnSchema col{name, Type::FIXED_LEN_BYTE_ARRAY, nullable};
+  col.type_length = type_length;
+  columns_.push_back(std::move(col));
+}
+
+void Schema::AddColumn(const ColumnSchema &column) {
+  columns_.push_back(column);
+}
+
+void Schema::SetFieldOffset(size_t col_idx, size_t offset) {
+  if (col_idx >= columns_.size())
+    throw std::out_of_range("Schema::SetFieldOffset: no column " +
+                            std::to_string(col_idx));
+  columns_[col_idx].field_offset = static_cast<int64_t>(offset);
+}
+
 } // namespace hpq
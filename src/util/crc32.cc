@@ -0,0 +1,132 @@
+#include "hpq/util/crc32.h"
+#include <array>
+#include <cstring>
+
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace hpq {
+
+namespace {
+
+constexpr uint32_t kPolynomial = 0xEDB88320; // Reflected 0x04C11DB7
+
+using Crc32Tables = std::array<std::array<uint32_t, 256>, 8>;
+
+// tables[k][b]: CRC of byte b followed by k zero bytes
+constexpr Crc32Tables MakeTables() {
+  Crc32Tables tables{};
+  for (uint32_t b = 0; b < 256; ++b) {
+    uint32_t crc = b;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc >> 1) ^ (kPolynomial & (0u - (crc & 1)));
+    tables[0][b] = crc;
+  }
+  for (uint32_t b = 0; b < 256; ++b) {
+    for (int k = 1; k < 8; ++k)
+      tables[k][b] =
+          (tables[k - 1][b] >> 8) ^ tables[0][tables[k - 1][b] & 0xFF];
+  }
+  return tables;
+}
+
+constexpr Crc32Tables kTables = MakeTables();
+
+// `crc` is the running register, not yet inverted for output.
+uint32_t Crc32Tables8(const uint8_t *data, size_t size, uint32_t crc) {
+  for (; size >= 8; data += 8, size -= 8) {
+    uint32_t lo;
+    uint32_t hi;
+    std::memcpy(&lo, data, 4);
+    std::memcpy(&hi, data + 4, 4);
+    lo ^= crc;
+    crc = kTables[7][lo & 0xFF] ^ kTables[6][(lo >> 8) & 0xFF] ^
+          kTables[5][(lo >> 16) & 0xFF] ^ kTables[4][lo >> 24] ^
+          kTables[3][hi & 0xFF] ^ kTables[2][(hi >> 8) & 0xFF] ^
+          kTables[1][(hi >> 16) & 0xFF] ^ kTables[0][hi >> 24];
+  }
+  for (; size > 0; ++data, --size)
+    crc = (crc >> 8) ^ kTables[0][(crc ^ *data) & 0xFF];
+  return crc;
+}
+
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+// Constants for the reflected polynomial as in Intel's "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ Instruction": the
+// x^n mod P pairs for folding 512 and 128 bits ahead, the 64-bit fold, and
+// P with its Barrett constant.
+alignas(16) constexpr uint64_t kFold4[2] = {0x154442bd4, 0x1c6e41596};
+alignas(16) constexpr uint64_t kFold1[2] = {0x1751997d0, 0x0ccaa009e};
+alignas(16) constexpr uint64_t kFold64[2] = {0x163cd6124, 0};
+alignas(16) constexpr uint64_t kBarrett[2] = {0x1db710641, 0x1f7011641};
+
+inline __m128i Fold(__m128i acc, __m128i next, __m128i k) {
+  const __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+  const __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(lo, hi), next);
+}
+
+inline __m128i Load(const uint8_t *p) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+}
+
+// Needs size >= 64 and a multiple of 16.
+uint32_t Crc32Clmul(const uint8_t *data, size_t size, uint32_t crc) {
+  __m128i x1 = _mm_xor_si128(Load(data), _mm_cvtsi32_si128(crc));
+  __m128i x2 = Load(data + 16);
+  __m128i x3 = Load(data + 32);
+  __m128i x4 = Load(data + 48);
+  data += 64;
+  size -= 64;
+
+  // Four independent 128-bit lanes hide the multiply latency
+  __m128i k = _mm_load_si128(reinterpret_cast<const __m128i *>(kFold4));
+  for (; size >= 64; data += 64, size -= 64) {
+    x1 = Fold(x1, Load(data), k);
+    x2 = Fold(x2, Load(data + 16), k);
+    x3 = Fold(x3, Load(data + 32), k);
+    x4 = Fold(x4, Load(data + 48), k);
+  }
+
+  k = _mm_load_si128(reinterpret_cast<const __m128i *>(kFold1));
+  x1 = Fold(x1, x2, k);
+  x1 = Fold(x1, x3, k);
+  x1 = Fold(x1, x4, k);
+  for (; size >= 16; data += 16, size -= 16)
+    x1 = Fold(x1, Load(data), k);
+
+  // 128 -> 64 bits
+  const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+  __m128i t = _mm_clmulepi64_si128(x1, k, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), t);
+  k = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(kFold64));
+  t = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, t);
+
+  // Barrett reduction to 32 bits
+  k = _mm_load_si128(reinterpret_cast<const __m128i *>(kBarrett));
+  t = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+  t = _mm_clmulepi64_si128(_mm_and_si128(t, mask32), k, 0x00);
+  x1 = _mm_xor_si128(x1, t);
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+#endif
+
+} // namespace
+
+uint32_t Crc32(const uint8_t *data, size_t size, uint32_t crc) {
+  crc = ~crc;
+#if defined(__PCLMUL__) && defined(__SSE4_1__)
+  if (size >= 64) {
+    const size_t folded = size & ~size_t{15};
+    crc = Crc32Clmul(data, folded, crc);
+    data += folded;
+    size -= folded;
+  }
+#endif
+  return ~Crc32Tables8(data, size, crc);
+}
+
+} // namespace hpq
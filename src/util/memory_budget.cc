@@ -0,0 +1,68 @@
+#include "hpq/util/memory_budget.h"
+#include <algorithm>
+
+namespace hpq {
+
+MemoryBudget::MemoryBudget(size_t limit, double flush_threshold)
+    : limit_(limit),
+      flush_at_(static_cast<size_t>(static_cast<double>(limit) *
+                                    std::clamp(flush_threshold, 0.0, 1.0))) {}
+
+void MemoryBudget::Register(MemoryConsumer *consumer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  consumers_.push_back(consumer);
+}
+
+void MemoryBudget::Unregister(MemoryConsumer *consumer) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  consumers_.erase(std::find(consumers_.begin(), consumers_.end(), consumer));
+}
+
+void MemoryBudget::RequestFlush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  MemoryConsumer *largest = nullptr;
+  for (MemoryConsumer *consumer : consumers_) {
+    if (!largest || consumer->reserved() > largest->reserved())
+      largest = consumer;
+  }
+  if (largest && largest->reserved() > 0)
+    largest->flush_requested_.store(true, std::memory_order_release);
+}
+
+MemoryConsumer::MemoryConsumer(MemoryBudget *budget) : budget_(budget) {
+  if (budget_)
+    budget_->Register(this);
+}
+
+MemoryConsumer::~MemoryConsumer() {
+  if (budget_) {
+    budget_->used_.fetch_sub(reserved(), std::memory_order_relaxed);
+    budget_->Unregister(this);
+  }
+}
+
+void MemoryConsumer::Reserve(size_t bytes) {
+  reserved_.fetch_add(bytes, std::memory_order_relaxed);
+  if (!budget_)
+    return;
+  size_t used =
+      budget_->used_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (used > budget_->flush_at_)
+    budget_->RequestFlush();
+}
+
+void MemoryConsumer::Release(size_t bytes) {
+  reserved_.fetch_sub(bytes, std::memory_order_relaxed);
+  if (budget_)
+    budget_->used_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryCharge::Set(size_t bytes) {
+  if (consumer_ && bytes > bytes_)
+    consumer_->Reserve(bytes - bytes_);
+  else if (consumer_ && bytes < bytes_)
+    consumer_->Release(bytes_ - bytes);
+  bytes_ = bytes;
+}
+
+} // namespace hpq
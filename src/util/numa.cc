@@ -0,0 +1,190 @@
+#include "hpq/util/numa.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hpq {
+
+namespace {
+
+#if defined(__linux__)
+// From <linux/mempolicy.h>; the syscalls are called directly so there is
+// no dependency on libnuma.
+constexpr int kMpolPreferred = 1;
+constexpr unsigned kMpolMfMove = 1u << 1;
+constexpr unsigned long kMpolFNode = 1ul << 0;
+constexpr unsigned long kMpolFAddr = 1ul << 1;
+
+// Parses a sysfs CPU list such as "0-3,8,10-11".
+std::vector<int> ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream in(list);
+  std::string range;
+  while (std::getline(in, range, ',')) {
+    if (range.empty() || range == "\n")
+      continue;
+    const size_t dash = range.find('-');
+    const int first = std::stoi(range.substr(0, dash));
+    const int last =
+        dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+NumaTopology ReadTopology() {
+  NumaTopology topology;
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string list;
+  if (!std::getline(online, list))
+    return topology;
+  for (int node : ParseCpuList(list)) {
+    std::ifstream file("/sys/devices/system/node/node" +
+                       std::to_string(node) + "/cpulist");
+    std::string cpulist;
+    if (!std::getline(file, cpulist))
+      continue;
+    std::vector<int> cpus = ParseCpuList(cpulist);
+    if (cpus.empty())
+      continue; // Memory-only node
+    topology.nodes.push_back(node);
+    topology.cpus.push_back(std::move(cpus));
+  }
+  return topology;
+}
+
+// The whole pages inside [data, data + size), or false if there are none.
+bool PageRange(void *data, size_t size, uintptr_t *begin, size_t *length) {
+  const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const uintptr_t start = reinterpret_cast<uintptr_t>(data);
+  const uintptr_t first = (start + page - 1) & ~(page - 1);
+  const uintptr_t end = (start + size) & ~(page - 1);
+  if (end <= first)
+    return false;
+  *begin = first;
+  *length = end - first;
+  return true;
+}
+
+bool SetAffinity(const std::vector<int> &cpus) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+#endif
+
+} // namespace
+
+const NumaTopology &NumaTopology::Get() {
+  static const NumaTopology topology = [] {
+    NumaTopology t;
+#if defined(__linux__)
+    t = ReadTopology();
+#endif
+    if (t.nodes.empty()) {
+      const int n = std::max(1u, std::thread::hardware_concurrency());
+      t.nodes = {0};
+      t.cpus.assign(1, {});
+      for (int cpu = 0; cpu < n; ++cpu)
+        t.cpus[0].push_back(cpu);
+    }
+    return t;
+  }();
+  return topology;
+}
+
+int NumaTopology::IndexOf(int node) const {
+  auto it = std::find(nodes.begin(), nodes.end(), node);
+  return it == nodes.end() ? -1 : static_cast<int>(it - nodes.begin());
+}
+
+int CurrentNumaNode() {
+#if defined(__linux__)
+  unsigned cpu = 0;
+  unsigned node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+    return static_cast<int>(node);
+#endif
+  return 0;
+}
+
+bool PinThreadToNode(int node) {
+#if defined(__linux__)
+  const NumaTopology &topology = NumaTopology::Get();
+  const int index = topology.IndexOf(node);
+  return index >= 0 && SetAffinity(topology.cpus[index]);
+#else
+  (void)node;
+  return false;
+#endif
+}
+
+bool PinThreadToCpu(int cpu) {
+#if defined(__linux__)
+  return SetAffinity({cpu});
+#else
+  (void)cpu;
+  return false;
+#endif
+}
+
+void BindToNumaNode(void *data, size_t size, int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  uintptr_t begin;
+  size_t length;
+  if (node < 0 || node >= 64 || !PageRange(data, size, &begin, &length))
+    return;
+  const unsigned long mask = 1ul << node;
+  // maxnode counts one past the last bit, as the kernel expects. Best
+  // effort: a refusal (no NUMA support, seccomp) leaves first-touch
+  // placement in effect.
+  syscall(SYS_mbind, begin, length, kMpolPreferred, &mask,
+          sizeof(mask) * 8 + 1, kMpolMfMove);
+#else
+  (void)data;
+  (void)size;
+  (void)node;
+#endif
+}
+
+void AdviseHugePages(void *data, size_t size) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  uintptr_t begin;
+  size_t length;
+  if (PageRange(data, size, &begin, &length))
+    madvise(reinterpret_cast<void *>(begin), length, MADV_HUGEPAGE);
+#else
+  (void)data;
+  (void)size;
+#endif
+}
+
+int NumaNodeOfAddress(const void *data) {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+  int node = -1;
+  if (syscall(SYS_get_mempolicy, &node, nullptr, 0, data,
+              kMpolFNode | kMpolFAddr) == 0)
+    return node;
+#else
+  (void)data;
+#endif
+  return -1;
+}
+
+} // namespace hpq
@@ -0,0 +1,29 @@
+#include "hpq/util/thread_pool.h"
+#include <algorithm>
+
+namespace hpq {
+
+ThreadPool::ThreadPool(int num_threads, size_t queue_depth)
+    : queue_(queue_depth) {
+  for (int i = 0; i < std::max(1, num_threads); ++i) {
+    threads_.emplace_back([this] {
+      std::function<void()> task;
+      while (queue_.Pop(task)) {
+        task();
+        task = nullptr; // Drop captured state before blocking again
+      }
+    });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  queue_.Close();
+  for (auto &t : threads_)
+    t.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  queue_.Push(std::move(task));
+}
+
+} // namespace hpq
@@ -0,0 +1,228 @@
+#include "hpq/util/trace.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace hpq {
+
+namespace {
+
+int ThreadId() {
+#if defined(__linux__)
+  return static_cast<int>(::syscall(SYS_gettid));
+#else
+  return 0;
+#endif
+}
+
+int ProcessId() {
+#if defined(__linux__)
+  return static_cast<int>(::getpid());
+#else
+  return 0;
+#endif
+}
+
+// A thread's ring. Only its thread records into it; the mutex is there for
+// Start() and Snapshot(), so it is uncontended on the recording path.
+struct ThreadRing {
+  std::mutex mutex;
+  int tid = 0;
+  std::string name;
+  std::vector<TraceEvent> events;
+  size_t capacity = 0;
+  size_t next = 0; // Slot the next span overwrites once full
+  uint64_t dropped = 0;
+
+  void Reset(size_t new_capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    events.clear();
+    events.shrink_to_fit();
+    capacity = std::max<size_t>(new_capacity, 1);
+    next = 0;
+    dropped = 0;
+  }
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<ThreadRing>> rings;
+  size_t capacity = 1 << 16;
+};
+
+Registry &GetRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+ThreadRing &LocalRing() {
+  thread_local std::shared_ptr<ThreadRing> ring;
+  if (!ring) {
+    ring = std::make_shared<ThreadRing>();
+    ring->tid = ThreadId();
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    ring->capacity = registry.capacity;
+    registry.rings.push_back(ring);
+  }
+  return *ring;
+}
+
+void WriteJsonString(std::ostream &out, const std::string &s) {
+  out << '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out << escaped;
+    } else {
+      out << c;
+    }
+  }
+  out << '"';
+}
+
+// Nanoseconds as the microseconds trace-event timestamps use.
+void WriteMicros(std::ostream &out, int64_t ns) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%lld.%03lld",
+                static_cast<long long>(ns / 1000),
+                static_cast<long long>(ns % 1000));
+  out << buf;
+}
+
+} // namespace
+
+void Tracer::Start(size_t events_per_thread) {
+  Registry &registry = GetRegistry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.capacity = events_per_thread;
+  // Rings only the registry still holds belong to threads that are gone.
+  std::erase_if(registry.rings,
+                [](const auto &ring) { return ring.use_count() == 1; });
+  for (auto &ring : registry.rings)
+    ring->Reset(events_per_thread);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Stop() { enabled_.store(false, std::memory_order_relaxed); }
+
+void Tracer::Record(const TraceEvent &event) {
+  ThreadRing &ring = LocalRing();
+  std::lock_guard<std::mutex> lock(ring.mutex);
+  if (ring.events.size() < ring.capacity) {
+    ring.events.push_back(event);
+    return;
+  }
+  ring.events[ring.next] = event;
+  ring.next = (ring.next + 1) % ring.capacity;
+  ++ring.dropped;
+}
+
+void Tracer::SetThreadName(const std::string &name) {
+  ThreadRing &ring = LocalRing();
+  std::lock_guard<std::mutex> lock(ring.mutex);
+  ring.name = name;
+}
+
+std::vector<TraceThread> Tracer::Snapshot() {
+  std::vector<std::shared_ptr<ThreadRing>> rings;
+  {
+    Registry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    rings = registry.rings;
+  }
+  std::vector<TraceThread> threads;
+  for (auto &ring : rings) {
+    std::lock_guard<std::mutex> lock(ring->mutex);
+    if (ring->events.empty())
+      continue;
+    TraceThread &thread = threads.emplace_back();
+    thread.tid = ring->tid;
+    thread.name = ring->name;
+    thread.dropped = ring->dropped;
+    // Unroll the ring so the oldest span comes first
+    thread.events.assign(ring->events.begin() + ring->next,
+                         ring->events.end());
+    thread.events.insert(thread.events.end(), ring->events.begin(),
+                         ring->events.begin() + ring->next);
+  }
+  return threads;
+}
+
+void Tracer::WriteChromeTrace(std::ostream &out) {
+  const std::vector<TraceThread> threads = Snapshot();
+  const int pid = ProcessId();
+  // Timestamps count from the earliest start so they stay readable. Rings
+  // are in end order, so that is not necessarily a ring's first span.
+  int64_t origin = INT64_MAX;
+  uint64_t dropped = 0;
+  for (const auto &thread : threads) {
+    for (const TraceEvent &event : thread.events)
+      origin = std::min(origin, event.start_ns);
+    dropped += thread.dropped;
+  }
+
+  out << "{\"displayTimeUnit\":\"ns\",\"otherData\":{\"dropped_spans\":"
+      << dropped << "},\"traceEvents\":[";
+  bool first = true;
+  auto separator = [&] {
+    if (!first)
+      out << ",\n";
+    first = false;
+  };
+  for (const auto &thread : threads) {
+    if (!thread.name.empty()) {
+      separator();
+      out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << pid
+          << ",\"tid\":" << thread.tid << ",\"args\":{\"name\":";
+      WriteJsonString(out, thread.name);
+      out << "}}";
+    }
+    for (const TraceEvent &event : thread.events) {
+      separator();
+      out << "{\"ph\":\"X\",\"cat\":\"hpq\",\"name\":";
+      WriteJsonString(out, event.name);
+      out << ",\"pid\":" << pid << ",\"tid\":" << thread.tid << ",\"ts\":";
+      WriteMicros(out, event.start_ns - origin);
+      out << ",\"dur\":";
+      WriteMicros(out, event.duration_ns);
+      out << ",\"args\":{";
+      const char *comma = "";
+      if (event.column >= 0) {
+        out << "\"column\":" << event.column;
+        comma = ",";
+      }
+      if (event.row_group >= 0) {
+        out << comma << "\"row_group\":" << event.row_group;
+        comma = ",";
+      }
+      if (event.page >= 0)
+        out << comma << "\"page\":" << event.page;
+      out << "}}";
+    }
+  }
+  out << "]}\n";
+}
+
+void Tracer::WriteChromeTrace(const std::string &path) {
+  std::ofstream out(path, std::ios::trunc);
+  if (!out)
+    throw std::runtime_error("Failed to open " + path + " for the trace");
+  WriteChromeTrace(out);
+  out.flush();
+  if (!out)
+    throw std::runtime_error("Failed to write the trace to " + path);
+}
+
+} // namespace hpq
@@ -0,0 +1,119 @@
+#include "hpq/writer/codec_selector.h"
+#include "hpq/compression/codec.h"
+#include "hpq/writer.h"
+#include "hpq/writer/page.h"
+
+namespace hpq {
+
+// kBalanced takes GZIP only when its sample comes out at least this much
+// smaller than SNAPPY's; deflate costs several times the CPU.
+constexpr double kBalancedGzipAdvantage = 0.8;
+
+CodecSelector::CodecSelector(const WriterOptions &options)
+    : max_ratio_(1.0 - options.min_compression_gain) {
+  if (options.compression != "AUTO") {
+    Codec codec = ParseCodec(options.compression);
+    if (codec != Codec::UNCOMPRESSED && CodecAvailable(codec))
+      candidates_ = {codec};
+    return;
+  }
+  const bool gzip = CodecAvailable(Codec::GZIP);
+  switch (options.compression_target) {
+  case CompressionTarget::kSpeed:
+    candidates_ = {Codec::SNAPPY};
+    break;
+  case CompressionTarget::kBalanced:
+    candidates_ = {Codec::SNAPPY};
+    if (gzip)
+      candidates_.push_back(Codec::GZIP);
+    break;
+  case CompressionTarget::kRatio:
+    candidates_ = {gzip ? Codec::GZIP : Codec::SNAPPY};
+    break;
+  }
+}
+
+Codec CodecSelector::ChooseChunkCodec(const std::vector<uint8_t> &body,
+                                      double *ratio) {
+  Codec best = Codec::UNCOMPRESSED;
+  *ratio = 1.0;
+  for (Codec codec : candidates_) {
+    double r = EstimateCompressionRatio(codec, body.data(), body.size());
+    double bar =
+        best == Codec::UNCOMPRESSED ? *ratio : *ratio * kBalancedGzipAdvantage;
+    if (r < bar) {
+      best = codec;
+      *ratio = r;
+    }
+  }
+  return *ratio <= max_ratio_ ? best : Codec::UNCOMPRESSED;
+}
+
+void CodecSelector::ChooseChunkCodecs(std::span<const Page> pages) {
+  if (candidates_.empty())
+    return;
+  for (const Page &page : pages) {
+    if (page.ordinal != 0)
+      continue;
+    ChunkCodec chunk;
+    chunk.codec = ChooseChunkCodec(page.body, &chunk.first_ratio);
+    std::lock_guard<std::mutex> lock(mutex_);
+    chunks_.emplace(std::make_pair(page.row_group, page.column), chunk);
+  }
+}
+
+Codec CodecSelector::Select(const Page &page, bool *store) {
+  *store = false;
+  if (candidates_.empty())
+    return Codec::UNCOMPRESSED;
+
+  const auto key = std::make_pair(page.row_group, page.column);
+  Codec codec = Codec::UNCOMPRESSED;
+  double ratio = -1;
+  // Looks up the chunk's codec and counts the page, dropping the entry
+  // after the chunk's last page. False if the chunk is not known yet.
+  auto take = [&](const ChunkCodec *decided) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = chunks_.find(key);
+    if (it == chunks_.end()) {
+      if (!decided)
+        return false;
+      it = chunks_.emplace(key, *decided).first;
+    }
+    ChunkCodec &chunk = it->second;
+    codec = chunk.codec;
+    ratio = page.ordinal == 0 ? chunk.first_ratio : -1;
+    if (page.last_in_chunk)
+      chunk.expected = page.ordinal + 1;
+    if (++chunk.selected == chunk.expected)
+      chunks_.erase(it);
+    return true;
+  };
+
+  // Unprimed chunk: the trial runs outside the lock, and if another page of
+  // the chunk got there first, its choice wins.
+  if (!take(nullptr)) {
+    ChunkCodec chunk;
+    chunk.codec = ChooseChunkCodec(page.body, &chunk.first_ratio);
+    if (page.ordinal != 0)
+      chunk.first_ratio = -1;
+    take(&chunk);
+  }
+  if (codec == Codec::UNCOMPRESSED)
+    return codec;
+
+  if (ratio < 0)
+    ratio = EstimateCompressionRatio(codec, page.body.data(),
+                                     page.body.size());
+  *store = ratio > max_ratio_;
+  if (!*store)
+    pages_compressed_.fetch_add(1, std::memory_order_relaxed);
+  return codec;
+}
+
+size_t CodecSelector::open_chunks() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return chunks_.size();
+}
+
+} // namespace hpq
@@ -0,0 +1,66 @@
+#include "hpq/writer/compress_stage.h"
+#include "hpq/util/crc32.h"
+#include "hpq/util/trace.h"
+#include "hpq/writer.h"
+
+namespace hpq {
+
+CompressStage::CompressStage(size_t num_columns, const WriterOptions &options,
+                             CodecSelector *codecs)
+    : num_columns_(num_columns), options_(options), codecs_(codecs),
+      backend_(options.compress_backend) {
+  if (!backend_ && !options.use_gpu_compression)
+    backend_ = MakeCpuCompressBackend(options.compress_threads);
+}
+
+void CompressStage::Add(Page page, std::vector<Page> *ready) {
+  auto it = pending_.find(page.row_group);
+  if (it == pending_.end()) {
+    it = pending_.emplace(page.row_group, RowGroupPages()).first;
+    it->second.received.assign(num_columns_, 0);
+    it->second.expected.assign(num_columns_, -1);
+  }
+  RowGroupPages &group = it->second;
+  const int column = page.column;
+  if (page.last_in_chunk)
+    group.expected[column] = page.ordinal + 1;
+  group.pages.push_back(std::move(page));
+  // Pages of a chunk arrive in any order; it is complete when the count
+  // reaches the one its last page announced.
+  if (++group.received[column] == group.expected[column])
+    ++group.complete_chunks;
+  if (group.complete_chunks < num_columns_)
+    return;
+
+  Compress(group.pages, ready);
+  pending_.erase(it);
+}
+
+void CompressStage::Flush(std::vector<Page> *ready) {
+  for (auto &[row_group, group] : pending_)
+    Compress(group.pages, ready);
+  pending_.clear();
+}
+
+void CompressStage::Compress(std::vector<Page> &pages,
+                             std::vector<Page> *ready) {
+  HPQ_TRACE_SPAN("compress row group", -1, pages.front().row_group);
+  if (backend_) {
+    codecs_->ChooseChunkCodecs(pages);
+    backend_->CompressBatch(pages, codecs_);
+  } else {
+    for (Page &page : pages)
+      CompressPageGPU(options_, &page);
+  }
+  for (Page &page : pages) {
+    if (options_.page_checksums) {
+      HPQ_TRACE_SPAN("checksum", page.column, page.row_group, page.ordinal);
+      page.crc =
+          static_cast<int32_t>(Crc32(page.body.data(), page.body.size()));
+    }
+    ready->push_back(std::move(page));
+  }
+  pages.clear();
+}
+
+} // namespace hpq
@@ -0,0 +1,107 @@
+#include "hpq/writer/input_convert.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace hpq {
+
+// DECIMAL input: Arrow decimal128, little-endian two's complement.
+static __int128 LoadDecimal(const uint8_t *src) {
+  __int128 v;
+  std::memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+static void CheckDecimals(const ColumnSchema &column, const uint8_t *src,
+                          size_t stride, int64_t count) {
+  __int128 limit = 1;
+  for (int i = 0; i < column.logical_type.precision; ++i)
+    limit *= 10;
+  for (int64_t i = 0; i < count; ++i) {
+    const __int128 v = LoadDecimal(src + i * stride);
+    if (v >= limit || v <= -limit)
+      throw std::runtime_error("Value out of range for " + column.name +
+                               " DECIMAL(" +
+                               std::to_string(column.logical_type.precision) +
+                               ")");
+  }
+}
+
+template <typename T>
+static void DecimalToInt(const uint8_t *src, size_t stride, int64_t count,
+                         int, uint8_t *dst) {
+  for (int64_t i = 0; i < count; ++i) {
+    const T v = static_cast<T>(LoadDecimal(src + i * stride));
+    std::memcpy(dst + i * sizeof(T), &v, sizeof(T));
+  }
+}
+
+// FIXED_LEN_BYTE_ARRAY decimals are big-endian, type_length bytes.
+static void DecimalToFixed(const uint8_t *src, size_t stride, int64_t count,
+                           int type_length, uint8_t *dst) {
+  for (int64_t i = 0; i < count; ++i, dst += type_length) {
+    const uint8_t *v = src + i * stride;
+    for (int b = 0; b < type_length; ++b)
+      dst[b] = v[type_length - 1 - b];
+  }
+}
+
+template <typename T>
+static void WidenToInt32(const uint8_t *src, size_t stride, int64_t count,
+                         int, uint8_t *dst) {
+  for (int64_t i = 0; i < count; ++i) {
+    T narrow;
+    std::memcpy(&narrow, src + i * stride, sizeof(T));
+    const int32_t v = narrow;
+    std::memcpy(dst + i * sizeof(int32_t), &v, sizeof(int32_t));
+  }
+}
+
+InputConverter ResolveInputConverter(const ColumnSchema &column) {
+  InputConverter c;
+  const LogicalType &logical = column.logical_type;
+  switch (logical.kind) {
+  case LogicalType::Kind::kDecimal:
+    c.input_width = 16;
+    c.check = &CheckDecimals;
+    if (column.type == Type::INT32)
+      c.convert = &DecimalToInt<int32_t>;
+    else if (column.type == Type::INT64)
+      c.convert = &DecimalToInt<int64_t>;
+    else
+      c.convert = &DecimalToFixed;
+    return c;
+  case LogicalType::Kind::kInt:
+    c.input_width = logical.bit_width / 8;
+    if (logical.bit_width == 8)
+      c.convert = logical.is_signed ? &WidenToInt32<int8_t>
+                                    : &WidenToInt32<uint8_t>;
+    else
+      c.convert = logical.is_signed ? &WidenToInt32<int16_t>
+                                    : &WidenToInt32<uint16_t>;
+    return c;
+  default:
+    break;
+  }
+  switch (column.type) {
+  case Type::BOOLEAN:
+    c.input_width = 1; // One byte per value on input
+    break;
+  case Type::INT32:
+  case Type::FLOAT:
+    c.input_width = 4;
+    break;
+  case Type::INT64:
+  case Type::DOUBLE:
+    c.input_width = 8;
+    break;
+  case Type::FIXED_LEN_BYTE_ARRAY:
+    c.input_width = static_cast<size_t>(column.type_length);
+    break;
+  case Type::BYTE_ARRAY:
+    throw std::runtime_error("Unsupported column type for " + column.name);
+  }
+  return c;
+}
+
+} // namespace hpq
@@ -0,0 +1,132 @@
+#include "hpq/writer/page.h"
+#include "hpq/bloom_filter.h"
+#include "hpq/compression/codec.h"
+#include "hpq/encodings/adaptive.h"
+#include "hpq/format/statistics.h"
+#include "hpq/format/parquet_layout.h"
+#include "hpq/gpu/gpu_compress.h"
+#include "hpq/util/trace.h"
+#include "hpq/writer.h"
+#include "hpq/writer/codec_selector.h"
+#include <algorithm>
+#include <cstring>
+
+namespace hpq {
+
+template <typename DType>
+static void EncodeTypedPage(const ColumnSchema &column,
+                            const WriterOptions &options, Page *page) {
+  using c_type = typename DType::c_type;
+  const c_type *values = reinterpret_cast<const c_type *>(page->values.data());
+  page->has_stats = ComputeMinMax(DType::type, values, page->num_values,
+                                  &page->min_value, &page->max_value);
+  if (page->bloom) {
+    // Hashed and deduplicated here, on the parallel stage, so the assembler
+    // only merges sorted runs.
+    page->bloom_hashes.resize(page->num_values);
+    for (int32_t i = 0; i < page->num_values; ++i)
+      page->bloom_hashes[i] = BloomFilter::Hash(&values[i], sizeof(c_type));
+    std::sort(page->bloom_hashes.begin(), page->bloom_hashes.end());
+    page->bloom_hashes.erase(
+        std::unique(page->bloom_hashes.begin(), page->bloom_hashes.end()),
+        page->bloom_hashes.end());
+  }
+
+  // Concrete final type: Put/Flush are direct calls, not virtual dispatch.
+  TypedAdaptiveEncoder<DType> encoder(ParseCodec(options.compression),
+                                      page->adaptive);
+  encoder.PutTyped(values, page->num_values);
+  auto encoded = encoder.Flush();
+
+  page->body.clear();
+  if (column.nullable)
+    AppendAllDefinedLevels(&page->body, page->num_values);
+  size_t offset = page->body.size();
+  page->body.resize(offset + encoded.second);
+  if (encoded.second > 0)
+    std::memcpy(page->body.data() + offset, encoded.first, encoded.second);
+
+  page->encoding = encoder.encoding();
+  page->uncompressed_size = static_cast<int32_t>(page->body.size());
+  page->codec = Codec::UNCOMPRESSED;
+
+  // Raw values are no longer needed; free them before the page queues up
+  // behind the compressor.
+  std::vector<uint8_t>().swap(page->values);
+}
+
+// FIXED_LEN_BYTE_ARRAY pages are PLAIN. No statistics: their sort order
+// depends on the logical type (signed for DECIMAL, unsigned otherwise).
+static void EncodeFixedLenPage(const ColumnSchema &column,
+                               const WriterOptions &, Page *page) {
+  const size_t width = static_cast<size_t>(column.type_length);
+  if (page->bloom) {
+    page->bloom_hashes.resize(page->num_values);
+    for (int32_t i = 0; i < page->num_values; ++i)
+      page->bloom_hashes[i] =
+          BloomFilter::Hash(page->values.data() + i * width, width);
+    std::sort(page->bloom_hashes.begin(), page->bloom_hashes.end());
+    page->bloom_hashes.erase(
+        std::unique(page->bloom_hashes.begin(), page->bloom_hashes.end()),
+        page->bloom_hashes.end());
+  }
+
+  FixedLenPlainEncoder encoder(column.type_length);
+  encoder.Put(page->values.data(), page->num_values);
+  auto encoded = encoder.Flush();
+
+  page->body.clear();
+  if (column.nullable)
+    AppendAllDefinedLevels(&page->body, page->num_values);
+  page->body.insert(page->body.end(), encoded.first,
+                    encoded.first + encoded.second);
+  page->encoding = encoder.encoding();
+  page->uncompressed_size = static_cast<int32_t>(page->body.size());
+  page->codec = Codec::UNCOMPRESSED;
+  std::vector<uint8_t>().swap(page->values);
+}
+
+PageEncodeFn ResolvePageEncoder(const ColumnSchema &column) {
+  if (column.type == Type::FIXED_LEN_BYTE_ARRAY)
+    return &EncodeFixedLenPage;
+  return VisitFixedWidthType(column.type, [](auto dtype) -> PageEncodeFn {
+    return &EncodeTypedPage<decltype(dtype)>;
+  });
+}
+
+void CompressPage(CodecSelector *codecs, Page *page,
+                  std::vector<uint8_t> *scratch) {
+  bool store = false;
+  Codec codec = codecs->Select(*page, &store);
+  if (codec == Codec::UNCOMPRESSED)
+    return;
+  HPQ_TRACE_SPAN("compress", page->column, page->row_group, page->ordinal);
+  const size_t bound = MaxCompressedSize(codec, page->body.size());
+  if (scratch->size() < bound)
+    scratch->resize(bound);
+  size_t size = CompressBuffer(codec, page->body.data(), page->body.size(),
+                               scratch->data(), store);
+  // Exact-size copy: the page may wait for the rest of its row group.
+  page->body = std::vector<uint8_t>(scratch->data(), scratch->data() + size);
+  page->codec = codec;
+}
+
+void CompressPageGPU(const WriterOptions &options, Page *page) {
+  Codec codec = ParseCodec(options.compression);
+  if (codec == Codec::UNCOMPRESSED)
+    return;
+
+  // Allocate enough space for worst case
+  std::vector<uint8_t> compressed(page->body.size() + 1024);
+  size_t compressed_size =
+      CompressGPU(page->body.data(), page->body.size(), compressed.data(),
+                  compressed.size());
+  if (compressed_size == 0)
+    return; // Failed/unsupported: keep the raw page
+
+  compressed.resize(compressed_size);
+  page->body = std::move(compressed);
+  page->codec = codec;
+}
+
+} // namespace hpq
@@ -0,0 +1,272 @@
+#include "hpq/partitioned_writer.h"
+#include "hpq/encodings/transpose.h"
+#include "hpq/gpu/gpu_compress.h"
+#include "hpq/util/memory_budget.h"
+#include "hpq/util/thread_pool.h"
+#include "hpq/writer/input_convert.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <stdexcept>
+
+namespace hpq {
+
+namespace {
+
+// Fibonacci hashing: a straight-line multiply the compiler vectorizes.
+void HashKeys(const int64_t *keys, size_t n, uint64_t *out) {
+  for (size_t i = 0; i < n; ++i)
+    out[i] = static_cast<uint64_t>(keys[i]) * 0x9E3779B97F4A7C15ull;
+}
+
+} // namespace
+
+class PartitionedWriter::Impl {
+public:
+  Impl(const std::string &base_dir, const Schema &schema, int partition_column,
+       const WriterOptions &options, size_t memory_limit)
+      : base_dir_(base_dir), schema_(schema),
+        partition_column_(partition_column), options_(options) {
+    if (partition_column < 0 ||
+        partition_column >= static_cast<int>(schema.num_columns()))
+      throw std::out_of_range("Partition column index out of range");
+    const ColumnSchema &key = schema.columns()[partition_column];
+    if (key.type != Type::INT32 && key.type != Type::INT64)
+      throw std::runtime_error("Partition column " + key.name +
+                               " must be INT32 or INT64");
+
+    for (size_t c = 0; c < schema.num_columns(); ++c) {
+      if (static_cast<int>(c) == partition_column)
+        continue;
+      const ColumnSchema &col = schema.columns()[c];
+      file_schema_.AddColumn(col);
+      source_columns_.push_back(c);
+      // Logical types are gathered in their input layout; each partition
+      // writer converts them as WriteColumn does.
+      widths_.push_back(ResolveInputConverter(col).input_width);
+    }
+
+    options_.async = true;
+    if (!options_.encode_pool)
+      options_.encode_pool =
+          std::make_shared<ThreadPool>(options.encode_threads);
+    if (!options_.compress_backend)
+      options_.compress_backend =
+          MakeCpuCompressBackend(options.compress_threads);
+    if (!options_.memory_budget)
+      options_.memory_budget = std::make_shared<MemoryBudget>(memory_limit);
+    table_.assign(64, Slot());
+  }
+
+  ~Impl() {
+    // Writers join their pipelines before the shared pool goes away.
+    partitions_.clear();
+  }
+
+  void WriteBatch(const std::vector<const void *> &columns, size_t num_rows) {
+    if (columns.size() != schema_.num_columns())
+      throw std::runtime_error("WriteBatch: expected one pointer per column");
+    if (num_rows > static_cast<size_t>(INT_MAX))
+      throw std::runtime_error("WriteBatch: batch too large");
+    if (num_rows == 0)
+      return;
+
+    LoadKeys(columns[partition_column_], num_rows);
+    hashes_.resize(num_rows);
+    HashKeys(keys_.data(), num_rows, hashes_.data());
+    row_partition_.resize(num_rows);
+    for (size_t i = 0; i < num_rows; ++i)
+      row_partition_[i] = FindOrAddPartition(keys_[i], hashes_[i]);
+
+    // Counting sort of row indices by partition
+    counts_.assign(partitions_.size() + 1, 0);
+    for (size_t i = 0; i < num_rows; ++i)
+      ++counts_[row_partition_[i] + 1];
+    for (size_t p = 1; p < counts_.size(); ++p)
+      counts_[p] += counts_[p - 1];
+    order_.resize(num_rows);
+    cursor_.assign(counts_.begin(), counts_.end() - 1);
+    for (size_t i = 0; i < num_rows; ++i)
+      order_[cursor_[row_partition_[i]]++] = static_cast<uint32_t>(i);
+
+    for (size_t p = 0; p < partitions_.size(); ++p) {
+      const size_t begin = counts_[p];
+      const size_t n = counts_[p + 1] - begin;
+      if (n == 0)
+        continue;
+      ParquetWriter &writer = *partitions_[p].writer;
+      for (size_t j = 0; j < source_columns_.size(); ++j) {
+        scratch_.resize(n * widths_[j]);
+        GatherIndexed(
+            static_cast<const uint8_t *>(columns[source_columns_[j]]),
+            widths_[j], order_.data() + begin, n, scratch_.data());
+        writer.WriteColumn(static_cast<int>(j), scratch_.data(),
+                           static_cast<int>(n));
+      }
+    }
+
+    EnforceBudget();
+  }
+
+  void Close() {
+    // Start every close first so the partitions drain concurrently.
+    std::vector<std::future<void>> done;
+    for (auto &partition : partitions_)
+      done.push_back(partition.writer->CloseAsync());
+    std::exception_ptr error;
+    for (size_t p = 0; p < partitions_.size(); ++p) {
+      try {
+        partitions_[p].writer->Close(); // Joins the pipeline
+        done[p].get();
+      } catch (...) {
+        if (!error)
+          error = std::current_exception();
+      }
+    }
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+  size_t num_partitions() const { return partitions_.size(); }
+
+  size_t buffered_bytes() const { return options_.memory_budget->used(); }
+
+private:
+  struct Partition {
+    int64_t key = 0;
+    std::unique_ptr<ParquetWriter> writer;
+  };
+
+  // Open-addressing key -> partition index table
+  struct Slot {
+    int64_t key = 0;
+    int32_t partition = -1;
+  };
+
+  std::string base_dir_;
+  Schema schema_;
+  int partition_column_;
+  WriterOptions options_;
+
+  Schema file_schema_;
+  std::vector<size_t> source_columns_; // Schema index of each file column
+  std::vector<size_t> widths_;
+  std::vector<Partition> partitions_;
+  std::vector<Slot> table_;
+
+  // Per-batch scratch, kept across calls
+  std::vector<int64_t> keys_;
+  std::vector<uint64_t> hashes_;
+  std::vector<uint32_t> row_partition_;
+  std::vector<size_t> counts_;
+  std::vector<size_t> cursor_;
+  std::vector<uint32_t> order_;
+  std::vector<uint8_t> scratch_;
+
+  void LoadKeys(const void *column, size_t n) {
+    keys_.resize(n);
+    if (schema_.columns()[partition_column_].type == Type::INT64) {
+      std::memcpy(keys_.data(), column, n * sizeof(int64_t));
+      return;
+    }
+    const int32_t *src = static_cast<const int32_t *>(column);
+    for (size_t i = 0; i < n; ++i)
+      keys_[i] = src[i];
+  }
+
+  uint32_t FindOrAddPartition(int64_t key, uint64_t hash) {
+    const size_t mask = table_.size() - 1;
+    for (size_t i = hash >> 32 & mask;; i = (i + 1) & mask) {
+      Slot &slot = table_[i];
+      if (slot.partition < 0) {
+        slot.key = key;
+        slot.partition = static_cast<int32_t>(partitions_.size());
+        AddPartition(key);
+        if (partitions_.size() * 2 > table_.size())
+          GrowTable();
+        return static_cast<uint32_t>(partitions_.size() - 1);
+      }
+      if (slot.key == key)
+        return static_cast<uint32_t>(slot.partition);
+    }
+  }
+
+  void GrowTable() {
+    std::vector<Slot> old(table_.size() * 2);
+    old.swap(table_);
+    const size_t mask = table_.size() - 1;
+    for (const Slot &slot : old) {
+      if (slot.partition < 0)
+        continue;
+      uint64_t hash;
+      HashKeys(&slot.key, 1, &hash);
+      size_t i = hash >> 32 & mask;
+      while (table_[i].partition >= 0)
+        i = (i + 1) & mask;
+      table_[i] = slot;
+    }
+  }
+
+  void AddPartition(int64_t key) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::path(base_dir_) /
+                   (schema_.columns()[partition_column_].name + "=" +
+                    std::to_string(key));
+    fs::create_directories(dir);
+    Partition partition;
+    partition.key = key;
+    partition.writer = std::make_unique<ParquetWriter>(
+        (dir / "part-0.parquet").string(), options_);
+    partition.writer->Init(file_schema_);
+    partitions_.push_back(std::move(partition));
+  }
+
+  // Partitions only honour budget flush requests when they next receive
+  // rows, so after each batch the largest ones are flushed directly until
+  // the budget is back under its threshold.
+  void EnforceBudget() {
+    const MemoryBudget &budget = *options_.memory_budget;
+    if (!budget.over_threshold())
+      return;
+    std::vector<std::pair<size_t, size_t>> sizes; // (bytes, partition)
+    for (size_t p = 0; p < partitions_.size(); ++p)
+      sizes.emplace_back(partitions_[p].writer->buffered_bytes(), p);
+    std::sort(sizes.begin(), sizes.end(), std::greater<>());
+    size_t used = budget.used();
+    for (const auto &[bytes, p] : sizes) {
+      if (used <= budget.flush_at())
+        break;
+      partitions_[p].writer->FlushRowGroup();
+      used -= std::min(used, bytes);
+    }
+  }
+};
+
+PartitionedWriter::PartitionedWriter(const std::string &base_dir,
+                                     const Schema &schema,
+                                     int partition_column,
+                                     const WriterOptions &options,
+                                     size_t memory_limit)
+    : impl_(std::make_unique<Impl>(base_dir, schema, partition_column,
+                                   options, memory_limit)) {}
+
+PartitionedWriter::~PartitionedWriter() = default;
+
+void PartitionedWriter::WriteBatch(const std::vector<const void *> &columns,
+                                   size_t num_rows) {
+  impl_->WriteBatch(columns, num_rows);
+}
+
+void PartitionedWriter::Close() { impl_->Close(); }
+
+size_t PartitionedWriter::num_partitions() const {
+  return impl_->num_partitions();
+}
+
+size_t PartitionedWriter::buffered_bytes() const {
+  return impl_->buffered_bytes();
+}
+
+} // namespace hpq
@@ -0,0 +1,220 @@
+#include "hpq/writer/pipeline.h"
+#include "hpq/util/numa.h"
+#include "hpq/util/trace.h"
+#include <algorithm>
+
+namespace hpq {
+
+WritePipeline::WritePipeline(const Schema &schema,
+                             const WriterOptions &options,
+                             RowGroupAssembler *assembler,
+                             StageTimers *timers, CompressStage *compress)
+    : schema_(schema), options_(options), assembler_(assembler),
+      timers_(timers), compress_(compress),
+      compress_queue_(options.pipeline_queue_depth),
+      write_queue_(options.pipeline_queue_depth),
+      pool_(options.encode_pool.get()) {
+  if (!pool_) {
+    // numa_aware: one encode queue per node, each with at least one encoder
+    const int num_queues =
+        options.numa_aware
+            ? static_cast<int>(NumaTopology::Get().nodes.size())
+            : 1;
+    for (int q = 0; q < num_queues; ++q)
+      encode_queues_.push_back(
+          std::make_unique<BoundedQueue<Page>>(options.pipeline_queue_depth));
+    const int num_encoders = std::max(num_queues, options.encode_threads);
+    encoders_running_ = num_encoders;
+    for (int i = 0; i < num_encoders; ++i)
+      encode_threads_.emplace_back(&WritePipeline::EncodeLoop, this, i);
+  }
+  const int home = CurrentNumaNode();
+  compress_thread_ = std::thread([this, home] {
+    HPQ_TRACE_THREAD("hpq compress");
+    PinToNode(home);
+    CompressLoop();
+  });
+  write_thread_ = std::thread([this, home] {
+    HPQ_TRACE_THREAD("hpq write");
+    PinToNode(home);
+    WriteLoop();
+  });
+}
+
+WritePipeline::~WritePipeline() {
+  if (!finished_)
+    Finish(nullptr);
+  Join();
+}
+
+void WritePipeline::Fail(std::exception_ptr error) {
+  std::lock_guard<std::mutex> lock(error_mutex_);
+  if (!error_)
+    error_ = error;
+  failed_.store(true, std::memory_order_release);
+}
+
+void WritePipeline::Submit(Page page) {
+  if (failed_.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    std::rethrow_exception(error_);
+  }
+  // Spans the wait when the encoders are behind
+  HPQ_TRACE_SPAN("submit", page.column, page.row_group, page.ordinal);
+  if (!pool_) {
+    size_t queue = 0;
+    if (encode_queues_.size() > 1 && page.numa_node >= 0) {
+      const int index = NumaTopology::Get().IndexOf(page.numa_node);
+      queue = static_cast<size_t>(std::max(index, 0)) % encode_queues_.size();
+    }
+    encode_queues_[queue]->Push(std::move(page));
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    ++pending_;
+  }
+  pool_->Submit([this, page = std::move(page)]() mutable {
+    EncodePage(page);
+    ReleasePending();
+  });
+}
+
+void WritePipeline::ReleasePending() {
+  // The close happens under the lock so Join() cannot return, and the
+  // pipeline be destroyed, while a pool task is still inside this call.
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  if (--pending_ == 0) {
+    compress_queue_.Close();
+    pending_done_.notify_all();
+  }
+}
+
+void WritePipeline::Finish(DrainedCallback on_drained) {
+  // Published to the write thread by the queue close chain below.
+  on_drained_ = std::move(on_drained);
+  finished_ = true;
+  if (pool_) {
+    ReleasePending();
+  } else {
+    for (auto &queue : encode_queues_)
+      queue->Close();
+  }
+}
+
+void WritePipeline::Join() {
+  if (pool_) {
+    std::unique_lock<std::mutex> lock(pending_mutex_);
+    pending_done_.wait(lock, [this] { return pending_ == 0; });
+  }
+  for (auto &t : encode_threads_) {
+    if (t.joinable())
+      t.join();
+  }
+  if (compress_thread_.joinable())
+    compress_thread_.join();
+  if (write_thread_.joinable())
+    write_thread_.join();
+}
+
+void WritePipeline::PinToNode(int node) {
+  if (options_.pin_threads != ThreadPinning::kNone && PinThreadToNode(node))
+    timers_->threads_pinned.fetch_add(1, std::memory_order_relaxed);
+}
+
+void WritePipeline::EncodeLoop(int worker) {
+  // Encoder i serves node i % nodes; with kCore the encoders of a node
+  // take its CPUs in turn.
+  HPQ_TRACE_THREAD("hpq encode " + std::to_string(worker));
+  const NumaTopology &topology = NumaTopology::Get();
+  const size_t index = worker % topology.nodes.size();
+  if (options_.pin_threads == ThreadPinning::kCore) {
+    const std::vector<int> &cpus = topology.cpus[index];
+    const size_t slot = worker / topology.nodes.size();
+    if (PinThreadToCpu(cpus[slot % cpus.size()]))
+      timers_->threads_pinned.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    PinToNode(topology.nodes[index]);
+  }
+
+  BoundedQueue<Page> &queue = *encode_queues_[worker % encode_queues_.size()];
+  Page page;
+  while (queue.Pop(page))
+    EncodePage(page);
+  // The last encoder out closes the next stage.
+  if (encoders_running_.fetch_sub(1) == 1)
+    compress_queue_.Close();
+}
+
+void WritePipeline::EncodePage(Page &page) {
+  if (failed_.load(std::memory_order_acquire))
+    return; // Drain without work so producers never block forever
+  try {
+    if (page.numa_node >= 0)
+      RecordNumaLocality(page.values.data(), timers_);
+    {
+      HPQ_TRACE_SPAN("encode", page.column, page.row_group, page.ordinal);
+      ScopedStageTimer timer(&timers_->encode_ns);
+      page.encode(schema_.columns()[page.column], options_, &page);
+    }
+    compress_queue_.Push(std::move(page));
+  } catch (...) {
+    Fail(std::current_exception());
+  }
+}
+
+void WritePipeline::CompressLoop() {
+  Page page;
+  std::vector<Page> ready;
+  while (compress_queue_.Pop(page)) {
+    if (failed_.load(std::memory_order_acquire))
+      continue;
+    try {
+      {
+        ScopedStageTimer timer(&timers_->compress_ns);
+        compress_->Add(std::move(page), &ready);
+      }
+      for (Page &p : ready)
+        write_queue_.Push(std::move(p));
+      ready.clear();
+    } catch (...) {
+      Fail(std::current_exception());
+    }
+  }
+  if (!failed_.load(std::memory_order_acquire)) {
+    try {
+      compress_->Flush(&ready);
+      for (Page &p : ready)
+        write_queue_.Push(std::move(p));
+    } catch (...) {
+      Fail(std::current_exception());
+    }
+  }
+  write_queue_.Close();
+}
+
+void WritePipeline::WriteLoop() {
+  Page page;
+  while (write_queue_.Pop(page)) {
+    if (failed_.load(std::memory_order_acquire))
+      continue;
+    try {
+      timers_->pages.fetch_add(1, std::memory_order_relaxed);
+      HPQ_TRACE_SPAN("assemble", page.column, page.row_group, page.ordinal);
+      ScopedStageTimer timer(&timers_->write_ns);
+      assembler_->AddPage(std::move(page));
+    } catch (...) {
+      Fail(std::current_exception());
+    }
+  }
+  if (on_drained_) {
+    std::exception_ptr error;
+    {
+      std::lock_guard<std::mutex> lock(error_mutex_);
+      error = error_;
+    }
+    on_drained_(error);
+  }
+}
+
+} // namespace hpq
@@ -0,0 +1,256 @@
+#include "hpq/writer/row_group_assembler.h"
+#include "hpq/bloom_filter.h"
+#include "hpq/format/statistics.h"
+#include "hpq/util/trace.h"
+#include "hpq/writer.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace hpq {
+
+RowGroupAssembler::RowGroupAssembler(const Schema &schema,
+                                     const WriterOptions &options,
+                                     OutputStream *out, MemoryConsumer *memory)
+    : schema_(schema), options_(options), out_(out), memory_(memory) {
+  metadata_.schema = schema.columns();
+}
+
+void RowGroupAssembler::ContinueFrom(const FileMetaData &existing) {
+  metadata_.row_groups = existing.row_groups;
+  metadata_.num_rows = existing.num_rows;
+  first_new_row_group_ = existing.row_groups.size();
+}
+
+void RowGroupAssembler::AddPage(Page page) {
+  auto &chunks = pending_[page.row_group];
+  if (chunks.empty())
+    chunks.resize(schema_.num_columns());
+
+  ChunkPages &chunk = chunks[page.column];
+  if (page.last_in_chunk)
+    chunk.expected = page.ordinal + 1;
+  chunk.pages.push_back(std::move(page));
+
+  // Row groups are written strictly in order.
+  for (auto it = pending_.find(next_row_group_);
+       it != pending_.end() && IsComplete(it->second);
+       it = pending_.find(next_row_group_)) {
+    WriteRowGroup(it->second);
+    pending_.erase(it);
+    ++next_row_group_;
+  }
+}
+
+bool RowGroupAssembler::IsComplete(
+    const std::vector<ChunkPages> &chunks) const {
+  for (const auto &chunk : chunks) {
+    if (chunk.expected < 0 ||
+        static_cast<int>(chunk.pages.size()) != chunk.expected)
+      return false;
+  }
+  return true;
+}
+
+void RowGroupAssembler::WriteRowGroup(std::vector<ChunkPages> &chunks) {
+  RowGroupMetaData rg;
+  rg.ordinal = static_cast<int16_t>(metadata_.row_groups.size());
+  HPQ_TRACE_SPAN("write row group", -1, next_row_group_);
+  rg.file_offset = out_->Tell();
+  rg.sorting_columns = sorting_columns_;
+
+  std::vector<uint8_t> header_buf; // Every page header of a chunk
+  std::vector<size_t> header_ends;
+  std::vector<iovec> iov;
+  size_t raw_bytes = 0;
+  std::vector<ChunkIndex> &index = page_index_.emplace_back(chunks.size());
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    HPQ_TRACE_SPAN("write column chunk", static_cast<int>(c),
+                   next_row_group_);
+    auto &pages = chunks[c].pages;
+    std::sort(pages.begin(), pages.end(), [](const Page &a, const Page &b) {
+      return a.ordinal < b.ordinal;
+    });
+
+    const ColumnSchema &col = schema_.columns()[c];
+    ColumnChunkMetaData meta;
+    meta.type = col.type;
+    meta.path_in_schema = {col.name};
+    meta.codec = pages.front().codec;
+    meta.data_page_offset = out_->Tell();
+    Statistics stats;
+    stats.null_count = 0;
+    ChunkIndex &chunk_index = index[c];
+    int64_t offset = meta.data_page_offset;
+    header_buf.clear();
+    header_ends.clear();
+
+    for (const Page &page : pages) {
+      if (page.codec != meta.codec)
+        throw std::runtime_error("Mixed page codecs in column chunk " +
+                                 col.name);
+
+      PageHeader header;
+      header.uncompressed_page_size = page.uncompressed_size;
+      header.compressed_page_size = static_cast<int32_t>(page.body.size());
+      header.data_page_header.num_values = page.num_values;
+      header.data_page_header.encoding = page.encoding;
+      header.crc = page.crc;
+
+      const size_t header_begin = header_buf.size();
+      SerializePageHeader(header, &header_buf);
+      header_ends.push_back(header_buf.size());
+      const size_t header_size = header_buf.size() - header_begin;
+      const size_t page_bytes = header_size + page.body.size();
+      chunk_index.offset_index.page_locations.push_back(
+          {offset, static_cast<int32_t>(page_bytes), meta.num_values});
+      offset += static_cast<int64_t>(page_bytes);
+
+      raw_bytes += page.raw_bytes;
+      meta.num_values += page.num_values;
+      meta.total_uncompressed_size += header_size + page.uncompressed_size;
+      meta.total_compressed_size += header_size + page.body.size();
+      if (std::find(meta.encodings.begin(), meta.encodings.end(),
+                    page.encoding) == meta.encodings.end())
+        meta.encodings.push_back(page.encoding);
+
+      if (!page.has_stats) {
+        chunk_index.has_column_index = false;
+        continue;
+      }
+      chunk_index.column_index.min_values.push_back(page.min_value);
+      chunk_index.column_index.max_values.push_back(page.max_value);
+      if (!stats.min_value ||
+          CompareValues(col.type, page.min_value, *stats.min_value) < 0)
+        stats.min_value = page.min_value;
+      if (!stats.max_value ||
+          CompareValues(col.type, page.max_value, *stats.max_value) > 0)
+        stats.max_value = page.max_value;
+    }
+    // The chunk goes out as one gathered write of header, body, header, ...
+    // so no page is copied just to put its header in front of it.
+    iov.clear();
+    size_t header_begin = 0;
+    for (size_t p = 0; p < pages.size(); ++p) {
+      iov.push_back({header_buf.data() + header_begin,
+                     header_ends[p] - header_begin});
+      iov.push_back({pages[p].body.data(), pages[p].body.size()});
+      header_begin = header_ends[p];
+    }
+    out_->Writev(iov.data(), static_cast<int>(iov.size()));
+
+    meta.statistics = std::move(stats);
+    if (col.nullable &&
+        std::find(meta.encodings.begin(), meta.encodings.end(),
+                  Encoding::RLE) == meta.encodings.end())
+      meta.encodings.push_back(Encoding::RLE); // Definition levels
+
+    rg.num_rows = meta.num_values;
+    rg.total_byte_size += meta.total_uncompressed_size;
+    rg.total_compressed_size += meta.total_compressed_size;
+    rg.columns.push_back(std::move(meta));
+  }
+
+  for (size_t c = 0; c < chunks.size(); ++c) {
+    if (!chunks[c].pages.empty() && chunks[c].pages.front().bloom)
+      WriteBloomFilter(chunks, c, &rg.columns[c]);
+  }
+
+  metadata_.num_rows += rg.num_rows;
+  metadata_.row_groups.push_back(std::move(rg));
+  if (memory_)
+    memory_->Release(raw_bytes);
+}
+
+void RowGroupAssembler::WriteBloomFilter(std::vector<ChunkPages> &chunks,
+                                         size_t column,
+                                         ColumnChunkMetaData *meta) {
+  // Pages hold sorted distinct hashes; merging them gives the chunk's exact
+  // distinct count, so the filter is sized for the data it holds.
+  std::vector<uint64_t> hashes;
+  for (Page &page : chunks[column].pages) {
+    size_t mid = hashes.size();
+    hashes.insert(hashes.end(), page.bloom_hashes.begin(),
+                  page.bloom_hashes.end());
+    std::inplace_merge(hashes.begin(), hashes.begin() + mid, hashes.end());
+    std::vector<uint64_t>().swap(page.bloom_hashes);
+  }
+  hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+  BloomFilter filter(static_cast<int>(hashes.size()),
+                     options_.bloom_filter_fpp);
+  for (uint64_t h : hashes)
+    filter.InsertHash(h);
+
+  std::vector<uint8_t> buf;
+  SerializeBloomFilterHeader(static_cast<int32_t>(filter.num_bytes()), &buf);
+  std::vector<uint8_t> bitset = filter.Serialize();
+  buf.insert(buf.end(), bitset.begin(), bitset.end());
+  meta->bloom_filter_offset = static_cast<int64_t>(out_->Tell());
+  meta->bloom_filter_length = static_cast<int32_t>(buf.size());
+  out_->Write(buf.data(), buf.size());
+}
+
+static BoundaryOrder ComputeBoundaryOrder(Type type, const ColumnIndex &index) {
+  bool ascending = true;
+  bool descending = true;
+  for (size_t i = 1; i < index.min_values.size(); ++i) {
+    int min_cmp = CompareValues(type, index.min_values[i - 1],
+                                index.min_values[i]);
+    int max_cmp = CompareValues(type, index.max_values[i - 1],
+                                index.max_values[i]);
+    ascending &= min_cmp <= 0 && max_cmp <= 0;
+    descending &= min_cmp >= 0 && max_cmp >= 0;
+  }
+  if (ascending)
+    return BoundaryOrder::ASCENDING;
+  return descending ? BoundaryOrder::DESCENDING : BoundaryOrder::UNORDERED;
+}
+
+// Column indexes for every new chunk, then offset indexes, between the last
+// row group and the footer (the layout the format recommends). Appended
+// files keep the indexes of earlier row groups where they were written.
+void RowGroupAssembler::WritePageIndex() {
+  std::vector<uint8_t> buf;
+  for (size_t rg = 0; rg < page_index_.size(); ++rg) {
+    for (size_t c = 0; c < page_index_[rg].size(); ++c) {
+      ChunkIndex &chunk = page_index_[rg][c];
+      if (!chunk.has_column_index)
+        continue;
+      ColumnIndex &ci = chunk.column_index;
+      const size_t pages = ci.min_values.size();
+      ci.null_pages.assign(pages, false);
+      ci.null_counts.assign(pages, 0);
+      ci.boundary_order =
+          ComputeBoundaryOrder(schema_.columns()[c].type, ci);
+      buf.clear();
+      SerializeColumnIndex(ci, &buf);
+      ColumnChunkMetaData &meta =
+          metadata_.row_groups[first_new_row_group_ + rg].columns[c];
+      meta.column_index_offset = static_cast<int64_t>(out_->Tell());
+      meta.column_index_length = static_cast<int32_t>(buf.size());
+      out_->Write(buf.data(), buf.size());
+    }
+  }
+  for (size_t rg = 0; rg < page_index_.size(); ++rg) {
+    for (size_t c = 0; c < page_index_[rg].size(); ++c) {
+      buf.clear();
+      SerializeOffsetIndex(page_index_[rg][c].offset_index, &buf);
+      ColumnChunkMetaData &meta =
+          metadata_.row_groups[first_new_row_group_ + rg].columns[c];
+      meta.offset_index_offset = static_cast<int64_t>(out_->Tell());
+      meta.offset_index_length = static_cast<int32_t>(buf.size());
+      out_->Write(buf.data(), buf.size());
+    }
+  }
+  page_index_.clear();
+}
+
+FileMetaData RowGroupAssembler::Finish() {
+  if (!pending_.empty())
+    throw std::runtime_error("Incomplete row group at close");
+  if (options_.write_page_index)
+    WritePageIndex();
+  return metadata_;
+}
+
+} // namespace hpq
@@ -0,0 +1,91 @@
+#include "hpq/writer/row_sort.h"
+#include "hpq/type_traits.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
+
+namespace hpq {
+
+// Order-preserving unsigned image of a value.
+template <typename DType>
+static uint64_t NormalizeKey(const uint8_t *value) {
+  using c_type = typename DType::c_type;
+  c_type v;
+  std::memcpy(&v, value, sizeof(v));
+  if constexpr (std::is_same_v<DType, BooleanType>) {
+    return v != 0;
+  } else if constexpr (DType::is_integer) {
+    using unsigned_type = std::make_unsigned_t<c_type>;
+    constexpr unsigned_type sign = unsigned_type(1) << (8 * sizeof(v) - 1);
+    return static_cast<unsigned_type>(v) ^ sign;
+  } else {
+    using bits_type =
+        std::conditional_t<sizeof(c_type) == 4, uint32_t, uint64_t>;
+    constexpr bits_type sign = bits_type(1) << (8 * sizeof(v) - 1);
+    bits_type bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return (bits & sign) ? ~bits : bits | sign;
+  }
+}
+
+// keys[i] = normalized key of row perm[i]; returns the key width in bytes.
+static size_t GatherKeys(const SortKey &key, const uint32_t *perm, size_t n,
+                         uint64_t *keys) {
+  return VisitFixedWidthType(key.type, [&](auto dtype) {
+    using DType = decltype(dtype);
+    constexpr size_t width = DType::byte_width;
+    for (size_t i = 0; i < n; ++i)
+      keys[i] = NormalizeKey<DType>(key.values + size_t(perm[i]) * width);
+    return width;
+  });
+}
+
+std::vector<uint32_t> SortPermutation(const std::vector<SortKey> &keys,
+                                      size_t num_rows) {
+  std::vector<uint32_t> perm(num_rows);
+  std::iota(perm.begin(), perm.end(), 0u);
+  if (num_rows < 2)
+    return perm;
+
+  std::vector<uint32_t> perm_out(num_rows);
+  std::vector<uint64_t> key(num_rows);
+  std::vector<uint64_t> key_out(num_rows);
+  for (auto k = keys.rbegin(); k != keys.rend(); ++k) {
+    // Keys travel with the permutation, so each pass reads sequentially.
+    const size_t width = GatherKeys(*k, perm.data(), num_rows, key.data());
+
+    // Histograms of every byte position, in one read of the keys
+    std::vector<std::array<uint32_t, 256>> counts(width);
+    for (auto &c : counts)
+      c.fill(0);
+    for (size_t i = 0; i < num_rows; ++i) {
+      for (size_t b = 0; b < width; ++b)
+        ++counts[b][(key[i] >> (8 * b)) & 0xFF];
+    }
+
+    for (size_t b = 0; b < width; ++b) {
+      auto &count = counts[b];
+      if (std::find(count.begin(), count.end(), num_rows) != count.end())
+        continue; // Every row has the same byte here
+      uint32_t offsets[256];
+      uint32_t sum = 0;
+      for (int v = 0; v < 256; ++v) {
+        offsets[v] = sum;
+        sum += count[v];
+      }
+      const int shift = static_cast<int>(8 * b);
+      for (size_t i = 0; i < num_rows; ++i) {
+        uint32_t pos = offsets[(key[i] >> shift) & 0xFF]++;
+        key_out[pos] = key[i];
+        perm_out[pos] = perm[i];
+      }
+      key.swap(key_out);
+      perm.swap(perm_out);
+    }
+  }
+  return perm;
+}
+
+} // namespace hpq
@@ -1,82 +1,674 @@
 #include "hpq/writer.h"
 #include "hpq/encodings/adaptive.h"
-#include "hpq/encodings/encoding_base.h"
-#include "hpq/gpu/gpu_compress.h"
-#include <iostream>
+#include "hpq/encodings/transpose.h"
+#include "hpq/format/parquet_layout.h"
+#include "hpq/io/file_writer.h"
+#include "hpq/util/memory_budget.h"
+#include "hpq/util/numa.h"
+#include "hpq/util/trace.h"
+#include "hpq/writer/codec_selector.h"
+#include "hpq/writer/compress_stage.h"
+#include "hpq/writer/input_convert.h"
+#include "hpq/writer/page.h"
+#include "hpq/writer/pipeline.h"
+#include "hpq/writer/row_group_assembler.h"
+#include "hpq/writer/row_sort.h"
+#include "hpq/writer/stage_timers.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unistd.h>
 #include <vector>
 
 namespace hpq {
 
+static size_t ValueWidth(const ColumnSchema &col) {
+  switch (col.type) {
+  case Type::BOOLEAN:
+    return 1; // One byte per value on input
+  case Type::INT32:
+  case Type::FLOAT:
+    return 4;
+  case Type::INT64:
+  case Type::DOUBLE:
+    return 8;
+  case Type::FIXED_LEN_BYTE_ARRAY:
+    return static_cast<size_t>(col.type_length);
+  case Type::BYTE_ARRAY:
+    break;
+  }
+  throw std::runtime_error("Unsupported column type for " + col.name);
+}
+
 class ParquetWriter::Impl {
 public:
   Impl(const std::string &filename, const WriterOptions &options)
-      : filename_(filename), options_(options) {}
+      : filename_(filename), options_(options),
+        memory_(options.memory_budget.get()),
+        file_(std::make_shared<FileWriter>()), out_(file_) {}
+
+  Impl(std::shared_ptr<OutputStream> out, const WriterOptions &options)
+      : filename_("output stream"), options_(options),
+        memory_(options.memory_budget.get()), out_(std::move(out)) {
+    if (!out_)
+      throw std::invalid_argument("ParquetWriter: null output stream");
+    // These act on a named file; a stream has none to reopen or map.
+    if (options.append || options.use_mmap || options.use_direct_io)
+      throw std::invalid_argument("ParquetWriter: append, use_mmap and "
+                                  "use_direct_io need a file name, not an "
+                                  "output stream");
+  }
+
+  ~Impl() {
+    // Joins the stage threads while the assembler and file are still alive.
+    pipeline_.reset();
+  }
 
   void Init(const Schema &schema) {
     schema_ = schema;
-    for (const auto &col : schema.columns()) {
-      // Use AdaptiveEncoder for all columns for now
-      encoders_.push_back(std::make_unique<AdaptiveEncoder>(col.type));
+    columns_.assign(schema.num_columns(), ColumnState());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      columns_[i].width = ValueWidth(schema.columns()[i]);
+      columns_[i].input = ResolveInputConverter(schema.columns()[i]);
+      columns_[i].encode = ResolvePageEncoder(schema.columns()[i]);
+      columns_[i].page_capacity = std::max<int64_t>(
+          1, static_cast<int64_t>(options_.data_page_size /
+                                  std::max<size_t>(1, columns_[i].width)));
+      const auto &bloom = options_.bloom_filter_columns;
+      columns_[i].bloom =
+          schema.columns()[i].type != Type::BOOLEAN &&
+          std::find(bloom.begin(), bloom.end(), schema.columns()[i].name) !=
+              bloom.end();
+      if (options_.reuse_encoding_decisions)
+        columns_[i].adaptive = std::make_shared<AdaptiveDecisionCache>();
+      if (options_.numa_aware) {
+        const auto &nodes = NumaTopology::Get().nodes;
+        columns_[i].numa_node = nodes[i % nodes.size()];
+      }
+    }
+
+    ResolveSortKeys();
+    if (options_.concurrent_columns && !sort_keys_.empty())
+      throw std::runtime_error("sort_by cannot be used with "
+                               "concurrent_columns");
+
+    FileWriter::Mode mode = FileWriter::Mode::kWrite;
+    size_t block_size = 64 << 20;
+    if (options_.use_direct_io) {
+      mode = FileWriter::Mode::kDirect;
+      block_size = options_.direct_buffer_size;
+    } else if (options_.use_mmap) {
+      mode = FileWriter::Mode::kMmap;
+      block_size = options_.mmap_extent_size;
+    }
+    assembler_ = std::make_unique<RowGroupAssembler>(
+        schema_, options_, out_.get(), &memory_);
+    std::vector<SortingColumn> sorting;
+    for (int c : sort_keys_)
+      sorting.push_back({c, false, false});
+    assembler_->SetSortingColumns(std::move(sorting));
+    codecs_ = std::make_unique<CodecSelector>(options_);
+    compress_ = std::make_unique<CompressStage>(schema_.num_columns(),
+                                                options_, codecs_.get());
+    int64_t footer_offset = 0;
+    if (options_.append && ReadExistingFooter(&footer_offset)) {
+      file_->OpenAt(filename_, footer_offset, mode, block_size);
+    } else {
+      if (file_)
+        file_->Open(filename_, mode, block_size);
+      WriteFileHeader(*out_);
+    }
+    opened_ = true;
+    if (options_.async) {
+      pipeline_ =
+          std::make_unique<WritePipeline>(schema_, options_, assembler_.get(),
+                                          &timers_, compress_.get());
     }
   }
 
   void WriteColumn(int col_idx, const void *values, int num_values) {
-    if (col_idx < 0 || col_idx >= static_cast<int>(encoders_.size())) {
+    if (col_idx < 0 || col_idx >= static_cast<int>(columns_.size())) {
       return;
     }
-    encoders_[col_idx]->Put(values, num_values);
+    HPQ_TRACE_SPAN("WriteColumn", col_idx);
+    const uint8_t *src = static_cast<const uint8_t *>(values);
+    const ColumnState &state = columns_[col_idx];
+    const InputConverter &input = state.input;
+    const int type_length = schema_.columns()[col_idx].type_length;
+    if (input.check)
+      input.check(schema_.columns()[col_idx], src, input.input_width,
+                  num_values);
+    if (input.convert) {
+      Stage(col_idx, num_values,
+            [src, &input, type_length](uint8_t *dst, int64_t start,
+                                       int64_t count) {
+              input.convert(src + start * input.input_width,
+                            input.input_width, count, type_length, dst);
+            });
+    } else {
+      const size_t width = state.width;
+      Stage(col_idx, num_values,
+            [src, width](uint8_t *dst, int64_t start, int64_t count) {
+              std::memcpy(dst, src + start * width, count * width);
+            });
+    }
+    if (options_.concurrent_columns)
+      return; // The rest looks at other columns
+    EmitSortedRowGroups();
+    ServiceFlushRequest();
   }
 
-  void Close() {
-    std::cout << "Closing writer for " << filename_ << std::endl;
-    for (size_t i = 0; i < encoders_.size(); ++i) {
-      auto result = encoders_[i]->Flush();
-
-      // Compression
-      std::vector<uint8_t> compressed_buffer;
-      const uint8_t *data_to_write = result.first;
-      size_t size_to_write = result.second;
-
-      if (options_.use_gpu_compression) {
-        // Allocate enough space for worst case
-        compressed_buffer.resize(size_to_write + 1024);
-        size_t compressed_size = hpq::CompressGPU(result.first, result.second,
-                                                  compressed_buffer.data(),
-                                                  compressed_buffer.size());
-
-        if (compressed_size > 0) {
-          std::cout << "Column " << i << " GPU Compressed: " << result.second
-                    << " -> " << compressed_size << " bytes." << std::endl;
-          data_to_write = compressed_buffer.data();
-          size_to_write = compressed_size;
-        } else {
-          std::cout << "Column " << i
-                    << " GPU Compression failed/unsupported. Using raw."
-                    << std::endl;
+  void WriteRows(const void *rows, size_t stride, size_t num_rows) {
+    const uint8_t *base = static_cast<const uint8_t *>(rows);
+    for (size_t c = 0; c < columns_.size(); ++c) {
+      const ColumnSchema &col = schema_.columns()[c];
+      const InputConverter &input = columns_[c].input;
+      if (col.field_offset < 0 ||
+          static_cast<size_t>(col.field_offset) + input.input_width > stride)
+        throw std::runtime_error("WriteRows: column " + col.name +
+                                 " has no valid field offset");
+      if (input.check)
+        input.check(col, base + col.field_offset, stride, num_rows);
+    }
+
+    // Cache-blocked transposition: each tile of rows stays hot in L1/L2
+    // while every column gathers its field from it straight into the page
+    // staging buffers.
+    const size_t tile_rows = std::max<size_t>(64, kTransposeTileBytes / stride);
+    for (size_t row = 0; row < num_rows; row += tile_rows) {
+      const size_t n = std::min(tile_rows, num_rows - row);
+      const uint8_t *tile = base + row * stride;
+      for (size_t c = 0; c < columns_.size(); ++c) {
+        const size_t width = columns_[c].width;
+        const uint8_t *field = tile + schema_.columns()[c].field_offset;
+        if (auto convert = columns_[c].input.convert) {
+          const int type_length = schema_.columns()[c].type_length;
+          Stage(static_cast<int>(c), static_cast<int64_t>(n),
+                [field, stride, convert, type_length](
+                    uint8_t *dst, int64_t start, int64_t count) {
+                  convert(field + start * stride, stride, count, type_length,
+                          dst);
+                });
+          continue;
         }
-      } else {
-        std::cout << "Column " << i << " encoded " << result.second << " bytes."
-                  << std::endl;
+        Stage(static_cast<int>(c), static_cast<int64_t>(n),
+              [field, stride, width](uint8_t *dst, int64_t start,
+                                     int64_t count) {
+                GatherField(field + start * stride, stride, width, count,
+                            dst);
+              });
       }
+      EmitSortedRowGroups();
+      ServiceFlushRequest();
+    }
+  }
+
+  std::future<void> CloseAsync(CloseCallback on_complete) {
+    auto promise = std::make_shared<std::promise<void>>();
+    std::future<void> done = promise->get_future();
+    if (closed_ || !opened_) {
+      closed_ = true;
+      promise->set_value();
+      return done;
+    }
+    closed_ = true;
 
-      // In real writer, we would write 'data_to_write' of 'size_to_write' to
-      // disk here.
-      (void)data_to_write; // Silence unused warning
-      (void)size_to_write;
+    std::exception_ptr producer_error;
+    try {
+      FlushStagedPages();
+    } catch (...) {
+      producer_error = std::current_exception();
     }
+
+    // Runs on the write stage thread in async mode.
+    auto complete = [this, promise, on_complete,
+                     producer_error](std::exception_ptr error) {
+      if (!error)
+        error = producer_error;
+      if (!error) {
+        try {
+          FinishFile();
+        } catch (...) {
+          error = std::current_exception();
+        }
+      }
+      if (on_complete)
+        on_complete(error);
+      if (error)
+        promise->set_exception(error);
+      else
+        promise->set_value();
+    };
+
+    if (pipeline_)
+      pipeline_->Finish(complete);
+    else
+      complete(nullptr);
+    return done;
+  }
+
+  void Close() {
+    std::future<void> done = CloseAsync(nullptr);
+    done.wait();
+    if (pipeline_)
+      pipeline_->Join();
+    done.get();
+  }
+
+  void FlushRowGroup() {
+    if (closed_ || columns_.empty())
+      return;
+    FlushStagedPages();
+  }
+
+  size_t buffered_bytes() const { return memory_.reserved(); }
+
+  WriterStats stats() const {
+    WriterStats stats;
+    stats.pages = timers_.pages.load();
+    stats.pages_compressed = codecs_ ? codecs_->pages_compressed() : 0;
+    stats.encode_seconds = timers_.encode_ns.load() * 1e-9;
+    stats.compress_seconds = timers_.compress_ns.load() * 1e-9;
+    stats.write_seconds = timers_.write_ns.load() * 1e-9;
+    stats.pages_numa_local = timers_.numa_local_pages.load();
+    stats.pages_numa_remote = timers_.numa_remote_pages.load();
+    stats.threads_pinned = timers_.threads_pinned.load();
+    for (const ColumnState &state : columns_) {
+      if (state.adaptive) {
+        stats.encoding_analyses += state.adaptive->analyses();
+        stats.encoding_decisions_reused += state.adaptive->reuses();
+      }
+    }
+    return stats;
   }
 
 private:
+  struct ColumnState {
+    size_t width = 0; // Stored physical value width
+    InputConverter input;
+    PageEncodeFn encode = nullptr;
+    int64_t page_capacity = 0;
+    std::vector<uint8_t> staging;
+    int64_t staged_values = 0;
+    int64_t total_values = 0;
+    int64_t rg_values = 0; // Values in the current row group
+    int64_t row_group = 0;
+    int next_ordinal = 0;
+    size_t reserved_bytes = 0; // Charged to memory_ for the staging buffer
+    bool bloom = false;
+    int numa_node = -1; // numa_aware: node the staging buffers are bound to
+    std::shared_ptr<AdaptiveDecisionCache> adaptive;
+
+    // sort_by: input held until every column has a row group of it
+    std::vector<uint8_t> sort_buffer;
+    int64_t sort_begin = 0; // Rows of sort_buffer already emitted
+    int64_t sort_rows = 0;  // Rows buffered, not yet emitted
+
+    // concurrent_columns, sync: encoded pages of the current chunk
+    std::vector<Page> encoded;
+  };
+
+  // concurrent_columns: finished column chunks of one row group.
+  struct RowGroupBarrier {
+    std::vector<Page> pages;
+    size_t arrived = 0;
+  };
+
   std::string filename_;
   WriterOptions options_;
+  MemoryConsumer memory_;
+  bool flush_pending_ = false;
   Schema schema_;
-  std::vector<std::unique_ptr<Encoder>> encoders_;
+  std::vector<ColumnState> columns_;
+  std::shared_ptr<FileWriter> file_; // Null when writing to a stream
+  std::shared_ptr<OutputStream> out_;
+  bool opened_ = false; // Header written
+  std::unique_ptr<RowGroupAssembler> assembler_;
+  std::unique_ptr<CodecSelector> codecs_;
+  std::unique_ptr<CompressStage> compress_;
+  std::vector<Page> ready_; // Sync mode: compressed, not yet assembled
+  std::unique_ptr<WritePipeline> pipeline_;
+  StageTimers timers_;
+  bool closed_ = false;
+
+  std::vector<int> sort_keys_; // Column indices, most significant first
+
+  std::mutex barrier_mutex_; // Taken once per column chunk
+  std::map<int64_t, RowGroupBarrier> barriers_;
+  std::mutex finish_mutex_; // compress_, assembler_ and ready_
+
+  static constexpr size_t kTransposeTileBytes = 32 * 1024;
+  static constexpr int64_t kSortTileRows = 4096;
+
+  // Rows written to a column so far, including rows held for sorting.
+  static int64_t RowsIn(const ColumnState &state) {
+    return state.total_values + state.sort_rows;
+  }
+
+  void ResolveSortKeys() {
+    sort_keys_.clear();
+    for (const std::string &name : options_.sort_by) {
+      const auto &columns = schema_.columns();
+      auto it = std::find_if(columns.begin(), columns.end(),
+                             [&](const ColumnSchema &c) {
+                               return c.name == name;
+                             });
+      if (it == columns.end())
+        throw std::runtime_error("sort_by: no column named " + name);
+      if (it->type == Type::BYTE_ARRAY ||
+          it->type == Type::FIXED_LEN_BYTE_ARRAY)
+        throw std::runtime_error("sort_by: cannot sort by column " + name);
+      sort_keys_.push_back(static_cast<int>(it - columns.begin()));
+    }
+    if (!sort_keys_.empty() && options_.row_group_size >= (1u << 31))
+      throw std::runtime_error("sort_by: row_group_size must be below 2^31");
+  }
+
+  // Input goes to the page staging buffers, or with sort_by to the column's
+  // sort buffer.
+  template <typename Fill>
+  void Stage(int col_idx, int64_t count, const Fill &fill) {
+    if (sort_keys_.empty()) {
+      Append(col_idx, count, fill);
+      return;
+    }
+    ColumnState &state = columns_[col_idx];
+    const size_t offset = state.sort_buffer.size();
+    const size_t bytes = count * state.width;
+    state.sort_buffer.resize(offset + bytes);
+    fill(state.sort_buffer.data() + offset, 0, count);
+    state.sort_rows += count;
+    memory_.Reserve(bytes);
+  }
+
+  // sort_by: emits every full row group that all columns have buffered.
+  void EmitSortedRowGroups() {
+    if (sort_keys_.empty())
+      return;
+    const int64_t rg_size = static_cast<int64_t>(options_.row_group_size);
+    for (;;) {
+      int64_t ready = columns_.front().sort_rows;
+      for (const auto &state : columns_)
+        ready = std::min(ready, state.sort_rows);
+      if (ready < rg_size)
+        return;
+      EmitSorted(rg_size);
+    }
+  }
+
+  // Sorts the next `rows` buffered rows by the sort keys and feeds them to
+  // the page staging buffers in that order.
+  void EmitSorted(int64_t rows) {
+    std::vector<SortKey> keys;
+    for (int c : sort_keys_) {
+      const ColumnState &state = columns_[c];
+      keys.push_back({schema_.columns()[c].type,
+                      state.sort_buffer.data() +
+                          state.sort_begin * state.width});
+    }
+    const std::vector<uint32_t> perm = SortPermutation(keys, rows);
+
+    // Cache-blocked: a tile of the permutation stays hot while every
+    // column gathers through it.
+    for (int64_t row = 0; row < rows; row += kSortTileRows) {
+      const int64_t n = std::min(kSortTileRows, rows - row);
+      const uint32_t *indices = perm.data() + row;
+      for (size_t c = 0; c < columns_.size(); ++c) {
+        const size_t width = columns_[c].width;
+        const uint8_t *src =
+            columns_[c].sort_buffer.data() + columns_[c].sort_begin * width;
+        Append(static_cast<int>(c), n,
+               [src, indices, width](uint8_t *dst, int64_t start,
+                                     int64_t count) {
+                 GatherIndexed(src, width, indices + start, count, dst);
+               });
+      }
+    }
+
+    for (auto &state : columns_) {
+      state.sort_begin += rows;
+      state.sort_rows -= rows;
+      memory_.Release(rows * state.width);
+      // Drop emitted rows once they outnumber the ones still held.
+      if (state.sort_begin >= state.sort_rows) {
+        state.sort_buffer.erase(state.sort_buffer.begin(),
+                                state.sort_buffer.begin() +
+                                    state.sort_begin * state.width);
+        state.sort_begin = 0;
+      }
+    }
+  }
+
+  // Appends `count` values to a column's page staging buffer, cutting pages
+  // at page and row group boundaries. fill(dst, start, n) writes values
+  // [start, start + n) of the input to dst.
+  template <typename Fill>
+  void Append(int col_idx, int64_t count, const Fill &fill) {
+    ColumnState &state = columns_[col_idx];
+    const int64_t rg_size = static_cast<int64_t>(options_.row_group_size);
+    int64_t done = 0;
+
+    while (done < count) {
+      // A full page is only cut once more data arrives, so we always know
+      // whether it is the last page of its column chunk.
+      if (state.staged_values == state.page_capacity)
+        CutPage(col_idx, false);
+
+      int64_t rg_left = rg_size - state.rg_values;
+      int64_t take = std::min(
+          {count - done, state.page_capacity - state.staged_values, rg_left});
+      if (state.staging.empty()) {
+        state.reserved_bytes = state.page_capacity * state.width;
+        state.staging.reserve(state.reserved_bytes);
+        memory_.Reserve(state.reserved_bytes);
+        PlaceStagingBuffer(state);
+      }
+
+      size_t offset = state.staging.size();
+      state.staging.resize(offset + take * state.width);
+      fill(state.staging.data() + offset, done, take);
+
+      done += take;
+      state.staged_values += take;
+      state.total_values += take;
+      state.rg_values += take;
+
+      if (state.rg_values == rg_size)
+        CutPage(col_idx, true);
+    }
+  }
+
+  // Applies the NUMA and huge page options to a freshly reserved staging
+  // buffer, before any of it is written.
+  void PlaceStagingBuffer(ColumnState &state) {
+    if (state.numa_node >= 0)
+      BindToNumaNode(state.staging.data(), state.reserved_bytes,
+                     state.numa_node);
+    if (options_.use_huge_pages &&
+        state.reserved_bytes >= options_.huge_page_threshold)
+      AdviseHugePages(state.staging.data(), state.reserved_bytes);
+  }
+
+  void CutPage(int col_idx, bool last_in_chunk) {
+    ColumnState &state = columns_[col_idx];
+    Page page;
+    page.column = col_idx;
+    page.row_group = state.row_group;
+    page.ordinal = state.next_ordinal++;
+    page.last_in_chunk = last_in_chunk;
+    page.num_values = static_cast<int32_t>(state.staged_values);
+    page.encode = state.encode;
+    page.bloom = state.bloom;
+    page.numa_node = state.numa_node;
+    page.adaptive = state.adaptive.get();
+    page.values = std::move(state.staging);
+    page.raw_bytes = state.reserved_bytes;
+    state.reserved_bytes = 0;
+    state.staging = {};
+    state.staged_values = 0;
+    if (last_in_chunk) {
+      state.rg_values = 0;
+      ++state.row_group;
+      state.next_ordinal = 0;
+    }
+    Dispatch(std::move(page));
+  }
+
+  void Dispatch(Page page) {
+    if (pipeline_) {
+      pipeline_->Submit(std::move(page));
+      return;
+    }
+    timers_.pages.fetch_add(1, std::memory_order_relaxed);
+    if (page.numa_node >= 0)
+      RecordNumaLocality(page.values.data(), &timers_);
+    {
+      HPQ_TRACE_SPAN("encode", page.column, page.row_group, page.ordinal);
+      ScopedStageTimer timer(&timers_.encode_ns);
+      page.encode(schema_.columns()[page.column], options_, &page);
+    }
+    if (options_.concurrent_columns) {
+      ArriveAtBarrier(std::move(page));
+      return;
+    }
+    {
+      ScopedStageTimer timer(&timers_.compress_ns);
+      compress_->Add(std::move(page), &ready_);
+    }
+    WriteReadyPages();
+  }
+
+  // concurrent_columns, sync: pages stay with their column until the chunk
+  // is done. The column then adds its chunk to the row group's barrier; the
+  // last one to arrive takes the whole row group on to compression and the
+  // assembler.
+  void ArriveAtBarrier(Page page) {
+    ColumnState &state = columns_[page.column];
+    const bool last = page.last_in_chunk;
+    const int64_t row_group = page.row_group;
+    state.encoded.push_back(std::move(page));
+    if (!last)
+      return;
+
+    std::vector<Page> group;
+    {
+      std::lock_guard<std::mutex> lock(barrier_mutex_);
+      RowGroupBarrier &barrier = barriers_[row_group];
+      std::move(state.encoded.begin(), state.encoded.end(),
+                std::back_inserter(barrier.pages));
+      if (++barrier.arrived == columns_.size()) {
+        group = std::move(barrier.pages);
+        barriers_.erase(row_group);
+      }
+    }
+    state.encoded.clear();
+    if (group.empty())
+      return;
+
+    std::lock_guard<std::mutex> lock(finish_mutex_);
+    {
+      ScopedStageTimer timer(&timers_.compress_ns);
+      for (Page &p : group)
+        compress_->Add(std::move(p), &ready_);
+    }
+    WriteReadyPages();
+  }
+
+  void WriteReadyPages() {
+    ScopedStageTimer timer(&timers_.write_ns);
+    for (Page &page : ready_)
+      assembler_->AddPage(std::move(page));
+    ready_.clear();
+  }
+
+  void FlushStagedPages() {
+    for (const auto &state : columns_) {
+      if (RowsIn(state) != RowsIn(columns_.front()))
+        throw std::runtime_error("Column row counts differ at row group end");
+    }
+    if (!columns_.empty() && columns_.front().sort_rows > 0)
+      EmitSorted(columns_.front().sort_rows);
+    for (size_t i = 0; i < columns_.size(); ++i) {
+      if (columns_[i].staged_values > 0)
+        CutPage(static_cast<int>(i), true);
+    }
+  }
+
+  // Honours a MemoryBudget flush request once every column has reached the
+  // same row, since a row group cannot end between columns.
+  void ServiceFlushRequest() {
+    flush_pending_ |= memory_.TakeFlushRequest();
+    if (!flush_pending_)
+      return;
+    for (const auto &state : columns_) {
+      if (RowsIn(state) != RowsIn(columns_.front()))
+        return;
+    }
+    flush_pending_ = false;
+    FlushStagedPages();
+  }
+
+  // Append mode: hands the footer of an existing file to the assembler.
+  // Returns false if there is no file to append to.
+  bool ReadExistingFooter(int64_t *footer_offset) {
+    int fd = ::open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      if (errno == ENOENT)
+        return false;
+      throw std::runtime_error("Failed to open " + filename_ +
+                               " for append: " + std::strerror(errno));
+    }
+    FileMetaData existing;
+    try {
+      existing = ReadFileFooter(fd, filename_, footer_offset);
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    ::close(fd);
+
+    const auto &columns = schema_.columns();
+    bool same = existing.schema.size() == columns.size();
+    for (size_t i = 0; same && i < columns.size(); ++i) {
+      const ColumnSchema &a = existing.schema[i];
+      same = a.name == columns[i].name && a.type == columns[i].type &&
+             a.nullable == columns[i].nullable &&
+             a.type_length == columns[i].type_length &&
+             a.logical_type == columns[i].logical_type;
+    }
+    if (!same)
+      throw std::runtime_error("Cannot append to " + filename_ +
+                               ": schema does not match");
+    assembler_->ContinueFrom(existing);
+    return true;
+  }
+
+  void FinishFile() {
+    if (!pipeline_) {
+      compress_->Flush(&ready_);
+      WriteReadyPages();
+    }
+    HPQ_TRACE_SPAN("footer");
+    ScopedStageTimer timer(&timers_.write_ns);
+    FileMetaData metadata = assembler_->Finish();
+    WriteFileFooter(*out_, metadata);
+    out_->Close();
+  }
 };
 
 ParquetWriter::ParquetWriter(const std::string &filename,
                              const WriterOptions &options)
     : impl_(std::make_unique<Impl>(filename, options)) {}
 
+ParquetWriter::ParquetWriter(std::shared_ptr<OutputStream> out,
+                             const WriterOptions &options)
+    : impl_(std::make_unique<Impl>(std::move(out), options)) {}
+
 ParquetWriter::~ParquetWriter() = default;
 
 void ParquetWriter::Init(const Schema &schema) { impl_->Init(schema); }
@@ -86,6 +678,23 @@ void ParquetWriter::WriteColumn(int col_idx, const void *values,
   impl_->WriteColumn(col_idx, values, num_values);
 }
 
+void ParquetWriter::WriteRows(const void *rows, size_t stride,
+                              size_t num_rows) {
+  impl_->WriteRows(rows, stride, num_rows);
+}
+
+void ParquetWriter::FlushRowGroup() { impl_->FlushRowGroup(); }
+
+size_t ParquetWriter::buffered_bytes() const {
+  return impl_->buffered_bytes();
+}
+
+WriterStats ParquetWriter::stats() const { return impl_->stats(); }
+
 void ParquetWriter::Close() { impl_->Close(); }
 
+std::future<void> ParquetWriter::CloseAsync(CloseCallback on_complete) {
+  return impl_->CloseAsync(std::move(on_complete));
+}
+
 } // namespace hpq
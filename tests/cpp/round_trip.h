@@ -0,0 +1,44 @@
+#pragma once
+
+#include "hpq/encodings/encoding_base.h"
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Encodes values in two Put() calls, then decodes them back in uneven
+// batches so every decoder has to resume mid-run / mid-group / mid-block.
+// ByteArray values are compared by content. Returns the encoded size; the
+// encoder is left flushed, not cleared.
+template <typename T>
+size_t RoundTrip(hpq::Encoder &encoder, hpq::Decoder &decoder,
+                 const std::vector<T> &values, int batch = 37) {
+  const int n = static_cast<int>(values.size());
+  encoder.Put(values.data(), n / 2);
+  encoder.Put(values.data() + n / 2, n - n / 2);
+  auto encoded = encoder.Flush();
+  decoder.SetData(encoded.first, encoded.second, n);
+  // Each batch is checked before the next Decode(): ByteArray results may
+  // point into decoder storage that the next call reuses.
+  std::vector<T> out(batch);
+  size_t done = 0;
+  while (done < values.size()) {
+    int got = decoder.Decode(out.data(), batch);
+    assert(got > 0);
+    assert(done + got <= values.size());
+    if constexpr (std::is_same_v<T, hpq::ByteArray>) {
+      for (int i = 0; i < got; ++i) {
+        const hpq::ByteArray &expect = values[done + i];
+        assert(out[i].len == expect.len);
+        assert(expect.len == 0 ||
+               std::memcmp(out[i].ptr, expect.ptr, expect.len) == 0);
+      }
+    } else {
+      assert(std::memcmp(out.data(), values.data() + done,
+                         got * sizeof(T)) == 0);
+    }
+    done += got;
+  }
+  assert(decoder.Decode(out.data(), batch) == 0);
+  return encoded.second;
+}
@@ -1,5 +1,8 @@
+#include "hpq/scanner.h"
 #include "hpq/schema.h"
 #include "hpq/writer.h"
+#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <numeric>
 #include <vector>
@@ -32,7 +35,15 @@ void TestAdaptiveSelection() {
   writer.WriteColumn(2, plain_data.data(), plain_data.size());
 
   writer.Close();
-  // Check stdout for "Adaptive: Selected ..." messages
+  assert(writer.stats().encoding_analyses == 3);
+
+  // Runs, small values and a sequence all delta-pack well
+  hpq::ParquetScanner scanner("test_adaptive.parquet");
+  for (const auto &chunk : scanner.metadata().row_groups[0].columns) {
+    const auto &encodings = chunk.encodings;
+    assert(std::find(encodings.begin(), encodings.end(),
+                     hpq::Encoding::DELTA_BINARY_PACKED) != encodings.end());
+  }
 }
 
 int main() {
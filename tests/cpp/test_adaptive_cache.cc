@@ -0,0 +1,143 @@
+#include "hpq/encodings/adaptive.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const char *kFile = "test_adaptive_cache.parquet";
+
+template <typename DType>
+hpq::Encoding EncodeChunk(hpq::TypedAdaptiveEncoder<DType> &encoder,
+                          const std::vector<typename DType::c_type> &values) {
+  encoder.PutTyped(values.data(), static_cast<int>(values.size()));
+  encoder.Flush();
+  hpq::Encoding encoding = encoder.encoding();
+  encoder.Clear();
+  return encoding;
+}
+
+std::vector<int32_t> Ints(int n, int32_t lo, int32_t hi, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int32_t> dist(lo, hi);
+  std::vector<int32_t> values(n);
+  for (auto &v : values)
+    v = dist(rng);
+  return values;
+}
+
+void TestInt32Drift() {
+  std::cout << "Testing INT32 decision reuse and drift..." << std::endl;
+  hpq::AdaptiveDecisionCache cache;
+  hpq::TypedAdaptiveEncoder<hpq::Int32Type> encoder(hpq::Codec::SNAPPY,
+                                                    &cache);
+  const int n = 20000;
+  assert(EncodeChunk(encoder, Ints(n, 0, 1000, 1)) ==
+         hpq::Encoding::DELTA_BINARY_PACKED);
+  assert(cache.analyses() == 1 && cache.reuses() == 0);
+  for (int seed = 2; seed < 6; ++seed)
+    assert(EncodeChunk(encoder, Ints(n, 0, 1000, seed)) ==
+           hpq::Encoding::DELTA_BINARY_PACKED);
+  assert(cache.analyses() == 1 && cache.reuses() == 4);
+
+  // Wider values, same choice: the stored bit width is refreshed
+  assert(EncodeChunk(encoder, Ints(n, 0, 100000, 6)) ==
+         hpq::Encoding::DELTA_BINARY_PACKED);
+  assert(cache.analyses() == 2);
+  hpq::AdaptiveProfile profile;
+  assert(cache.Get(&profile) && profile.bit_width == 17);
+
+  // Full-range values no longer pack
+  assert(EncodeChunk(encoder, Ints(n, -2000000000, 2000000000, 7)) ==
+         hpq::Encoding::PLAIN);
+  assert(cache.analyses() == 3);
+  assert(EncodeChunk(encoder, Ints(n, -2000000000, 2000000000, 8)) ==
+         hpq::Encoding::PLAIN);
+  assert(cache.reuses() == 5);
+
+  // Small chunks are always analyzed in full
+  assert(EncodeChunk(encoder, Ints(100, 0, 10, 9)) ==
+         hpq::Encoding::DELTA_BINARY_PACKED);
+  assert(cache.analyses() == 4);
+}
+
+void TestDoubleDrift() {
+  std::cout << "Testing DOUBLE decision drift..." << std::endl;
+  hpq::AdaptiveDecisionCache cache;
+  hpq::TypedAdaptiveEncoder<hpq::DoubleType> encoder(hpq::Codec::SNAPPY,
+                                                     &cache);
+  const int n = 20000;
+  std::vector<double> smooth(n);
+  for (int i = 0; i < n; ++i)
+    smooth[i] = 1000.0 + i * 0.25;
+  assert(EncodeChunk(encoder, smooth) == hpq::Encoding::BYTE_STREAM_SPLIT);
+  assert(EncodeChunk(encoder, smooth) == hpq::Encoding::BYTE_STREAM_SPLIT);
+  assert(cache.analyses() == 1 && cache.reuses() == 1);
+
+  // High-entropy bit patterns: splitting no longer pays
+  std::mt19937_64 rng(3);
+  std::vector<double> noise(n);
+  for (auto &v : noise) {
+    uint64_t bits = rng() & ~(uint64_t{1} << 62); // Finite values
+    std::memcpy(&v, &bits, 8);
+  }
+  assert(EncodeChunk(encoder, noise) == hpq::Encoding::PLAIN);
+  assert(cache.analyses() == 2);
+}
+
+void TestWriter() {
+  std::cout << "Testing reuse_encoding_decisions in the writer..."
+            << std::endl;
+  const int n = 200000;
+  const std::vector<int32_t> a = Ints(n, 0, 5000, 11);
+  std::vector<double> b(n);
+  for (int i = 0; i < n; ++i)
+    b[i] = i * 0.5;
+  hpq::Schema schema;
+  schema.AddColumn("a", hpq::Type::INT32, false);
+  schema.AddColumn("b", hpq::Type::DOUBLE, false);
+  hpq::WriterOptions options;
+  options.row_group_size = 50000;
+  options.data_page_size = 64 * 1024;
+  options.async = true;
+  options.encode_threads = 3;
+  hpq::WriterStats stats;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    writer.WriteColumn(0, a.data(), n);
+    writer.WriteColumn(1, b.data(), n);
+    writer.Close();
+    stats = writer.stats();
+  }
+  std::cout << "  pages " << stats.pages << ", analyzed "
+            << stats.encoding_analyses << ", reused "
+            << stats.encoding_decisions_reused << std::endl;
+  assert(stats.encoding_analyses + stats.encoding_decisions_reused ==
+         stats.pages);
+  assert(stats.encoding_decisions_reused > stats.pages / 2);
+
+  hpq::ParquetScanner scanner(kFile);
+  hpq::ScanBatch batch;
+  size_t i = 0;
+  while (scanner.Next(&batch)) {
+    for (int64_t k = 0; k < batch.num_rows; ++k, ++i) {
+      assert(batch.columns[0].values<int32_t>()[k] == a[i]);
+      assert(batch.columns[1].values<double>()[k] == b[i]);
+    }
+  }
+  assert(i == static_cast<size_t>(n));
+}
+
+int main() {
+  TestInt32Drift();
+  TestDoubleDrift();
+  TestWriter();
+  std::remove(kFile);
+  std::cout << "test_adaptive_cache passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+const char *kFile = "test_append.parquet";
+
+hpq::Schema MakeSchema() {
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  schema.AddColumn("value", hpq::Type::DOUBLE, false);
+  return schema;
+}
+
+// Writes ids [first, first + rows) as one or more row groups.
+void WriteRun(int64_t first, int rows, hpq::WriterOptions options) {
+  std::vector<int64_t> id(rows);
+  std::vector<double> value(rows);
+  for (int i = 0; i < rows; ++i) {
+    id[i] = first + i;
+    value[i] = static_cast<double>(first + i) * 0.5;
+  }
+  options.compression = "NONE";
+  options.row_group_size = 10000;
+  options.data_page_size = 16 * 1024;
+  options.bloom_filter_columns = {"id"};
+  hpq::ParquetWriter writer(kFile, options);
+  writer.Init(MakeSchema());
+  writer.WriteColumn(0, id.data(), rows);
+  writer.WriteColumn(1, value.data(), rows);
+  writer.Close();
+}
+
+// Checks that the file holds ids 0..expected-1 in order.
+void VerifyAll(int64_t expected, size_t row_groups) {
+  hpq::ParquetScanner scanner(kFile);
+  assert(scanner.metadata().row_groups.size() == row_groups);
+  assert(scanner.metadata().num_rows == expected);
+  hpq::ScanBatch batch;
+  int64_t rows = 0;
+  while (scanner.Next(&batch)) {
+    const int64_t *ids = batch.columns[0].values<int64_t>();
+    const double *values = batch.columns[1].values<double>();
+    for (int64_t i = 0; i < batch.num_rows; ++i) {
+      assert(ids[i] == rows + i);
+      assert(values[i] == static_cast<double>(ids[i]) * 0.5);
+    }
+    rows += batch.num_rows;
+  }
+  assert(rows == expected);
+}
+
+// A point lookup must find the row through statistics, page index and
+// Bloom filter, whichever write the row group came from.
+void VerifyLookup(int64_t id) {
+  hpq::ScanOptions options;
+  options.predicates = {hpq::ColumnPredicate::Equal("id", id)};
+  hpq::ParquetScanner scanner(kFile, options);
+  hpq::ScanBatch batch;
+  bool found = false;
+  while (scanner.Next(&batch)) {
+    const int64_t *ids = batch.columns[0].values<int64_t>();
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      found |= ids[i] == id;
+  }
+  assert(found);
+  assert(scanner.stats().pages_skipped > 0);
+}
+
+void TestAppend() {
+  std::cout << "Testing append of row groups..." << std::endl;
+  std::remove(kFile);
+  hpq::WriterOptions options;
+  options.append = true; // Missing file: created as usual
+  WriteRun(0, 25000, options);
+  VerifyAll(25000, 3);
+
+  WriteRun(25000, 12000, options);
+  VerifyAll(37000, 5);
+  VerifyLookup(1234);
+  VerifyLookup(31000);
+
+  // Appending nothing rewrites the same footer
+  WriteRun(37000, 0, options);
+  VerifyAll(37000, 5);
+}
+
+void TestAppendModes() {
+  std::cout << "Testing append through mmap and O_DIRECT output..."
+            << std::endl;
+  hpq::WriterOptions mmap;
+  mmap.use_mmap = true;
+  mmap.mmap_extent_size = 64 * 1024;
+  WriteRun(0, 15000, mmap);
+  mmap.append = true;
+  WriteRun(15000, 15000, mmap);
+  VerifyAll(30000, 4);
+
+  hpq::WriterOptions direct;
+  direct.use_direct_io = true;
+  direct.direct_buffer_size = 8192;
+  direct.append = true; // The footer does not end on a block boundary
+  WriteRun(30000, 5000, direct);
+  direct.async = true;
+  WriteRun(35000, 5000, direct);
+  VerifyAll(40000, 6);
+  VerifyLookup(22222);
+}
+
+void TestSchemaMismatch() {
+  std::cout << "Testing append with a different schema..." << std::endl;
+  hpq::Schema other;
+  other.AddColumn("id", hpq::Type::INT32);
+  other.AddColumn("value", hpq::Type::DOUBLE, false);
+  hpq::WriterOptions options;
+  options.append = true;
+  bool threw = false;
+  try {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(other);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+  VerifyAll(40000, 6); // Untouched
+}
+
+int main() {
+  TestAppend();
+  TestAppendModes();
+  TestSchemaMismatch();
+  std::remove(kFile);
+  std::cout << "test_append passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,97 @@
+#include "hpq/encodings/boolean.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Reference decoder for the RLE/bit-packed hybrid with bit width 1.
+static std::vector<uint8_t> DecodeRle(const uint8_t *data, size_t size,
+                                      size_t num_values) {
+  uint32_t len;
+  std::memcpy(&len, data, 4);
+  assert(len + 4 == size);
+  std::vector<uint8_t> out;
+  size_t pos = 4;
+  while (out.size() < num_values) {
+    uint32_t header = 0;
+    int shift = 0;
+    uint8_t b;
+    do {
+      b = data[pos++];
+      header |= static_cast<uint32_t>(b & 0x7F) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    if (header & 1) {
+      uint32_t groups = header >> 1;
+      for (uint32_t g = 0; g < groups; ++g, ++pos)
+        for (int bit = 0; bit < 8 && out.size() < num_values; ++bit)
+          out.push_back((data[pos] >> bit) & 1);
+    } else {
+      uint32_t count = header >> 1;
+      uint8_t value = data[pos++];
+      out.insert(out.end(), count, value);
+    }
+  }
+  assert(pos == size);
+  return out;
+}
+
+void TestPackBooleans() {
+  std::cout << "Testing PackBooleans..." << std::endl;
+  std::mt19937 rng(7);
+  for (size_t n : {1, 7, 8, 31, 32, 33, 64, 100, 1000}) {
+    std::vector<uint8_t> values(n);
+    for (auto &v : values)
+      v = (rng() % 3 == 0) ? static_cast<uint8_t>(rng() | 1) : 0;
+    std::vector<uint8_t> packed((n + 7) / 8, 0xAA);
+    hpq::PackBooleans(values.data(), n, packed.data());
+    for (size_t i = 0; i < n; ++i)
+      assert(((packed[i / 8] >> (i % 8)) & 1) == (values[i] != 0));
+    if (n % 8)
+      assert((packed.back() >> (n % 8)) == 0); // Padding bits are zero
+  }
+}
+
+void TestPlainBoolean() {
+  std::cout << "Testing PLAIN BOOLEAN..." << std::endl;
+  hpq::BooleanEncoder encoder(hpq::Encoding::PLAIN);
+  std::vector<uint8_t> values(1003);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = (i % 5 == 0);
+  // Uneven batches exercise the partial-byte path.
+  encoder.Put(values.data(), 3);
+  encoder.Put(values.data() + 3, 500);
+  encoder.Put(values.data() + 503, 500);
+  auto result = encoder.Flush();
+
+  assert(result.second == (values.size() + 7) / 8);
+  for (size_t i = 0; i < values.size(); ++i)
+    assert(((result.first[i / 8] >> (i % 8)) & 1) == values[i]);
+}
+
+void TestRleBoolean() {
+  std::cout << "Testing RLE BOOLEAN..." << std::endl;
+  hpq::BooleanEncoder encoder(hpq::Encoding::RLE);
+  std::vector<uint8_t> values;
+  values.insert(values.end(), 10000, 1);
+  for (int i = 0; i < 13; ++i)
+    values.push_back(i % 2);
+  values.insert(values.end(), 10000, 0);
+  values.push_back(1);
+
+  encoder.Put(values.data(), values.size());
+  auto result = encoder.Flush();
+  std::cout << "RLE BOOLEAN size: " << result.second << " bytes (PLAIN "
+            << (values.size() + 7) / 8 << ")" << std::endl;
+  assert(result.second < 32);
+  assert(DecodeRle(result.first, result.second, values.size()) == values);
+}
+
+int main() {
+  TestPackBooleans();
+  TestPlainBoolean();
+  TestRleBoolean();
+  std::cout << "test_boolean passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,138 @@
+#include "hpq/gpu/gpu_compress.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include "hpq/writer/codec_selector.h"
+#include "hpq/writer/page.h"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+const char *kFile = "test_compress_batch.parquet";
+
+// Many independent pages of mixed compressibility, one column chunk each.
+std::vector<hpq::Page> MakePages(int count) {
+  std::mt19937_64 rng(7);
+  std::vector<hpq::Page> pages(count);
+  for (int i = 0; i < count; ++i) {
+    hpq::Page &page = pages[i];
+    page.column = i;
+    page.last_in_chunk = true;
+    page.body.resize(20000 + i * 100);
+    for (size_t j = 0; j < page.body.size(); ++j)
+      page.body[j] = static_cast<uint8_t>(i % 3 == 0 ? rng() : j / 16 % 8);
+    page.uncompressed_size = static_cast<int32_t>(page.body.size());
+  }
+  return pages;
+}
+
+void TestBackend() {
+  std::cout << "Testing CPU batch backend..." << std::endl;
+  hpq::WriterOptions options;
+  std::vector<hpq::Page> serial = MakePages(40);
+  std::vector<hpq::Page> parallel = MakePages(40);
+  hpq::CodecSelector serial_codecs(options);
+  hpq::CodecSelector parallel_codecs(options);
+  hpq::MakeCpuCompressBackend(1)->CompressBatch(serial, &serial_codecs);
+  auto backend = hpq::MakeCpuCompressBackend(4);
+  backend->CompressBatch(parallel, &parallel_codecs);
+  backend->CompressBatch({}, &parallel_codecs); // Empty batch is a no-op
+
+  for (size_t i = 0; i < serial.size(); ++i) {
+    assert(serial[i].codec == parallel[i].codec);
+    assert(serial[i].body == parallel[i].body);
+    bool random = i % 3 == 0;
+    assert(parallel[i].codec ==
+           (random ? hpq::Codec::UNCOMPRESSED : hpq::Codec::SNAPPY));
+  }
+  assert(parallel_codecs.pages_compressed() == 26);
+}
+
+void TestChunkCodec() {
+  std::cout << "Testing chunk codec from the first page..." << std::endl;
+  // Page 0 compresses well, page 1 is noise: the chunk takes page 0's codec
+  // whichever page a worker selects first, and page 1 is stored.
+  std::mt19937_64 rng(11);
+  std::vector<hpq::Page> pages(2);
+  for (int i = 0; i < 2; ++i) {
+    pages[i].ordinal = i;
+    pages[i].last_in_chunk = i == 1;
+    pages[i].body.resize(20000);
+    for (size_t j = 0; j < pages[i].body.size(); ++j)
+      pages[i].body[j] = static_cast<uint8_t>(i == 1 ? rng() : j / 16 % 8);
+  }
+  hpq::WriterOptions options;
+  hpq::CodecSelector codecs(options);
+  codecs.ChooseChunkCodecs(pages);
+  bool store = false;
+  assert(codecs.Select(pages[1], &store) == hpq::Codec::SNAPPY && store);
+  assert(codecs.open_chunks() == 1);
+  assert(codecs.Select(pages[0], &store) == hpq::Codec::SNAPPY && !store);
+  assert(codecs.open_chunks() == 0); // Dropped after the last page
+
+  // Without priming, the first page selected decides
+  hpq::CodecSelector unprimed(options);
+  assert(unprimed.Select(pages[1], &store) == hpq::Codec::UNCOMPRESSED);
+  assert(unprimed.Select(pages[0], &store) == hpq::Codec::UNCOMPRESSED);
+  assert(unprimed.open_chunks() == 0);
+}
+
+void WriteAndCheck(hpq::WriterOptions options) {
+  const int rows = 120000;
+  std::vector<int64_t> a(rows);
+  std::vector<double> b(rows);
+  for (int i = 0; i < rows; ++i) {
+    a[i] = i / 7;
+    b[i] = (i % 100) * 0.5;
+  }
+  hpq::Schema schema;
+  schema.AddColumn("a", hpq::Type::INT64, false);
+  schema.AddColumn("b", hpq::Type::DOUBLE);
+  options.row_group_size = 50000;
+  options.data_page_size = 32 * 1024;
+  hpq::ParquetWriter writer(kFile, options);
+  writer.Init(schema);
+  writer.WriteColumn(0, a.data(), rows);
+  writer.WriteColumn(1, b.data(), rows);
+  writer.Close();
+  assert(writer.stats().pages_compressed == writer.stats().pages);
+
+  hpq::ParquetScanner scanner(kFile);
+  assert(scanner.metadata().row_groups.size() == 3);
+  hpq::ScanBatch batch;
+  int64_t row = 0;
+  while (scanner.Next(&batch)) {
+    const int64_t *x = batch.columns[0].values<int64_t>();
+    const double *y = batch.columns[1].values<double>();
+    for (int64_t i = 0; i < batch.num_rows; ++i, ++row)
+      assert(x[i] == a[row] && y[i] == b[row]);
+  }
+  assert(row == rows);
+}
+
+void TestWriter() {
+  std::cout << "Testing row group batches in the writer..." << std::endl;
+  hpq::WriterOptions options;
+  options.compress_threads = 3;
+  WriteAndCheck(options); // Sync
+  options.async = true;
+  options.encode_threads = 2;
+  WriteAndCheck(options);
+
+  // One backend shared by consecutive writers
+  options.compress_backend = hpq::MakeCpuCompressBackend(2);
+  WriteAndCheck(options);
+  options.async = false;
+  WriteAndCheck(options);
+}
+
+int main() {
+  TestBackend();
+  TestChunkCodec();
+  TestWriter();
+  std::remove(kFile);
+  std::cout << "test_compress_batch passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,221 @@
+#include "hpq/compression/codec.h"
+#include "hpq/compression/snappy.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+const char *kFile = "test_compression.parquet";
+
+std::vector<uint8_t> RoundTrip(hpq::Codec codec,
+                               const std::vector<uint8_t> &input,
+                               bool store = false) {
+  std::vector<uint8_t> compressed(
+      hpq::MaxCompressedSize(codec, input.size()));
+  compressed.resize(hpq::CompressBuffer(codec, input.data(), input.size(),
+                                        compressed.data(), store));
+  std::vector<uint8_t> output(input.size());
+  hpq::DecompressBuffer(codec, compressed.data(), compressed.size(),
+                        output.data(), output.size());
+  assert(output == input);
+  return compressed;
+}
+
+std::vector<std::vector<uint8_t>> TestInputs() {
+  std::mt19937_64 rng(3);
+  std::vector<std::vector<uint8_t>> inputs;
+  inputs.push_back({});
+  inputs.push_back({42});
+  inputs.push_back(std::vector<uint8_t>(300000, 7)); // Overlapping copies
+  std::vector<uint8_t> random(200003);
+  for (auto &b : random)
+    b = static_cast<uint8_t>(rng());
+  inputs.push_back(random);
+  // Short repeats at varied distances, across 64 KiB block boundaries
+  std::vector<uint8_t> text;
+  const std::string words[] = {"alpha ", "beta ", "gamma ", "delta-delta ",
+                               "e"};
+  while (text.size() < 150000) {
+    const std::string &w = words[rng() % 5];
+    text.insert(text.end(), w.begin(), w.end());
+  }
+  inputs.push_back(text);
+  return inputs;
+}
+
+void TestSnappy() {
+  std::cout << "Testing Snappy round trips..." << std::endl;
+  auto inputs = TestInputs();
+  for (const auto &input : inputs) {
+    auto compressed = RoundTrip(hpq::Codec::SNAPPY, input);
+    RoundTrip(hpq::Codec::SNAPPY, input, true);
+    if (input.size() == 300000)
+      assert(compressed.size() < input.size() / 20);
+    if (input.size() == 200003) // Random: literals plus framing
+      assert(compressed.size() <= hpq::SnappyMaxCompressedLength(200003));
+  }
+
+  // Corrupt streams are rejected, not read out of bounds
+  const auto &text = inputs.back();
+  std::vector<uint8_t> compressed(hpq::SnappyMaxCompressedLength(text.size()));
+  compressed.resize(
+      hpq::SnappyCompress(text.data(), text.size(), compressed.data()));
+  std::vector<uint8_t> out(text.size());
+  int rejected = 0;
+  for (size_t cut : {size_t(1), compressed.size() / 2, compressed.size() - 1}) {
+    try {
+      hpq::SnappyDecompress(compressed.data(), cut, out.data(), out.size());
+    } catch (const std::runtime_error &) {
+      ++rejected;
+    }
+  }
+  try {
+    hpq::SnappyDecompress(compressed.data(), compressed.size(), out.data(),
+                          out.size() - 1);
+  } catch (const std::runtime_error &) {
+    ++rejected;
+  }
+  assert(rejected == 4);
+}
+
+void TestGzip() {
+  if (!hpq::CodecAvailable(hpq::Codec::GZIP)) {
+    std::cout << "GZIP not available, skipping." << std::endl;
+    return;
+  }
+  std::cout << "Testing GZIP round trips..." << std::endl;
+  for (const auto &input : TestInputs()) {
+    RoundTrip(hpq::Codec::GZIP, input);
+    RoundTrip(hpq::Codec::GZIP, input, true);
+  }
+}
+
+void TestEstimate() {
+  std::cout << "Testing compressibility estimates..." << std::endl;
+  auto inputs = TestInputs();
+  const auto &random = inputs[3];
+  const auto &text = inputs[4];
+  assert(hpq::EstimateCompressionRatio(hpq::Codec::SNAPPY, random.data(),
+                                       random.size()) == 1.0);
+  double ratio = hpq::EstimateCompressionRatio(hpq::Codec::SNAPPY,
+                                               text.data(), text.size());
+  std::vector<uint8_t> full(hpq::SnappyMaxCompressedLength(text.size()));
+  double actual =
+      static_cast<double>(
+          hpq::SnappyCompress(text.data(), text.size(), full.data())) /
+      text.size();
+  std::cout << "  text: estimated " << ratio << ", actual " << actual
+            << std::endl;
+  assert(ratio < 0.6 && ratio > actual * 0.5 && ratio < actual * 2);
+}
+
+// Writes a random-ID column (incompressible) next to low-cardinality
+// doubles and reads both back through the scanner.
+void WriteAndCheck(const hpq::WriterOptions &base, hpq::Codec expect_values,
+                   bool async) {
+  const int rows = 100000;
+  std::vector<int64_t> ids(rows);
+  std::vector<double> prices(rows);
+  std::mt19937_64 rng(11);
+  for (int i = 0; i < rows; ++i) {
+    ids[i] = static_cast<int64_t>(rng());
+    prices[i] = static_cast<double>(rng() % 20) * 0.25;
+  }
+
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64, false);
+  schema.AddColumn("price", hpq::Type::DOUBLE);
+  hpq::WriterOptions options = base;
+  options.row_group_size = 50000;
+  options.data_page_size = 64 * 1024;
+  options.async = async;
+  hpq::ParquetWriter writer(kFile, options);
+  writer.Init(schema);
+  writer.WriteColumn(0, ids.data(), rows);
+  writer.WriteColumn(1, prices.data(), rows);
+  writer.Close();
+  const hpq::WriterStats stats = writer.stats();
+  assert(stats.pages_compressed > 0 && stats.pages_compressed < stats.pages);
+
+  hpq::ParquetScanner scanner(kFile);
+  for (const auto &rg : scanner.metadata().row_groups) {
+    assert(rg.columns[0].codec == hpq::Codec::UNCOMPRESSED);
+    assert(rg.columns[1].codec == expect_values);
+    assert(rg.columns[1].total_compressed_size * 2 <
+           rg.columns[1].total_uncompressed_size);
+  }
+  hpq::ScanBatch batch;
+  int64_t row = 0;
+  while (scanner.Next(&batch)) {
+    const int64_t *id = batch.columns[0].values<int64_t>();
+    const double *price = batch.columns[1].values<double>();
+    for (int64_t i = 0; i < batch.num_rows; ++i, ++row) {
+      assert(id[i] == ids[row]);
+      assert(price[i] == prices[row]);
+    }
+  }
+  assert(row == rows);
+}
+
+void TestWriter() {
+  std::cout << "Testing per-chunk codec selection..." << std::endl;
+  hpq::WriterOptions options; // SNAPPY
+  WriteAndCheck(options, hpq::Codec::SNAPPY, false);
+  WriteAndCheck(options, hpq::Codec::SNAPPY, true);
+
+  options.compression = "AUTO";
+  options.compression_target = hpq::CompressionTarget::kRatio;
+  const bool gzip = hpq::CodecAvailable(hpq::Codec::GZIP);
+  WriteAndCheck(options, gzip ? hpq::Codec::GZIP : hpq::Codec::SNAPPY, false);
+  options.compression_target = hpq::CompressionTarget::kSpeed;
+  WriteAndCheck(options, hpq::Codec::SNAPPY, true);
+}
+
+void TestStoredPages() {
+  std::cout << "Testing pages stored in the chunk codec's framing..."
+            << std::endl;
+  // The first page is compressible, the rest random: they stay in the
+  // SNAPPY chunk as literal-only streams.
+  const int rows = 40000;
+  std::vector<int64_t> values(rows);
+  std::mt19937_64 rng(5);
+  for (int i = 0; i < rows; ++i)
+    values[i] = i < 8192 ? 1000 + i % 3 : static_cast<int64_t>(rng());
+
+  hpq::Schema schema;
+  schema.AddColumn("v", hpq::Type::INT64, false);
+  hpq::WriterOptions options;
+  options.data_page_size = 64 * 1024;
+  hpq::ParquetWriter writer(kFile, options);
+  writer.Init(schema);
+  writer.WriteColumn(0, values.data(), rows);
+  writer.Close();
+  assert(writer.stats().pages_compressed == 1);
+  assert(writer.stats().pages == 5);
+
+  hpq::ParquetScanner scanner(kFile);
+  assert(scanner.metadata().row_groups[0].columns[0].codec ==
+         hpq::Codec::SNAPPY);
+  hpq::ScanBatch batch;
+  assert(scanner.Next(&batch) && batch.num_rows == rows);
+  assert(std::memcmp(batch.columns[0].data.data(), values.data(),
+                     rows * sizeof(int64_t)) == 0);
+}
+
+int main() {
+  TestSnappy();
+  TestGzip();
+  TestEstimate();
+  TestWriter();
+  TestStoredPages();
+  std::remove(kFile);
+  std::cout << "test_compression passed!" << std::endl;
+  return 0;
+}
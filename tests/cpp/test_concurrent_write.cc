@@ -0,0 +1,119 @@
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char *kFile = "test_concurrent_write.parquet";
+const int kColumns = 8;
+const int kRows = 50000;
+
+int64_t Value(int column, int row) {
+  return static_cast<int64_t>(column) * 1000000 + row;
+}
+
+hpq::Schema MakeSchema() {
+  hpq::Schema schema;
+  for (int c = 0; c < kColumns; ++c)
+    schema.AddColumn(std::string(1, static_cast<char>('a' + c)),
+                     hpq::Type::INT64, false);
+  return schema;
+}
+
+void CheckFile() {
+  hpq::ParquetScanner scanner(kFile);
+  assert(scanner.metadata().num_rows == kRows);
+  int64_t row = 0;
+  hpq::ScanBatch batch;
+  while (scanner.Next(&batch)) {
+    for (int c = 0; c < kColumns; ++c) {
+      const int64_t *v = batch.columns[c].values<int64_t>();
+      for (int64_t i = 0; i < batch.num_rows; ++i)
+        assert(v[i] == Value(c, static_cast<int>(row + i)));
+    }
+    row += batch.num_rows;
+  }
+  assert(row == kRows);
+}
+
+// One producer thread per column, each writing in its own batch sizes.
+void TestThreads(bool async) {
+  std::cout << "Testing concurrent WriteColumn ("
+            << (async ? "async" : "sync") << ")..." << std::endl;
+  hpq::Schema schema = MakeSchema();
+  hpq::WriterOptions options;
+  options.concurrent_columns = true;
+  options.async = async;
+  options.row_group_size = 7000;
+  options.data_page_size = 4096;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    std::vector<std::thread> producers;
+    for (int c = 0; c < kColumns; ++c) {
+      producers.emplace_back([&writer, c] {
+        std::mt19937 rng(c);
+        std::vector<int64_t> batch;
+        for (int row = 0; row < kRows;) {
+          int n = std::min<int>(kRows - row, 1 + rng() % 3000);
+          batch.resize(n);
+          for (int i = 0; i < n; ++i)
+            batch[i] = Value(c, row + i);
+          writer.WriteColumn(c, batch.data(), n);
+          row += n;
+        }
+      });
+    }
+    for (auto &t : producers)
+      t.join();
+    writer.Close();
+  }
+  CheckFile();
+}
+
+// The mode never blocks a producer, so one thread can still fill the
+// columns one after the other.
+void TestSingleThread() {
+  std::cout << "Testing concurrent mode from one thread..." << std::endl;
+  hpq::Schema schema = MakeSchema();
+  hpq::WriterOptions options;
+  options.concurrent_columns = true;
+  options.row_group_size = 10000;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    std::vector<int64_t> values(kRows);
+    for (int c = 0; c < kColumns; ++c) {
+      for (int i = 0; i < kRows; ++i)
+        values[i] = Value(c, i);
+      writer.WriteColumn(c, values.data(), kRows);
+    }
+    writer.Close();
+  }
+  CheckFile();
+
+  options.sort_by = {"a"};
+  hpq::ParquetWriter writer(kFile, options);
+  bool threw = false;
+  try {
+    writer.Init(schema);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main() {
+  TestThreads(false);
+  TestThreads(true);
+  TestSingleThread();
+  std::remove(kFile);
+  std::cout << "test_concurrent_write passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,137 @@
+#include "hpq/format/parquet_metadata.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/util/crc32.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+const char *kFile = "test_crc32.parquet";
+
+uint32_t BitwiseCrc32(const uint8_t *data, size_t size) {
+  uint32_t crc = ~0u;
+  for (size_t i = 0; i < size; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+  }
+  return ~crc;
+}
+
+void TestCrc32() {
+  std::cout << "Testing Crc32..." << std::endl;
+  const char *check = "123456789";
+  assert(hpq::Crc32(reinterpret_cast<const uint8_t *>(check), 9) ==
+         0xCBF43926);
+  assert(hpq::Crc32(nullptr, 0) == 0);
+
+  std::mt19937 rng(3);
+  std::vector<uint8_t> data(5000);
+  for (auto &b : data)
+    b = static_cast<uint8_t>(rng());
+  // Every length around the folding block sizes, at unaligned offsets
+  for (size_t size = 0; size < 600; ++size) {
+    for (size_t offset = 0; offset < 3; ++offset) {
+      const uint8_t *p = data.data() + offset;
+      const uint32_t expect = BitwiseCrc32(p, size);
+      assert(hpq::Crc32(p, size) == expect);
+      const size_t split = size / 3;
+      assert(hpq::Crc32(p + split, size - split, hpq::Crc32(p, split)) ==
+             expect);
+    }
+  }
+  assert(hpq::Crc32(data.data(), data.size()) ==
+         BitwiseCrc32(data.data(), data.size()));
+}
+
+std::vector<uint8_t> ReadFile() {
+  std::ifstream in(kFile, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+void WriteFile(const std::vector<uint8_t> &bytes) {
+  std::ofstream out(kFile, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+}
+
+int64_t ScanSum(const hpq::ScanOptions &options) {
+  hpq::ParquetScanner scanner(kFile, options);
+  hpq::ScanBatch batch;
+  int64_t sum = 0;
+  while (scanner.Next(&batch)) {
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      sum += batch.columns[0].values<int64_t>()[i];
+  }
+  return sum;
+}
+
+void TestPageChecksums(bool async) {
+  std::cout << "Testing page_checksums (" << (async ? "async" : "sync")
+            << ")..." << std::endl;
+  const int n = 30000;
+  std::vector<int64_t> values(n);
+  for (int i = 0; i < n; ++i)
+    values[i] = i;
+  hpq::Schema schema;
+  schema.AddColumn("v", hpq::Type::INT64, false);
+  hpq::WriterOptions options;
+  options.row_group_size = 10000;
+  options.data_page_size = 16 * 1024;
+  options.compression = "NONE";
+  options.use_dictionary = false;
+  options.page_checksums = true;
+  options.async = async;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    writer.WriteColumn(0, values.data(), n);
+    writer.Close();
+  }
+  const int64_t expect = static_cast<int64_t>(n) * (n - 1) / 2;
+  assert(ScanSum(hpq::ScanOptions()) == expect);
+
+  // Every page header carries the CRC of the bytes that follow it
+  std::vector<uint8_t> bytes = ReadFile();
+  int64_t offset = 0;
+  {
+    hpq::ParquetScanner scanner(kFile);
+    offset = scanner.metadata().row_groups[1].columns[0].data_page_offset;
+  }
+  hpq::PageHeader header;
+  size_t header_len = hpq::ParsePageHeader(bytes.data() + offset,
+                                           bytes.size() - offset, &header);
+  assert(header.crc);
+  const uint8_t *body = bytes.data() + offset + header_len;
+  assert(static_cast<int32_t>(hpq::Crc32(
+             body, header.compressed_page_size)) == *header.crc);
+
+  // A flipped bit is caught, unless verification is off
+  bytes[offset + header_len + header.compressed_page_size - 1] ^= 0x10;
+  WriteFile(bytes);
+  bool threw = false;
+  try {
+    ScanSum(hpq::ScanOptions());
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+  hpq::ScanOptions unchecked;
+  unchecked.verify_checksums = false;
+  assert(ScanSum(unchecked) != expect);
+}
+
+int main() {
+  TestCrc32();
+  TestPageChecksums(false);
+  TestPageChecksums(true);
+  std::remove(kFile);
+  std::cout << "test_crc32 passed!" << std::endl;
+  return 0;
+}
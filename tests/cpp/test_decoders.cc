@@ -0,0 +1,148 @@
+#include "hpq/encodings/bitpack.h"
+#include "hpq/encodings/boolean.h"
+#include "hpq/encodings/byte_stream_split.h"
+#include "hpq/encodings/delta.h"
+#include "hpq/encodings/dict_encoding.h"
+#include "hpq/encodings/rle.h"
+#include "round_trip.h"
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+void TestUnpackBits() {
+  std::cout << "Testing UnpackBits..." << std::endl;
+  std::mt19937 rng(1);
+  for (int width = 0; width <= 32; ++width) {
+    for (size_t n : {1, 7, 8, 9, 31, 100, 1003}) {
+      const uint32_t mask =
+          width == 32 ? ~0u : static_cast<uint32_t>((1ull << width) - 1);
+      std::vector<int32_t> values(n);
+      for (auto &v : values)
+        v = static_cast<int32_t>(rng() & mask);
+      hpq::BitPackEncoder encoder(width);
+      hpq::BitPackDecoder decoder(width);
+      RoundTrip(encoder, decoder, values, 13);
+    }
+  }
+}
+
+void TestRle() {
+  std::cout << "Testing RleDecoder..." << std::endl;
+  std::mt19937 rng(2);
+  for (int width : {1, 3, 8, 17, 32}) {
+    const uint32_t mask =
+        width == 32 ? ~0u : static_cast<uint32_t>((1ull << width) - 1);
+    std::vector<int32_t> values;
+    // Alternate long runs with short literal stretches of odd length.
+    for (int block = 0; block < 40; ++block) {
+      int32_t run_value = static_cast<int32_t>(rng() & mask);
+      values.insert(values.end(), 5 + rng() % 50, run_value);
+      for (int k = 0, len = 1 + rng() % 13; k < len; ++k)
+        values.push_back(static_cast<int32_t>(rng() & mask));
+    }
+    hpq::RleEncoder encoder(width);
+    hpq::RleDecoder decoder(width);
+    RoundTrip(encoder, decoder, values);
+  }
+}
+
+template <typename DType> void TestDeltaType() {
+  using T = typename DType::c_type;
+  std::mt19937_64 rng(3);
+  std::vector<T> values = {std::numeric_limits<T>::max(),
+                           std::numeric_limits<T>::min(), 0, -1, 1};
+  T v = 0;
+  for (int i = 0; i < 5000; ++i) {
+    v = static_cast<T>(v + static_cast<T>(rng() % 200) - 100);
+    values.push_back(v);
+  }
+  for (int i = 0; i < 300; ++i)
+    values.push_back(static_cast<T>(rng()));
+  hpq::DeltaEncoder encoder(DType::type);
+  hpq::DeltaDecoder decoder(DType::type);
+  RoundTrip(encoder, decoder, values);
+
+  std::vector<T> single = {42};
+  hpq::DeltaEncoder encoder1(DType::type);
+  hpq::DeltaDecoder decoder1(DType::type);
+  RoundTrip(encoder1, decoder1, single);
+}
+
+void TestDelta() {
+  std::cout << "Testing DeltaDecoder..." << std::endl;
+  TestDeltaType<hpq::Int32Type>();
+  TestDeltaType<hpq::Int64Type>();
+}
+
+void TestDict() {
+  std::cout << "Testing DictDecoder..." << std::endl;
+  std::mt19937 rng(4);
+  std::vector<int64_t> ints(3001);
+  for (auto &v : ints)
+    v = static_cast<int64_t>(rng() % 100) * 1000000007LL;
+  hpq::DictEncoder int_encoder(hpq::Type::INT64);
+  hpq::DictDecoder int_decoder(hpq::Type::INT64);
+  RoundTrip(int_encoder, int_decoder, ints);
+
+  std::vector<double> doubles(777);
+  for (auto &v : doubles)
+    v = static_cast<double>(rng() % 7) * 0.5;
+  hpq::DictEncoder double_encoder(hpq::Type::DOUBLE);
+  hpq::DictDecoder double_decoder(hpq::Type::DOUBLE);
+  RoundTrip(double_encoder, double_decoder, doubles);
+}
+
+void TestBoolean() {
+  std::cout << "Testing BooleanDecoder..." << std::endl;
+  std::mt19937 rng(5);
+  std::vector<uint8_t> values(2049);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = i < 700 ? (i / 100) % 2 : rng() % 2;
+  for (auto encoding : {hpq::Encoding::PLAIN, hpq::Encoding::RLE}) {
+    hpq::BooleanEncoder encoder(encoding);
+    hpq::BooleanDecoder decoder(encoding);
+    RoundTrip(encoder, decoder, values);
+  }
+}
+
+void TestByteStreamSplit() {
+  std::cout << "Testing ByteStreamSplitDecoder..." << std::endl;
+  std::mt19937 rng(6);
+  std::vector<float> floats(1001);
+  for (auto &v : floats)
+    v = static_cast<float>(rng()) / 7.0f;
+  hpq::ByteStreamSplitEncoder float_encoder(hpq::Type::FLOAT);
+  hpq::ByteStreamSplitDecoder float_decoder(hpq::Type::FLOAT);
+  RoundTrip(float_encoder, float_decoder, floats);
+
+  std::vector<double> doubles(515);
+  for (auto &v : doubles)
+    v = static_cast<double>(rng()) * 1e-3;
+  hpq::ByteStreamSplitEncoder double_encoder(hpq::Type::DOUBLE);
+  hpq::ByteStreamSplitDecoder double_decoder(hpq::Type::DOUBLE);
+  RoundTrip(double_encoder, double_decoder, doubles);
+}
+
+void TestPlain() {
+  std::cout << "Testing PlainDecoder..." << std::endl;
+  std::vector<double> values = {1.5, -2.25, 3e100, 0.0, 7.0};
+  hpq::PlainEncoder<hpq::DoubleType> encoder;
+  auto decoder = hpq::MakePlainDecoder(hpq::Type::DOUBLE);
+  RoundTrip(encoder, *decoder, values, 2);
+}
+
+int main() {
+  TestUnpackBits();
+  TestRle();
+  TestDelta();
+  TestDict();
+  TestBoolean();
+  TestByteStreamSplit();
+  TestPlain();
+  std::cout << "test_decoders passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include "hpq/encodings/adaptive.h"
+#include "hpq/encodings/delta_byte_array.h"
+#include "round_trip.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+std::vector<hpq::ByteArray> Views(const std::vector<std::string> &strings) {
+  std::vector<hpq::ByteArray> views;
+  for (const auto &s : strings)
+    views.push_back({reinterpret_cast<const uint8_t *>(s.data()),
+                     static_cast<uint32_t>(s.size())});
+  return views;
+}
+
+// Sorted keys sharing long prefixes
+std::vector<std::string> SortedUrls(int n) {
+  std::vector<std::string> urls;
+  for (int i = 0; i < n; ++i)
+    urls.push_back("https://storage.example.com/tenants/tenant-" +
+                   std::to_string(1000 + i / 100) + "/objects/" +
+                   std::to_string(100000 + i));
+  return urls;
+}
+
+std::vector<std::string> RandomStrings(int n) {
+  std::mt19937 rng(9);
+  std::vector<std::string> strings(n);
+  for (auto &s : strings) {
+    s.resize(rng() % 40);
+    for (auto &c : s)
+      c = static_cast<char>('a' + rng() % 26);
+  }
+  return strings;
+}
+
+void TestCommonPrefix() {
+  std::cout << "Testing CommonPrefixLength..." << std::endl;
+  std::vector<uint8_t> a(200, 'x');
+  for (size_t n : {0, 1, 15, 16, 17, 31, 32, 33, 64, 100, 200}) {
+    for (size_t mismatch = 0; mismatch <= n; ++mismatch) {
+      std::vector<uint8_t> b = a;
+      if (mismatch < n)
+        b[mismatch] = 'y';
+      assert(hpq::CommonPrefixLength(a.data(), b.data(), n) == mismatch);
+    }
+  }
+}
+
+void TestRoundTrips() {
+  std::cout << "Testing DELTA_LENGTH_BYTE_ARRAY / DELTA_BYTE_ARRAY..."
+            << std::endl;
+  const std::vector<std::vector<std::string>> inputs = {
+      SortedUrls(5000), RandomStrings(3000), {""}, {"", "", "a", "", "ab"}};
+  for (const auto &strings : inputs) {
+    hpq::DeltaLengthByteArrayEncoder dlba;
+    hpq::DeltaLengthByteArrayDecoder dlba_decoder;
+    RoundTrip(dlba, dlba_decoder, Views(strings));
+    hpq::DeltaByteArrayEncoder dba;
+    hpq::DeltaByteArrayDecoder dba_decoder;
+    RoundTrip(dba, dba_decoder, Views(strings));
+    hpq::PlainEncoder<hpq::ByteArrayType> plain;
+    hpq::PlainDecoder<hpq::ByteArrayType> plain_decoder;
+    RoundTrip(plain, plain_decoder, Views(strings));
+  }
+
+  // Prefix encoding shrinks sorted keys several-fold
+  const auto urls = SortedUrls(5000);
+  const auto url_views = Views(urls);
+  hpq::PlainEncoder<hpq::ByteArrayType> plain;
+  hpq::DeltaByteArrayEncoder dba;
+  hpq::PlainDecoder<hpq::ByteArrayType> plain_decoder;
+  hpq::DeltaByteArrayDecoder dba_decoder;
+  size_t plain_size = RoundTrip(plain, plain_decoder, url_views);
+  size_t dba_size = RoundTrip(dba, dba_decoder, url_views);
+  dba.Clear();
+  std::cout << "  sorted URLs: PLAIN " << plain_size << " bytes, "
+            << "DELTA_BYTE_ARRAY " << dba_size << " bytes" << std::endl;
+  assert(dba_size * 4 < plain_size);
+
+  // Corrupt prefix lengths are rejected
+  auto views = Views({"abc", "abd"});
+  dba.Put(views.data(), 2);
+  auto encoded = dba.Flush();
+  hpq::DeltaByteArrayDecoder truncated;
+  bool threw = false;
+  try {
+    truncated.SetData(encoded.first, encoded.second - 1, 2);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+void TestAdaptive() {
+  std::cout << "Testing adaptive BYTE_ARRAY choice..." << std::endl;
+  hpq::AdaptiveEncoder encoder(hpq::Type::BYTE_ARRAY);
+  auto urls = SortedUrls(2000);
+  auto views = Views(urls);
+  encoder.Put(views.data(), static_cast<int>(views.size()));
+  urls.clear(); // Values were copied on Put()
+  encoder.Flush();
+  assert(encoder.encoding() == hpq::Encoding::DELTA_BYTE_ARRAY);
+  encoder.Clear();
+
+  auto random = RandomStrings(2000);
+  views = Views(random);
+  encoder.Put(views.data(), static_cast<int>(views.size()));
+  encoder.Flush();
+  assert(encoder.encoding() == hpq::Encoding::DELTA_LENGTH_BYTE_ARRAY);
+}
+
+int main() {
+  TestCommonPrefix();
+  TestRoundTrips();
+  TestAdaptive();
+  std::cout << "test_delta_byte_array passed!" << std::endl;
+  return 0;
+}
@@ -2,6 +2,8 @@
 #include <cassert>
 #include <cstring>
 #include <iostream>
+#include <random>
+#include <set>
 #include <vector>
 
 void TestDictEncodingInt64() {
@@ -40,8 +42,52 @@ void TestDictEncodingInt64() {
   }
 }
 
+// Each chunk decodes on its own and its dictionary holds only its values.
+void CheckChunk(hpq::TypedDictEncoder<hpq::Int64Type> &encoder,
+                const std::vector<int64_t> &values) {
+  encoder.PutTyped(values.data(), static_cast<int>(values.size()));
+  auto encoded = encoder.Flush();
+  std::vector<uint8_t> copy(encoded.first, encoded.first + encoded.second);
+  hpq::TypedDictDecoder<hpq::Int64Type> decoder;
+  decoder.SetData(copy.data(), copy.size(), static_cast<int>(values.size()));
+  std::set<int64_t> distinct(values.begin(), values.end());
+  assert(decoder.dictionary_size() == static_cast<int>(distinct.size()));
+  std::vector<int64_t> out(values.size());
+  assert(decoder.DecodeTyped(out.data(), static_cast<int>(out.size())) ==
+         static_cast<int>(values.size()));
+  assert(out == values);
+  encoder.Clear();
+}
+
+void TestWarmStart() {
+  std::cout << "Testing dictionary warm-start across chunks..." << std::endl;
+  hpq::TypedDictEncoder<hpq::Int64Type> encoder;
+  std::mt19937_64 rng(3);
+
+  // Stable categories: the table is kept, chunks with a subset of the
+  // values still get a dictionary of just that subset.
+  for (int chunk = 0; chunk < 6; ++chunk) {
+    const int cardinality = chunk % 2 == 0 ? 2000 : 600;
+    std::vector<int64_t> values(20000);
+    for (auto &v : values)
+      v = static_cast<int64_t>(rng() % cardinality) * 31;
+    CheckChunk(encoder, values);
+    assert(encoder.persistent_size() == 2000);
+  }
+
+  // Drift: ever-new keys. The table is dropped instead of growing.
+  for (int chunk = 0; chunk < 6; ++chunk) {
+    std::vector<int64_t> values(5000);
+    for (size_t i = 0; i < values.size(); ++i)
+      values[i] = 1000000 + chunk * 5000 + static_cast<int64_t>(i);
+    CheckChunk(encoder, values);
+    assert(encoder.persistent_size() <= 4 * 5000);
+  }
+}
+
 int main() {
   TestDictEncodingInt64();
+  TestWarmStart();
   std::cout << "test_dict passed!" << std::endl;
   return 0;
 }
@@ -0,0 +1,226 @@
+#include "hpq/encodings/dict_encoding.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+const char *kFile = "test_logical_types.parquet";
+
+using hpq::LogicalType;
+
+void TestSchema() {
+  std::cout << "Testing logical type resolution..." << std::endl;
+  hpq::Schema schema;
+  schema.AddColumn("d9", LogicalType::Decimal(9, 2));
+  schema.AddColumn("d18", LogicalType::Decimal(18, 4));
+  schema.AddColumn("d19", LogicalType::Decimal(19, 0));
+  schema.AddColumn("d38", LogicalType::Decimal(38, 10));
+  schema.AddColumn("day", LogicalType::Date());
+  schema.AddColumn("ts", LogicalType::Timestamp(hpq::TimeUnit::kNanos));
+  schema.AddColumn("id", LogicalType::Uuid());
+  schema.AddColumn("i8", LogicalType::Int(8));
+  const auto &c = schema.columns();
+  assert(c[0].type == hpq::Type::INT32);
+  assert(c[1].type == hpq::Type::INT64);
+  assert(c[2].type == hpq::Type::FIXED_LEN_BYTE_ARRAY &&
+         c[2].type_length == 9);
+  assert(c[3].type == hpq::Type::FIXED_LEN_BYTE_ARRAY &&
+         c[3].type_length == 16);
+  assert(c[4].type == hpq::Type::INT32);
+  assert(c[5].type == hpq::Type::INT64);
+  assert(c[6].type == hpq::Type::FIXED_LEN_BYTE_ARRAY &&
+         c[6].type_length == 16);
+  assert(c[7].type == hpq::Type::INT32);
+
+  for (LogicalType bad : {LogicalType::Decimal(39, 0),
+                          LogicalType::Decimal(5, 6), LogicalType::Int(32)}) {
+    bool threw = false;
+    try {
+      schema.AddColumn("bad", bad);
+    } catch (const std::invalid_argument &) {
+      threw = true;
+    }
+    assert(threw);
+  }
+}
+
+void TestFixedLenDictionary() {
+  std::cout << "Testing FIXED_LEN_BYTE_ARRAY dictionary encoding..."
+            << std::endl;
+  const int width = 9;
+  hpq::FixedLenDictEncoder encoder(width);
+  std::mt19937 rng(5);
+  for (int chunk = 0; chunk < 3; ++chunk) {
+    // 50 distinct keys, every chunk
+    std::vector<uint8_t> values(4000 * width);
+    for (size_t i = 0; i < values.size(); i += width) {
+      const int key = static_cast<int>(rng() % 50);
+      for (int b = 0; b < width; ++b)
+        values[i + b] = static_cast<uint8_t>(key * 7 + b);
+    }
+    encoder.Put(values.data(), 4000);
+    auto encoded = encoder.Flush();
+    std::vector<uint8_t> copy(encoded.first, encoded.first + encoded.second);
+    assert(copy.size() < values.size() / 4);
+
+    hpq::DictDecoder decoder(hpq::Type::FIXED_LEN_BYTE_ARRAY, width);
+    decoder.SetData(copy.data(), copy.size(), 4000);
+    std::vector<uint8_t> out(values.size());
+    assert(decoder.Decode(out.data(), 1234) == 1234);
+    assert(decoder.Decode(out.data() + 1234 * width, 4000) == 4000 - 1234);
+    assert(out == values);
+    encoder.Clear();
+    assert(encoder.persistent_size() == 50);
+  }
+}
+
+// Decimal input is 16-byte little-endian two's complement.
+struct Row {
+  __int128 price;    // DECIMAL(9, 2) -> INT32
+  __int128 notional; // DECIMAL(18, 4) -> INT64
+  __int128 big;      // DECIMAL(30, 6) -> FIXED_LEN_BYTE_ARRAY(13)
+  int64_t ts;
+  int32_t day;
+  int16_t qty;
+  uint8_t level;
+  uint8_t id[16];
+};
+
+hpq::Schema RowSchema() {
+  hpq::Schema schema;
+  schema.AddColumn("price", LogicalType::Decimal(9, 2), false);
+  schema.AddColumn("notional", LogicalType::Decimal(18, 4), false);
+  schema.AddColumn("big", LogicalType::Decimal(30, 6), false);
+  schema.AddColumn("ts", LogicalType::Timestamp(hpq::TimeUnit::kMillis),
+                   false);
+  schema.AddColumn("day", LogicalType::Date(), false);
+  schema.AddColumn("qty", LogicalType::Int(16), false);
+  schema.AddColumn("level", LogicalType::Int(8, false), false);
+  schema.AddColumn("id", LogicalType::Uuid(), false);
+  const size_t offsets[] = {offsetof(Row, price), offsetof(Row, notional),
+                            offsetof(Row, big),   offsetof(Row, ts),
+                            offsetof(Row, day),   offsetof(Row, qty),
+                            offsetof(Row, level), offsetof(Row, id)};
+  for (size_t c = 0; c < 8; ++c)
+    schema.SetFieldOffset(c, offsets[c]);
+  return schema;
+}
+
+std::vector<Row> MakeRows(int n) {
+  std::vector<Row> rows(n);
+  for (int i = 0; i < n; ++i) {
+    Row &r = rows[i];
+    r.price = i % 2 ? -i * 101 : i * 99;
+    r.notional = static_cast<__int128>(i) * 1000000007LL;
+    r.big = static_cast<__int128>(i - 1500) * 1000000000000000000LL;
+    r.ts = 1700000000000LL + i;
+    r.day = 19000 + i;
+    r.qty = static_cast<int16_t>(-i);
+    r.level = static_cast<uint8_t>(200 + i % 50);
+    for (int b = 0; b < 16; ++b)
+      r.id[b] = static_cast<uint8_t>(i * 31 + b);
+  }
+  return rows;
+}
+
+template <typename T>
+std::vector<T> Field(const std::vector<Row> &rows, T Row::*field) {
+  std::vector<T> out;
+  for (const Row &r : rows)
+    out.push_back(r.*field);
+  return out;
+}
+
+void CheckFile(const std::vector<Row> &rows) {
+  hpq::ParquetScanner scanner(kFile);
+  const auto &schema = scanner.metadata().schema;
+  const hpq::Schema expect = RowSchema();
+  for (size_t c = 0; c < schema.size(); ++c) {
+    assert(schema[c].type == expect.columns()[c].type);
+    assert(schema[c].type_length == expect.columns()[c].type_length);
+    assert(schema[c].logical_type == expect.columns()[c].logical_type);
+  }
+  assert(schema[2].type_length == 13);
+
+  size_t i = 0;
+  hpq::ScanBatch batch;
+  while (scanner.Next(&batch)) {
+    const auto &col = batch.columns;
+    for (int64_t k = 0; k < batch.num_rows; ++k, ++i) {
+      const Row &r = rows[i];
+      assert(col[0].values<int32_t>()[k] == static_cast<int32_t>(r.price));
+      assert(col[1].values<int64_t>()[k] ==
+             static_cast<int64_t>(r.notional));
+      // Big-endian, sign-extended from 13 bytes
+      const uint8_t *be = col[2].values<uint8_t>() + k * 13;
+      __int128 big = static_cast<int8_t>(be[0]);
+      for (int b = 1; b < 13; ++b)
+        big = big * 256 + be[b];
+      assert(big == r.big);
+      assert(col[3].values<int64_t>()[k] == r.ts);
+      assert(col[4].values<int32_t>()[k] == r.day);
+      assert(col[5].values<int32_t>()[k] == r.qty);
+      assert(col[6].values<int32_t>()[k] == r.level);
+      assert(std::memcmp(col[7].values<uint8_t>() + k * 16, r.id, 16) == 0);
+    }
+  }
+  assert(i == rows.size());
+}
+
+void TestWriteRead(bool rows_api) {
+  std::cout << "Testing logical types through "
+            << (rows_api ? "WriteRows" : "WriteColumn") << "..." << std::endl;
+  const int n = 3000;
+  const std::vector<Row> rows = MakeRows(n);
+  hpq::WriterOptions options;
+  options.row_group_size = 1000;
+  options.bloom_filter_columns = {"id"};
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(RowSchema());
+    if (rows_api) {
+      writer.WriteRows(rows.data(), sizeof(Row), n);
+    } else {
+      // Out-of-range decimals are rejected before anything is staged.
+      const __int128 too_big = 1000000000;
+      bool threw = false;
+      try {
+        writer.WriteColumn(0, &too_big, 1);
+      } catch (const std::runtime_error &) {
+        threw = true;
+      }
+      assert(threw);
+
+      writer.WriteColumn(0, Field(rows, &Row::price).data(), n);
+      writer.WriteColumn(1, Field(rows, &Row::notional).data(), n);
+      writer.WriteColumn(2, Field(rows, &Row::big).data(), n);
+      writer.WriteColumn(3, Field(rows, &Row::ts).data(), n);
+      writer.WriteColumn(4, Field(rows, &Row::day).data(), n);
+      writer.WriteColumn(5, Field(rows, &Row::qty).data(), n);
+      writer.WriteColumn(6, Field(rows, &Row::level).data(), n);
+      std::vector<uint8_t> ids;
+      for (const Row &r : rows)
+        ids.insert(ids.end(), r.id, r.id + 16);
+      writer.WriteColumn(7, ids.data(), n);
+    }
+    writer.Close();
+  }
+  CheckFile(rows);
+}
+
+int main() {
+  TestSchema();
+  TestFixedLenDictionary();
+  TestWriteRead(false);
+  TestWriteRead(true);
+  std::remove(kFile);
+  std::cout << "test_logical_types passed!" << std::endl;
+  return 0;
+}
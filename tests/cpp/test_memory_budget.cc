@@ -0,0 +1,146 @@
+#include "hpq/encodings/dict_encoding.h"
+#include "hpq/schema.h"
+#include "hpq/util/memory_budget.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+void TestConsumerAccounting() {
+  std::cout << "Testing MemoryBudget accounting..." << std::endl;
+  hpq::MemoryBudget budget(1000, 0.5);
+  {
+    hpq::MemoryConsumer small(&budget);
+    hpq::MemoryConsumer large(&budget);
+    small.Reserve(100);
+    large.Reserve(300);
+    assert(budget.used() == 400);
+    assert(!small.TakeFlushRequest() && !large.TakeFlushRequest());
+
+    // Crossing 50% asks the largest consumer, not the one reserving.
+    small.Reserve(150);
+    assert(budget.over_threshold());
+    assert(large.TakeFlushRequest());
+    assert(!large.TakeFlushRequest()); // Consumed
+    assert(!small.TakeFlushRequest());
+
+    large.Release(300);
+    assert(budget.used() == 250 && large.reserved() == 0);
+  } // Outstanding reservations are returned on destruction
+  assert(budget.used() == 0);
+
+  hpq::MemoryConsumer unbudgeted;
+  unbudgeted.Reserve(10);
+  assert(unbudgeted.reserved() == 10);
+}
+
+void TestSharedBudgetBoundsWriters() {
+  std::cout << "Testing writers sharing a MemoryBudget..." << std::endl;
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  schema.AddColumn("v", hpq::Type::INT32, false);
+
+  const size_t kLimit = 1 << 20;
+  auto budget = std::make_shared<hpq::MemoryBudget>(kLimit);
+  hpq::WriterOptions options;
+  options.row_group_size = 1 << 20; // Never reached without the budget
+  options.data_page_size = 32 * 1024;
+  options.memory_budget = budget;
+
+  hpq::ParquetWriter a("test_memory_budget_a.parquet", options);
+  hpq::ParquetWriter b("test_memory_budget_b.parquet", options);
+  a.Init(schema);
+  b.Init(schema);
+
+  const int kBatch = 4096;
+  std::vector<int64_t> ids(kBatch);
+  std::vector<int32_t> v(kBatch, 7);
+  size_t peak = 0;
+  for (int batch = 0; batch < 200; ++batch) {
+    std::iota(ids.begin(), ids.end(), int64_t(batch) * kBatch);
+    for (hpq::ParquetWriter *w : {&a, &b}) {
+      w->WriteColumn(0, ids.data(), kBatch);
+      w->WriteColumn(1, v.data(), kBatch);
+      peak = std::max(peak, budget->used());
+    }
+  }
+  // 2 x 200 x 4096 rows of 12 bytes is ~9.4 MiB; the budget plus one
+  // batch of pages per writer must hold it well below that.
+  std::cout << "  peak budget usage: " << peak << " bytes" << std::endl;
+  assert(peak <= kLimit + 4 * options.data_page_size + 2 * kBatch * 12);
+  assert(a.buffered_bytes() + b.buffered_bytes() == budget->used());
+
+  a.Close();
+  b.Close();
+  assert(budget->used() == 0);
+}
+
+// A column writer whose dictionary grows is the one asked to flush, even
+// though its staged pages are smaller than its neighbour's.
+void TestDictionaryCharge() {
+  std::cout << "Testing dictionary state charged to a MemoryBudget..."
+            << std::endl;
+  const size_t kLimit = 1 << 20;
+  hpq::MemoryBudget budget(kLimit);
+  hpq::MemoryConsumer other(&budget);
+  other.Reserve(128 * 1024);
+  hpq::MemoryConsumer column(&budget);
+  column.Reserve(64 * 1024);
+
+  const int kChunk = 8192;
+  std::vector<int64_t> values(kChunk);
+  {
+    hpq::TypedDictEncoder<hpq::Int64Type> encoder(&column);
+    // Low cardinality: the table stays small
+    for (int chunk = 0; chunk < 4; ++chunk) {
+      for (int i = 0; i < kChunk; ++i)
+        values[i] = i % 16;
+      encoder.PutTyped(values.data(), kChunk);
+      encoder.Flush();
+      encoder.Clear();
+    }
+    assert(!budget.over_threshold());
+    assert(!other.TakeFlushRequest() && !column.TakeFlushRequest());
+
+    // High cardinality: every chunk adds distinct keys to the persisted
+    // table until the budget asks this column to end its row group.
+    int chunks = 0;
+    while (!column.TakeFlushRequest()) {
+      assert(++chunks < 64);
+      for (int i = 0; i < kChunk; ++i)
+        values[i] = int64_t(chunks) * kChunk + i;
+      encoder.PutTyped(values.data(), kChunk);
+      encoder.Flush();
+      encoder.Clear();
+    }
+    assert(budget.over_threshold());
+    assert(column.reserved() > other.reserved());
+    assert(!other.TakeFlushRequest());
+    assert(encoder.persistent_size() > 0);
+  } // The encoder returns its charge
+  assert(column.reserved() == 64 * 1024);
+  assert(budget.used() == 192 * 1024);
+
+  hpq::MemoryConsumer fixed(&budget);
+  {
+    hpq::DictEncoder encoder(hpq::Type::FIXED_LEN_BYTE_ARRAY, 16, &fixed);
+    std::vector<uint8_t> keys(kChunk * 16);
+    for (int k = 0; k < kChunk; ++k)
+      std::memcpy(&keys[k * 16], &k, sizeof(k)); // Distinct keys
+    encoder.Put(keys.data(), kChunk);
+    encoder.Flush();
+    assert(fixed.reserved() >= keys.size());
+  }
+  assert(fixed.reserved() == 0);
+}
+
+int main() {
+  TestConsumerAccounting();
+  TestSharedBudgetBoundsWriters();
+  TestDictionaryCharge();
+  std::cout << "test_memory_budget passed!" << std::endl;
+  return 0;
+}
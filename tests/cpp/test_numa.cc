@@ -0,0 +1,108 @@
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/util/numa.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+const char *kFile = "test_numa.parquet";
+
+void TestTopology() {
+  std::cout << "Testing NUMA topology and placement..." << std::endl;
+  const hpq::NumaTopology &topology = hpq::NumaTopology::Get();
+  assert(!topology.nodes.empty());
+  assert(topology.cpus.size() == topology.nodes.size());
+  for (size_t i = 0; i < topology.nodes.size(); ++i) {
+    assert(!topology.cpus[i].empty());
+    assert(topology.IndexOf(topology.nodes[i]) == static_cast<int>(i));
+  }
+  assert(topology.IndexOf(-7) == -1);
+  std::cout << "  " << topology.nodes.size() << " node(s)" << std::endl;
+
+  // Pinned to a node, a thread runs on it
+  const int node = topology.nodes.back();
+  std::thread([node] {
+    if (hpq::PinThreadToNode(node))
+      assert(hpq::CurrentNumaNode() == node);
+  }).join();
+
+  // A bound buffer is backed by its node once touched
+  std::vector<uint8_t> buffer;
+  buffer.reserve(4 << 20);
+  hpq::BindToNumaNode(buffer.data(), buffer.capacity(), node);
+  hpq::AdviseHugePages(buffer.data(), buffer.capacity());
+  buffer.resize(buffer.capacity(), 1);
+  const int placed = hpq::NumaNodeOfAddress(buffer.data() + (2 << 20));
+  assert(placed == -1 || placed == node || topology.nodes.size() > 1);
+
+  // Ranges without a whole page are ignored
+  uint8_t small[16] = {};
+  hpq::BindToNumaNode(small, sizeof(small), node);
+  hpq::AdviseHugePages(small, sizeof(small));
+}
+
+void TestWriter(bool async) {
+  std::cout << "Testing numa_aware writer (" << (async ? "async" : "sync")
+            << ")..." << std::endl;
+  const int n = 200000;
+  std::vector<int64_t> a(n);
+  std::vector<double> b(n);
+  for (int i = 0; i < n; ++i) {
+    a[i] = i * 3;
+    b[i] = i * 0.5;
+  }
+  hpq::Schema schema;
+  schema.AddColumn("a", hpq::Type::INT64, false);
+  schema.AddColumn("b", hpq::Type::DOUBLE, false);
+  hpq::WriterOptions options;
+  options.row_group_size = 50000;
+  options.data_page_size = 256 * 1024;
+  options.async = async;
+  options.encode_threads = 2;
+  options.numa_aware = true;
+  options.pin_threads = hpq::ThreadPinning::kCore;
+  options.use_huge_pages = true;
+  options.huge_page_threshold = 128 * 1024;
+
+  hpq::WriterStats stats;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    writer.WriteColumn(0, a.data(), n);
+    writer.WriteColumn(1, b.data(), n);
+    writer.Close();
+    stats = writer.stats();
+  }
+  std::cout << "  pages " << stats.pages << ", local "
+            << stats.pages_numa_local << ", remote "
+            << stats.pages_numa_remote << ", threads pinned "
+            << stats.threads_pinned << std::endl;
+  assert(stats.pages_numa_local + stats.pages_numa_remote <= stats.pages);
+  if (hpq::NumaTopology::Get().nodes.size() == 1)
+    assert(stats.pages_numa_remote == 0);
+  // Two encoders plus the compress and write threads
+  assert(stats.threads_pinned <= (async ? 4 : 0));
+
+  hpq::ParquetScanner scanner(kFile);
+  hpq::ScanBatch batch;
+  int64_t i = 0;
+  while (scanner.Next(&batch)) {
+    for (int64_t k = 0; k < batch.num_rows; ++k, ++i) {
+      assert(batch.columns[0].values<int64_t>()[k] == a[i]);
+      assert(batch.columns[1].values<double>()[k] == b[i]);
+    }
+  }
+  assert(i == n);
+}
+
+int main() {
+  TestTopology();
+  TestWriter(false);
+  TestWriter(true);
+  std::remove(kFile);
+  std::cout << "test_numa passed!" << std::endl;
+  return 0;
+}
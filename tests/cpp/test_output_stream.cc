@@ -0,0 +1,211 @@
+#include "hpq/io/output_stream.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <climits>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+const char *kFile = "test_output_stream.parquet";
+
+std::vector<uint8_t> ReadFile(const char *path) {
+  std::ifstream in(path, std::ios::binary);
+  return {std::istreambuf_iterator<char>(in), {}};
+}
+
+// Drains the read end of a pipe on a thread until EOF.
+class PipeReader {
+public:
+  PipeReader() {
+    int fds[2];
+    assert(::pipe(fds) == 0);
+    read_fd_ = fds[0];
+    write_fd = fds[1];
+    thread_ = std::thread([this] {
+      uint8_t buf[4096];
+      ssize_t n;
+      while ((n = ::read(read_fd_, buf, sizeof(buf))) > 0)
+        bytes_.insert(bytes_.end(), buf, buf + n);
+    });
+  }
+
+  // Call after the write end is closed.
+  std::vector<uint8_t> Finish() {
+    thread_.join();
+    ::close(read_fd_);
+    return std::move(bytes_);
+  }
+
+  int write_fd = -1;
+
+private:
+  int read_fd_ = -1;
+  std::thread thread_;
+  std::vector<uint8_t> bytes_;
+};
+
+void TestWritev() {
+  std::cout << "Testing WritevAll over a pipe..." << std::endl;
+  // More buffers than IOV_MAX, and more bytes than the pipe holds, so
+  // writev returns short counts that end mid-buffer.
+  std::vector<std::vector<uint8_t>> pieces;
+  std::vector<uint8_t> expect;
+  for (int i = 0; i < 3000; ++i) {
+    pieces.emplace_back(static_cast<size_t>(i % 7 == 0 ? 0 : i % 500),
+                        static_cast<uint8_t>(i));
+    expect.insert(expect.end(), pieces.back().begin(), pieces.back().end());
+  }
+  std::vector<iovec> iov;
+  for (auto &p : pieces)
+    iov.push_back({p.data(), p.size()});
+  assert(iov.size() > IOV_MAX);
+
+  PipeReader reader;
+  auto out = std::make_unique<hpq::FdOutputStream>(reader.write_fd, true);
+  out->Writev(iov.data(), static_cast<int>(iov.size()));
+  out->Write("tail", 4);
+  expect.insert(expect.end(), {'t', 'a', 'i', 'l'});
+  assert(out->Tell() == static_cast<int64_t>(expect.size()));
+  out->Close();
+  out->Close();
+  assert(reader.Finish() == expect);
+
+  hpq::BufferOutputStream buffer;
+  buffer.Writev(iov.data(), static_cast<int>(iov.size()));
+  buffer.Write("tail", 4);
+  assert(buffer.buffer() == expect);
+}
+
+std::vector<int64_t> Values(int n) {
+  std::vector<int64_t> values(n);
+  for (int i = 0; i < n; ++i)
+    values[i] = static_cast<int64_t>(i) * 2654435761LL % 100003;
+  return values;
+}
+
+// Writes the same data to `writer` and closes it.
+void WriteData(hpq::ParquetWriter &writer) {
+  hpq::Schema schema;
+  schema.AddColumn("a", hpq::Type::INT64, false);
+  schema.AddColumn("b", hpq::Type::INT64, true);
+  writer.Init(schema);
+  const std::vector<int64_t> values = Values(50000);
+  writer.WriteColumn(0, values.data(), static_cast<int>(values.size()));
+  writer.WriteColumn(1, values.data(), static_cast<int>(values.size()));
+  writer.Close();
+}
+
+void TestWriterSinks(bool async) {
+  std::cout << "Testing ParquetWriter sinks (" << (async ? "async" : "sync")
+            << ")..." << std::endl;
+  hpq::WriterOptions options;
+  options.row_group_size = 20000;
+  options.data_page_size = 8 * 1024;
+  options.async = async;
+
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    WriteData(writer);
+  }
+  const std::vector<uint8_t> file_bytes = ReadFile(kFile);
+
+  // In memory
+  auto buffer = std::make_shared<hpq::BufferOutputStream>();
+  {
+    hpq::ParquetWriter writer(buffer, options);
+    WriteData(writer);
+  }
+  assert(buffer->buffer() == file_bytes);
+
+  // Through a pipe
+  PipeReader reader;
+  {
+    hpq::ParquetWriter writer(
+        std::make_shared<hpq::FdOutputStream>(reader.write_fd, true),
+        options);
+    WriteData(writer);
+  }
+  assert(reader.Finish() == file_bytes);
+
+  // And the file itself reads back
+  hpq::ParquetScanner scanner(kFile);
+  const std::vector<int64_t> values = Values(50000);
+  hpq::ScanBatch batch;
+  size_t i = 0;
+  while (scanner.Next(&batch)) {
+    for (int64_t k = 0; k < batch.num_rows; ++k, ++i) {
+      assert(batch.columns[0].values<int64_t>()[k] == values[i]);
+      assert(batch.columns[1].values<int64_t>()[k] == values[i]);
+    }
+  }
+  assert(i == values.size());
+}
+
+void TestBufferScan() {
+  std::cout << "Testing scan of a BufferOutputStream..." << std::endl;
+  hpq::WriterOptions options;
+  options.row_group_size = 7000;
+  options.data_page_size = 4 * 1024;
+  options.async = true;
+  auto buffer = std::make_shared<hpq::BufferOutputStream>();
+  {
+    hpq::ParquetWriter writer(buffer, options);
+    WriteData(writer);
+  }
+  // The scanner reads files, so the bytes go through one unchanged
+  const std::vector<uint8_t> bytes = buffer->Release();
+  {
+    std::ofstream out(kFile, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  }
+  hpq::ParquetScanner scanner(kFile);
+  assert(scanner.metadata().row_groups.size() == 8);
+  const std::vector<int64_t> values = Values(50000);
+  hpq::ScanBatch batch;
+  size_t i = 0;
+  while (scanner.Next(&batch)) {
+    for (int64_t k = 0; k < batch.num_rows; ++k, ++i) {
+      assert(batch.columns[0].values<int64_t>()[k] == values[i]);
+      assert(batch.columns[1].values<int64_t>()[k] == values[i]);
+    }
+  }
+  assert(i == values.size());
+}
+
+void TestFileOnlyOptions() {
+  std::cout << "Testing file-only options are rejected for streams..."
+            << std::endl;
+  for (int option = 0; option < 3; ++option) {
+    hpq::WriterOptions options;
+    options.append = option == 0;
+    options.use_mmap = option == 1;
+    options.use_direct_io = option == 2;
+    bool threw = false;
+    try {
+      hpq::ParquetWriter writer(std::make_shared<hpq::BufferOutputStream>(),
+                                options);
+    } catch (const std::invalid_argument &) {
+      threw = true;
+    }
+    assert(threw);
+  }
+}
+
+int main() {
+  TestWritev();
+  TestWriterSinks(false);
+  TestWriterSinks(true);
+  TestBufferScan();
+  TestFileOnlyOptions();
+  std::remove(kFile);
+  std::cout << "test_output_stream passed!" << std::endl;
+  return 0;
+}
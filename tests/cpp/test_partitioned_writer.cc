@@ -0,0 +1,257 @@
+#include "hpq/encodings/transpose.h"
+#include "hpq/partitioned_writer.h"
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/util/memory_budget.h"
+#include "hpq/util/thread_pool.h"
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool HasParquetMagic(const fs::path &path) {
+  std::ifstream in(path, std::ios::binary);
+  char head[4], tail[4];
+  in.read(head, 4);
+  in.seekg(-4, std::ios::end);
+  in.read(tail, 4);
+  return std::memcmp(head, "PAR1", 4) == 0 && std::memcmp(tail, "PAR1", 4) == 0;
+}
+
+// Scans a partition file of (id, value) rows, calling check on each.
+// Returns the row count.
+static int64_t
+ScanPartition(const fs::path &file,
+              const std::function<void(int64_t, double)> &check) {
+  hpq::ParquetScanner scanner(file.string());
+  hpq::ScanBatch batch;
+  int64_t rows = 0;
+  while (scanner.Next(&batch)) {
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      check(batch.columns[0].values<int64_t>()[i],
+            batch.columns[1].values<double>()[i]);
+    rows += batch.num_rows;
+  }
+  return rows;
+}
+
+void TestGatherIndexed() {
+  std::cout << "Testing GatherIndexed..." << std::endl;
+  std::vector<int64_t> values(100);
+  for (size_t i = 0; i < values.size(); ++i)
+    values[i] = static_cast<int64_t>(i * i);
+  std::vector<uint32_t> idx = {99, 0, 5, 5, 42, 7, 13, 1, 64, 2, 31};
+  std::vector<int64_t> out(idx.size());
+  hpq::GatherIndexed(reinterpret_cast<const uint8_t *>(values.data()), 8,
+                     idx.data(), idx.size(),
+                     reinterpret_cast<uint8_t *>(out.data()));
+  for (size_t i = 0; i < idx.size(); ++i)
+    assert(out[i] == values[idx[i]]);
+
+  std::vector<int32_t> narrow(100);
+  for (size_t i = 0; i < narrow.size(); ++i)
+    narrow[i] = static_cast<int32_t>(i) - 50;
+  std::vector<int32_t> out32(idx.size());
+  hpq::GatherIndexed(reinterpret_cast<const uint8_t *>(narrow.data()), 4,
+                     idx.data(), idx.size(),
+                     reinterpret_cast<uint8_t *>(out32.data()));
+  for (size_t i = 0; i < idx.size(); ++i)
+    assert(out32[i] == narrow[idx[i]]);
+}
+
+void TestThreadPool() {
+  std::cout << "Testing ThreadPool..." << std::endl;
+  std::atomic<int> sum{0};
+  {
+    hpq::ThreadPool pool(4, 8);
+    for (int i = 1; i <= 1000; ++i)
+      pool.Submit([&sum, i] { sum += i; });
+  } // Destructor drains the queue
+  assert(sum == 500500);
+}
+
+void TestPartitionedWriter() {
+  std::cout << "Testing PartitionedWriter..." << std::endl;
+  const fs::path base = "test_partitioned_output";
+  fs::remove_all(base);
+
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  schema.AddColumn("day", hpq::Type::INT32, false);
+  schema.AddColumn("value", hpq::Type::DOUBLE);
+
+  // The caller's pool is shared, not replaced
+  auto pool = std::make_shared<hpq::ThreadPool>(2);
+  hpq::WriterOptions options;
+  options.encode_pool = pool;
+  options.data_page_size = 16 * 1024;
+  const size_t kLimit = 256 * 1024;
+  hpq::PartitionedWriter writer(base.string(), schema, 1, options, kLimit);
+
+  const int kBatch = 10000;
+  std::vector<int64_t> ids(kBatch);
+  std::vector<int32_t> days(kBatch);
+  std::vector<double> values(kBatch);
+  for (int batch = 0; batch < 20; ++batch) {
+    for (int i = 0; i < kBatch; ++i) {
+      int64_t row = static_cast<int64_t>(batch) * kBatch + i;
+      ids[i] = row;
+      days[i] = 19000 + static_cast<int32_t>((row * 7919) % 7);
+      values[i] = row * 0.5;
+    }
+    writer.WriteBatch({ids.data(), days.data(), values.data()}, kBatch);
+  }
+  assert(writer.num_partitions() == 7);
+  assert(pool.use_count() > 7); // Held by each partition writer
+  writer.Close();
+
+  // Every row landed in the partition of its key
+  int64_t total = 0;
+  for (int d = 0; d < 7; ++d) {
+    fs::path file =
+        base / ("day=" + std::to_string(19000 + d)) / "part-0.parquet";
+    assert(fs::exists(file));
+    assert(HasParquetMagic(file));
+    total += ScanPartition(file, [d](int64_t id, double value) {
+      assert((id * 7919) % 7 == d);
+      assert(value == id * 0.5);
+    });
+  }
+  assert(total == 20 * kBatch);
+  fs::remove_all(base);
+}
+
+void TestPartitionBudget() {
+  std::cout << "Testing PartitionedWriter budget flushes..." << std::endl;
+  const fs::path base = "test_partitioned_budget";
+  fs::remove_all(base);
+
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64, false);
+  schema.AddColumn("key", hpq::Type::INT32, false);
+  schema.AddColumn("value", hpq::Type::DOUBLE, false);
+
+  // Row groups never fill on their own, so only the budget cuts them. Key 0
+  // gets 97% of the rows; keys 1-3 stay far below the budget.
+  hpq::WriterOptions options;
+  options.encode_threads = 2;
+  options.data_page_size = 16 * 1024;
+  options.row_group_size = 1 << 30;
+  options.memory_budget = std::make_shared<hpq::MemoryBudget>(512 * 1024);
+  hpq::PartitionedWriter writer(base.string(), schema, 1, options);
+
+  const int kBatch = 10000;
+  const int kBatches = 20;
+  std::vector<int64_t> ids(kBatch);
+  std::vector<int32_t> keys(kBatch);
+  std::vector<double> values(kBatch);
+  for (int batch = 0; batch < kBatches; ++batch) {
+    for (int i = 0; i < kBatch; ++i) {
+      int64_t row = static_cast<int64_t>(batch) * kBatch + i;
+      ids[i] = row;
+      keys[i] = row % 100 < 97 ? 0 : static_cast<int32_t>(row % 100 - 96);
+      values[i] = row * 0.5;
+    }
+    writer.WriteBatch({ids.data(), keys.data(), values.data()}, kBatch);
+  }
+  writer.Close();
+
+  // The largest partition was flushed, repeatedly, before any other
+  int64_t total = 0;
+  for (int key = 0; key < 4; ++key) {
+    fs::path file = base / ("key=" + std::to_string(key)) / "part-0.parquet";
+    size_t row_groups;
+    {
+      hpq::ParquetScanner scanner(file.string());
+      row_groups = scanner.metadata().row_groups.size();
+    }
+    if (key == 0)
+      assert(row_groups > 1);
+    else
+      assert(row_groups == 1); // Only the row group Close() ends
+    total += ScanPartition(file, [key](int64_t id, double value) {
+      const int64_t r = id % 100;
+      assert(key == 0 ? r < 97 : r - 96 == key);
+      assert(value == id * 0.5);
+    });
+  }
+  assert(total == static_cast<int64_t>(kBatches) * kBatch);
+  fs::remove_all(base);
+}
+
+void TestPartitionLogicalTypes() {
+  std::cout << "Testing PartitionedWriter logical types..." << std::endl;
+  const fs::path base = "test_partitioned_logical";
+  fs::remove_all(base);
+
+  using hpq::LogicalType;
+  hpq::Schema schema;
+  schema.AddColumn("key", hpq::Type::INT32, false);
+  schema.AddColumn("price", LogicalType::Decimal(9, 2), false);
+  schema.AddColumn("big", LogicalType::Decimal(30, 6), false);
+  schema.AddColumn("ts", LogicalType::Timestamp(hpq::TimeUnit::kMillis),
+                   false);
+  hpq::PartitionedWriter writer(base.string(), schema, 0);
+
+  // Decimals are fed as 16-byte decimal128 values
+  const int n = 5000;
+  std::vector<int32_t> keys(n);
+  std::vector<__int128> prices(n), bigs(n);
+  std::vector<int64_t> ts(n);
+  for (int i = 0; i < n; ++i) {
+    keys[i] = i % 2;
+    prices[i] = i % 3 ? i * 100 : -i * 7;
+    bigs[i] = static_cast<__int128>(i - 2500) * 1000000000000000000LL;
+    ts[i] = 1700000000000LL + i;
+  }
+  writer.WriteBatch({keys.data(), prices.data(), bigs.data(), ts.data()}, n);
+  writer.Close();
+
+  for (int key = 0; key < 2; ++key) {
+    fs::path file = base / ("key=" + std::to_string(key)) / "part-0.parquet";
+    hpq::ParquetScanner scanner(file.string());
+    const auto &columns = scanner.metadata().schema;
+    assert(columns.size() == 3);
+    for (size_t c = 0; c < 3; ++c) {
+      const hpq::ColumnSchema &expect = schema.columns()[c + 1];
+      assert(columns[c].name == expect.name);
+      assert(columns[c].type == expect.type);
+      assert(columns[c].type_length == expect.type_length);
+      assert(columns[c].logical_type == expect.logical_type);
+    }
+    int i = key;
+    hpq::ScanBatch batch;
+    while (scanner.Next(&batch)) {
+      const auto &col = batch.columns;
+      for (int64_t k = 0; k < batch.num_rows; ++k, i += 2) {
+        assert(col[0].values<int32_t>()[k] ==
+               static_cast<int32_t>(prices[i]));
+        // Big-endian, sign-extended from 13 bytes
+        const uint8_t *be = col[1].values<uint8_t>() + k * 13;
+        __int128 big = static_cast<int8_t>(be[0]);
+        for (int b = 1; b < 13; ++b)
+          big = big * 256 + be[b];
+        assert(big == bigs[i]);
+        assert(col[2].values<int64_t>()[k] == ts[i]);
+      }
+    }
+    assert(i == n + key);
+  }
+  fs::remove_all(base);
+}
+
+int main() {
+  TestGatherIndexed();
+  TestThreadPool();
+  TestPartitionedWriter();
+  TestPartitionBudget();
+  TestPartitionLogicalTypes();
+  std::cout << "test_partitioned_writer passed!" << std::endl;
+  return 0;
+}
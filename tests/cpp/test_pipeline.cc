@@ -0,0 +1,127 @@
+#include "hpq/schema.h"
+#include "hpq/util/bounded_queue.h"
+#include "hpq/writer.h"
+#include <atomic>
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+static std::vector<char> ReadFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+}
+
+void TestBoundedQueue() {
+  std::cout << "Testing BoundedQueue backpressure..." << std::endl;
+  hpq::BoundedQueue<int> queue(4);
+
+  const int kItems = 10000;
+  std::thread producer([&] {
+    for (int i = 0; i < kItems; ++i)
+      queue.Push(i);
+    queue.Close();
+  });
+
+  long long sum = 0;
+  int count = 0;
+  int value;
+  while (queue.Pop(value)) {
+    sum += value;
+    count++;
+  }
+  producer.join();
+
+  assert(count == kItems);
+  assert(sum == static_cast<long long>(kItems) * (kItems - 1) / 2);
+}
+
+void WriteFile(const std::string &path, const hpq::WriterOptions &options,
+               int num_rows) {
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  schema.AddColumn("small", hpq::Type::INT32, false);
+
+  std::vector<int64_t> ids(num_rows);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::vector<int32_t> small(num_rows);
+  for (int i = 0; i < num_rows; ++i)
+    small[i] = i % 16;
+
+  hpq::ParquetWriter writer(path, options);
+  writer.Init(schema);
+  // Interleave small batches so pages of both columns are in flight together.
+  for (int offset = 0; offset < num_rows; offset += 10000) {
+    int n = std::min(10000, num_rows - offset);
+    writer.WriteColumn(0, ids.data() + offset, n);
+    writer.WriteColumn(1, small.data() + offset, n);
+  }
+
+  std::atomic<bool> callback_ran{false};
+  auto done = writer.CloseAsync([&](std::exception_ptr error) {
+    assert(!error);
+    callback_ran = true;
+  });
+  done.get();
+  assert(callback_ran);
+}
+
+void TestAsyncMatchesSync() {
+  std::cout << "Testing async pipeline output..." << std::endl;
+  const int kRows = 300000;
+
+  hpq::WriterOptions sync_options;
+  sync_options.row_group_size = 100000;
+  sync_options.data_page_size = 64 * 1024;
+  WriteFile("test_pipeline_sync.parquet", sync_options, kRows);
+
+  hpq::WriterOptions async_options = sync_options;
+  async_options.async = true;
+  async_options.encode_threads = 4;
+  async_options.pipeline_queue_depth = 2; // Force backpressure
+  WriteFile("test_pipeline_async.parquet", async_options, kRows);
+
+  auto sync_bytes = ReadFile("test_pipeline_sync.parquet");
+  auto async_bytes = ReadFile("test_pipeline_async.parquet");
+  assert(sync_bytes.size() > 8);
+  assert(std::string(sync_bytes.data(), 4) == "PAR1");
+  assert(std::string(sync_bytes.data() + sync_bytes.size() - 4, 4) == "PAR1");
+  // Parallel encoding must not change the file layout.
+  assert(sync_bytes == async_bytes);
+}
+
+void TestAsyncErrorReported() {
+  std::cout << "Testing async error propagation..." << std::endl;
+  hpq::Schema schema;
+  schema.AddColumn("a", hpq::Type::INT32);
+  schema.AddColumn("b", hpq::Type::INT32);
+
+  hpq::WriterOptions options;
+  options.async = true;
+  hpq::ParquetWriter writer("test_pipeline_error.parquet", options);
+  writer.Init(schema);
+
+  std::vector<int32_t> values(100, 7);
+  writer.WriteColumn(0, values.data(), 100);
+  writer.WriteColumn(1, values.data(), 50); // Row counts differ
+
+  bool threw = false;
+  try {
+    writer.CloseAsync().get();
+  } catch (const std::exception &e) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main() {
+  TestBoundedQueue();
+  TestAsyncMatchesSync();
+  TestAsyncErrorReported();
+  std::cout << "test_pipeline passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,204 @@
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <sys/stat.h>
+#include <vector>
+
+constexpr int kRows = 200000;
+constexpr int kRowGroupSize = 50000;
+const char *kFile = "test_scanner.parquet";
+
+// id: 0..N-1, ts: id / 10 (INT32), key: 2 * id (even only), price: random,
+// flag: all false.
+void WriteTestFile() {
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  schema.AddColumn("ts", hpq::Type::INT32, false);
+  schema.AddColumn("key", hpq::Type::INT64);
+  schema.AddColumn("price", hpq::Type::DOUBLE);
+  schema.AddColumn("flag", hpq::Type::BOOLEAN);
+
+  std::vector<int64_t> id(kRows), key(kRows);
+  std::vector<int32_t> ts(kRows);
+  std::vector<double> price(kRows);
+  std::vector<uint8_t> flag(kRows, 0);
+  std::mt19937_64 rng(7);
+  for (int i = 0; i < kRows; ++i) {
+    id[i] = i;
+    ts[i] = i / 10;
+    key[i] = 2 * static_cast<int64_t>(i);
+    price[i] = static_cast<double>(rng() % 100000) / 100.0;
+  }
+
+  hpq::WriterOptions options;
+  options.compression = "NONE";
+  options.row_group_size = kRowGroupSize;
+  options.data_page_size = 64 * 1024; // 8192 INT64 values per page
+  options.bloom_filter_columns = {"key"};
+  hpq::ParquetWriter writer(kFile, options);
+  writer.Init(schema);
+  writer.WriteColumn(0, id.data(), kRows);
+  writer.WriteColumn(1, ts.data(), kRows);
+  writer.WriteColumn(2, key.data(), kRows);
+  writer.WriteColumn(3, price.data(), kRows);
+  writer.WriteColumn(4, flag.data(), kRows);
+  writer.Close();
+}
+
+int64_t FileSize() {
+  struct stat st;
+  stat(kFile, &st);
+  return st.st_size;
+}
+
+void TestFullScan() {
+  std::cout << "Testing full scan with projection..." << std::endl;
+  hpq::ScanOptions options;
+  options.columns = {"price", "id"};
+  hpq::ParquetScanner scanner(kFile, options);
+  assert(scanner.metadata().row_groups.size() == kRows / kRowGroupSize);
+
+  hpq::ScanBatch batch;
+  int64_t rows = 0;
+  while (scanner.Next(&batch)) {
+    assert(batch.columns.size() == 2);
+    assert(batch.columns[1].name == "id");
+    const int64_t *ids = batch.columns[1].values<int64_t>();
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      assert(ids[i] == batch.first_row + i);
+    rows += batch.num_rows;
+  }
+  assert(rows == kRows);
+  assert(scanner.stats().pages_skipped == 0);
+}
+
+void TestPointLookup() {
+  std::cout << "Testing point lookup..." << std::endl;
+  const int64_t target = 123456;
+  hpq::ScanOptions options;
+  options.columns = {"id", "ts", "price"};
+  options.predicates = {hpq::ColumnPredicate::Equal("id", target)};
+  hpq::ParquetScanner scanner(kFile, options);
+
+  hpq::ScanBatch batch;
+  bool found = false;
+  int batches = 0;
+  while (scanner.Next(&batch)) {
+    ++batches;
+    assert(batch.ranges.size() == 1);
+    const int64_t *ids = batch.columns[0].values<int64_t>();
+    const int32_t *ts = batch.columns[1].values<int32_t>();
+    for (int64_t i = 0; i < batch.num_rows; ++i) {
+      assert(ids[i] == batch.first_row + batch.ranges[0].begin + i);
+      assert(ts[i] == ids[i] / 10);
+      found |= ids[i] == target;
+    }
+    // One id page of 8192 rows survives the page index.
+    assert(batch.num_rows <= 8192);
+  }
+  const auto &stats = scanner.stats();
+  std::cout << "  read " << stats.bytes_read << " of " << FileSize()
+            << " bytes, skipped " << stats.pages_skipped << "/" << stats.pages
+            << " pages" << std::endl;
+  assert(found && batches == 1);
+  assert(stats.row_groups_skipped_by_statistics == 3);
+  assert(stats.pages_skipped > 0);
+  assert(stats.bytes_read * 10 < FileSize());
+}
+
+void TestRangeAndIn() {
+  std::cout << "Testing range and IN predicates..." << std::endl;
+  hpq::ScanOptions options;
+  options.columns = {"ts"};
+  options.predicates = {hpq::ColumnPredicate::Between("ts", 5000, 5100),
+                        hpq::ColumnPredicate::In("id", {50010, 50500, 9.5e9})};
+  hpq::ParquetScanner scanner(kFile, options);
+  hpq::ScanBatch batch;
+  int64_t rows = 0;
+  while (scanner.Next(&batch)) {
+    const int32_t *ts = batch.columns[0].values<int32_t>();
+    bool hit = false;
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      hit |= ts[i] >= 5000 && ts[i] <= 5100;
+    assert(hit);
+    rows += batch.num_rows;
+  }
+  assert(rows > 0 && rows < kRowGroupSize);
+  assert(scanner.stats().row_groups_skipped_by_statistics == 3);
+
+  // Nothing can match: the ranges do not overlap
+  hpq::ScanOptions empty;
+  empty.predicates = {hpq::ColumnPredicate::Less("ts", 1000),
+                      hpq::ColumnPredicate::GreaterEqual("id", 20000)};
+  hpq::ParquetScanner none(kFile, empty);
+  assert(!none.Next(&batch));
+  assert(none.stats().row_groups_skipped_by_page_index == 1);
+}
+
+void TestBloomFilter() {
+  std::cout << "Testing Bloom filter pruning..." << std::endl;
+  // Odd keys are inside every row group's min/max but never written.
+  hpq::ScanOptions options;
+  options.columns = {"key"};
+  options.predicates = {
+      hpq::ColumnPredicate::In("key", {101, 100001, 200001, 300001})};
+  hpq::ParquetScanner scanner(kFile, options);
+  hpq::ScanBatch batch;
+  while (scanner.Next(&batch)) {
+  }
+  const auto &stats = scanner.stats();
+  std::cout << "  bloom skipped " << stats.row_groups_skipped_by_bloom_filter
+            << "/" << stats.row_groups << " row groups" << std::endl;
+  assert(stats.row_groups_skipped_by_statistics == 0);
+  assert(stats.row_groups_skipped_by_bloom_filter >= 3);
+
+  // A present key always survives; the filters may let a false positive
+  // through, but not the whole file.
+  hpq::ScanOptions present;
+  present.use_statistics = false;
+  present.predicates = {hpq::ColumnPredicate::In("key", {100002, 7.5})};
+  hpq::ParquetScanner hit(kFile, present);
+  bool found = false;
+  while (hit.Next(&batch))
+    found |= batch.row_group == 1;
+  assert(found);
+  assert(hit.stats().row_groups_skipped_by_bloom_filter >= 2);
+}
+
+void TestBooleanAndOptions() {
+  std::cout << "Testing BOOLEAN statistics and disabled pruning..."
+            << std::endl;
+  hpq::ScanOptions options;
+  options.predicates = {hpq::ColumnPredicate::Equal("flag", 1)};
+  hpq::ParquetScanner scanner(kFile, options);
+  hpq::ScanBatch batch;
+  assert(!scanner.Next(&batch));
+
+  options.use_statistics = false;
+  options.use_page_index = false;
+  options.columns = {"flag"};
+  hpq::ParquetScanner unpruned(kFile, options);
+  int64_t rows = 0;
+  while (unpruned.Next(&batch)) {
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      assert(batch.columns[0].values<uint8_t>()[i] == 0);
+    rows += batch.num_rows;
+  }
+  assert(rows == kRows);
+}
+
+int main() {
+  WriteTestFile();
+  TestFullScan();
+  TestPointLookup();
+  TestRangeAndIn();
+  TestBloomFilter();
+  TestBooleanAndOptions();
+  std::remove(kFile);
+  std::cout << "test_scanner passed!" << std::endl;
+  return 0;
+}
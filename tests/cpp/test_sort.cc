@@ -0,0 +1,184 @@
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include "hpq/writer/row_sort.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+const char *kFile = "test_sort.parquet";
+
+void TestPermutation() {
+  std::cout << "Testing SortPermutation..." << std::endl;
+  const std::vector<double> d = {3.5, -1.0, 0.0, -0.0, -7.25, NAN,
+                                 1e300, -1e-300, 3.5};
+  auto perm = hpq::SortPermutation(
+      {{hpq::Type::DOUBLE, reinterpret_cast<const uint8_t *>(d.data())}},
+      d.size());
+  const std::vector<uint32_t> expect_d = {4, 1, 7, 3, 2, 0, 8, 6, 5};
+  assert(perm == expect_d); // Stable: the two 3.5s keep their order
+
+  // Two keys, signed: primary INT32, ties broken by INT64
+  std::mt19937_64 rng(4);
+  const size_t n = 10000;
+  std::vector<int32_t> a(n);
+  std::vector<int64_t> b(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = static_cast<int32_t>(rng() % 21) - 10;
+    b[i] = static_cast<int64_t>(rng());
+  }
+  perm = hpq::SortPermutation(
+      {{hpq::Type::INT32, reinterpret_cast<const uint8_t *>(a.data())},
+       {hpq::Type::INT64, reinterpret_cast<const uint8_t *>(b.data())}},
+      n);
+  std::vector<uint32_t> expect(n);
+  for (uint32_t i = 0; i < n; ++i)
+    expect[i] = i;
+  std::stable_sort(expect.begin(), expect.end(), [&](uint32_t x, uint32_t y) {
+    return std::tie(a[x], b[x]) < std::tie(a[y], b[y]);
+  });
+  assert(perm == expect);
+}
+
+struct Row {
+  int32_t tenant;
+  int64_t ts;
+  double value;
+  bool operator<(const Row &o) const {
+    return std::tie(tenant, ts, value) < std::tie(o.tenant, o.ts, o.value);
+  }
+};
+
+std::vector<Row> ReadRows(std::vector<int64_t> *group_rows) {
+  hpq::ParquetScanner scanner(kFile);
+  for (const auto &rg : scanner.metadata().row_groups) {
+    group_rows->push_back(rg.num_rows);
+    assert(rg.sorting_columns.size() == 2);
+    assert(rg.sorting_columns[0].column_idx == 0);
+    assert(rg.sorting_columns[1].column_idx == 1);
+    assert(!rg.sorting_columns[0].descending);
+  }
+  std::vector<Row> rows;
+  hpq::ScanBatch batch;
+  while (scanner.Next(&batch)) {
+    for (int64_t i = 0; i < batch.num_rows; ++i)
+      rows.push_back({batch.columns[0].values<int32_t>()[i],
+                      batch.columns[1].values<int64_t>()[i],
+                      batch.columns[2].values<double>()[i]});
+  }
+  return rows;
+}
+
+void TestWriter(bool async) {
+  std::cout << "Testing sort_by (" << (async ? "async" : "sync") << ")..."
+            << std::endl;
+  const int n = 25000;
+  std::mt19937_64 rng(8);
+  std::vector<int32_t> tenant(n);
+  std::vector<int64_t> ts(n);
+  std::vector<double> value(n);
+  std::vector<Row> input(n);
+  for (int i = 0; i < n; ++i) {
+    tenant[i] = static_cast<int32_t>(rng() % 8);
+    ts[i] = static_cast<int64_t>(rng() % 100000);
+    value[i] = static_cast<double>(i);
+    input[i] = {tenant[i], ts[i], value[i]};
+  }
+
+  hpq::Schema schema;
+  schema.AddColumn("tenant", hpq::Type::INT32, false);
+  schema.AddColumn("ts", hpq::Type::INT64, false);
+  schema.AddColumn("value", hpq::Type::DOUBLE, false);
+  hpq::WriterOptions options;
+  options.row_group_size = 10000;
+  options.data_page_size = 8 * 1024;
+  options.sort_by = {"tenant", "ts"};
+  options.async = async;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    // Columns one after the other, in uneven pieces
+    writer.WriteColumn(0, tenant.data(), n);
+    writer.WriteColumn(1, ts.data(), 7000);
+    writer.WriteColumn(1, ts.data() + 7000, n - 7000);
+    writer.WriteColumn(2, value.data(), n);
+    writer.Close();
+  }
+
+  std::vector<int64_t> group_rows;
+  std::vector<Row> rows = ReadRows(&group_rows);
+  assert((group_rows == std::vector<int64_t>{10000, 10000, 5000}));
+  // Each row group is the sorted form of the same input rows
+  size_t begin = 0;
+  for (int64_t count : group_rows) {
+    std::vector<Row> expect(input.begin() + begin,
+                            input.begin() + begin + count);
+    std::stable_sort(expect.begin(), expect.end(),
+                     [](const Row &x, const Row &y) {
+                       return std::tie(x.tenant, x.ts) <
+                              std::tie(y.tenant, y.ts);
+                     });
+    for (int64_t i = 0; i < count; ++i) {
+      const Row &got = rows[begin + i];
+      assert(got.tenant == expect[i].tenant && got.ts == expect[i].ts &&
+             got.value == expect[i].value);
+    }
+    begin += count;
+  }
+}
+
+void TestFlushAndErrors() {
+  std::cout << "Testing sort_by with FlushRowGroup..." << std::endl;
+  hpq::Schema schema;
+  schema.AddColumn("tenant", hpq::Type::INT32, false);
+  schema.AddColumn("ts", hpq::Type::INT64, false);
+  schema.AddColumn("value", hpq::Type::DOUBLE, false);
+  hpq::WriterOptions options;
+  options.sort_by = {"tenant", "ts"};
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    const int32_t tenant[] = {3, 1, 2};
+    const int64_t ts[] = {5, 9, 7};
+    const double value[] = {0.5, 1.5, 2.5};
+    writer.WriteColumn(0, tenant, 3);
+    writer.WriteColumn(1, ts, 3);
+    writer.WriteColumn(2, value, 3);
+    writer.FlushRowGroup();
+    writer.WriteColumn(0, tenant, 1);
+    writer.WriteColumn(1, ts, 1);
+    writer.WriteColumn(2, value, 1);
+    writer.Close();
+  }
+  std::vector<int64_t> group_rows;
+  std::vector<Row> rows = ReadRows(&group_rows);
+  assert((group_rows == std::vector<int64_t>{3, 1}));
+  assert(rows[0].tenant == 1 && rows[1].tenant == 2 && rows[2].tenant == 3);
+  assert(rows[0].value == 1.5 && rows[3].value == 0.5);
+
+  options.sort_by = {"missing"};
+  hpq::ParquetWriter writer(kFile, options);
+  bool threw = false;
+  try {
+    writer.Init(schema);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main() {
+  TestPermutation();
+  TestWriter(false);
+  TestWriter(true);
+  TestFlushAndErrors();
+  std::remove(kFile);
+  std::cout << "test_sort passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include "hpq/scanner.h"
+#include "hpq/schema.h"
+#include "hpq/util/trace.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char *kFile = "test_trace.parquet";
+
+size_t CountEvents(const std::vector<hpq::TraceThread> &threads,
+                   const char *name) {
+  size_t count = 0;
+  for (const auto &thread : threads) {
+    for (const auto &event : thread.events)
+      count += std::strcmp(event.name, name) == 0;
+  }
+  return count;
+}
+
+void TestRings() {
+  std::cout << "Testing per-thread rings..." << std::endl;
+  { hpq::TraceSpan before("before start"); }
+  hpq::Tracer::Start(8);
+  for (int i = 0; i < 20; ++i)
+    hpq::TraceSpan span("main", i, 0, i);
+  std::thread worker([] {
+    hpq::Tracer::SetThreadName("worker \"1\"");
+    hpq::TraceSpan outer("outer", 3);
+    hpq::TraceSpan inner("inner", 3, 1, 2);
+  });
+  worker.join();
+  hpq::Tracer::Stop();
+  { hpq::TraceSpan after("after stop"); }
+
+  const std::vector<hpq::TraceThread> threads = hpq::Tracer::Snapshot();
+  assert(threads.size() == 2); // The worker's ring outlives it
+  assert(CountEvents(threads, "before start") == 0);
+  assert(CountEvents(threads, "after stop") == 0);
+  for (const auto &thread : threads) {
+    if (thread.name.empty()) {
+      // The newest 8 of 20, oldest first
+      assert(thread.events.size() == 8 && thread.dropped == 12);
+      for (int i = 0; i < 8; ++i)
+        assert(thread.events[i].column == 12 + i);
+    } else {
+      assert(thread.name == "worker \"1\"");
+      assert(thread.events.size() == 2 && thread.dropped == 0);
+      // Inner closes first and lies within outer
+      const hpq::TraceEvent &inner = thread.events[0];
+      const hpq::TraceEvent &outer = thread.events[1];
+      assert(std::strcmp(inner.name, "inner") == 0);
+      assert(inner.start_ns >= outer.start_ns);
+      assert(inner.start_ns + inner.duration_ns <=
+             outer.start_ns + outer.duration_ns);
+      assert(inner.row_group == 1 && inner.page == 2);
+    }
+  }
+
+  std::ostringstream json;
+  hpq::Tracer::WriteChromeTrace(json);
+  const std::string text = json.str();
+  assert(text.find("\"traceEvents\":[") != std::string::npos);
+  assert(text.find("\"dropped_spans\":12") != std::string::npos);
+  assert(text.find("\"name\":\"worker \\\"1\\\"\"") != std::string::npos);
+  assert(text.find("\"args\":{\"column\":3,\"row_group\":1,\"page\":2}") !=
+         std::string::npos);
+
+  // Start again discards the old spans and the exited thread
+  hpq::Tracer::Start();
+  hpq::Tracer::Stop();
+  assert(hpq::Tracer::Snapshot().empty());
+}
+
+void TestWriterSpans(bool async) {
+  std::cout << "Testing writer spans (" << (async ? "async" : "sync")
+            << ")..." << std::endl;
+  const int n = 40000;
+  std::vector<int32_t> a(n);
+  std::vector<double> b(n);
+  for (int i = 0; i < n; ++i) {
+    a[i] = i % 1000;
+    b[i] = i * 0.5;
+  }
+  hpq::Schema schema;
+  schema.AddColumn("a", hpq::Type::INT32, false);
+  schema.AddColumn("b", hpq::Type::DOUBLE, false);
+  hpq::WriterOptions options;
+  options.row_group_size = 10000;
+  options.data_page_size = 16 * 1024;
+  options.async = async;
+
+  hpq::Tracer::Start();
+  hpq::WriterStats stats;
+  {
+    hpq::ParquetWriter writer(kFile, options);
+    writer.Init(schema);
+    writer.WriteColumn(0, a.data(), n);
+    writer.WriteColumn(1, b.data(), n);
+    writer.Close();
+    stats = writer.stats();
+  }
+  hpq::Tracer::Stop();
+  const std::vector<hpq::TraceThread> threads = hpq::Tracer::Snapshot();
+
+#if defined(HPQ_ENABLE_TRACING)
+  assert(CountEvents(threads, "WriteColumn") == 2);
+  assert(CountEvents(threads, "encode") == static_cast<size_t>(stats.pages));
+  assert(CountEvents(threads, "write row group") == 4);
+  assert(CountEvents(threads, "write column chunk") == 8);
+  assert(CountEvents(threads, "footer") == 1);
+  std::set<std::pair<int, int64_t>> chunks;
+  for (const auto &thread : threads) {
+    for (const auto &event : thread.events) {
+      if (std::strcmp(event.name, "encode") == 0)
+        chunks.insert({event.column, event.row_group});
+    }
+  }
+  assert(chunks.size() == 8);
+  if (async) {
+    std::set<std::string> names;
+    for (const auto &thread : threads)
+      names.insert(thread.name);
+    assert(names.count("hpq write") && names.count("hpq encode 0"));
+  }
+#else
+  // Span sites compiled out
+  assert(threads.empty());
+  (void)stats;
+#endif
+
+  hpq::ParquetScanner scanner(kFile);
+  hpq::ScanBatch batch;
+  int64_t rows = 0;
+  while (scanner.Next(&batch))
+    rows += batch.num_rows;
+  assert(rows == n);
+}
+
+int main() {
+  TestRings();
+  TestWriterSpans(false);
+  TestWriterSpans(true);
+  std::remove(kFile);
+  std::cout << "test_trace passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,122 @@
+#include "hpq/encodings/transpose.h"
+#include "hpq/schema.h"
+#include "hpq/writer.h"
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+struct Record {
+  int64_t id;
+  float score;
+  int32_t bucket;
+  double value;
+  uint8_t flag;
+};
+
+static std::vector<char> ReadFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in),
+                           std::istreambuf_iterator<char>());
+}
+
+void TestGatherField() {
+  std::cout << "Testing GatherField..." << std::endl;
+  // Odd stride and a tail that is not a multiple of the vector width.
+  const size_t stride = 13;
+  const size_t n = 37;
+  std::vector<uint8_t> rows(stride * n);
+  for (size_t i = 0; i < rows.size(); ++i)
+    rows[i] = static_cast<uint8_t>(i * 7);
+
+  for (size_t width : {1, 2, 4, 8, 5}) {
+    std::vector<uint8_t> out(width * n);
+    hpq::GatherField(rows.data() + 3, stride, width, n, out.data());
+    for (size_t i = 0; i < n; ++i)
+      assert(std::memcmp(out.data() + i * width, rows.data() + 3 + i * stride,
+                         width) == 0);
+  }
+}
+
+void TestWriteRowsMatchesColumns() {
+  std::cout << "Testing WriteRows vs WriteColumn..." << std::endl;
+  const int kRows = 150000;
+
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  schema.AddColumn("score", hpq::Type::FLOAT);
+  schema.AddColumn("bucket", hpq::Type::INT32, false);
+  schema.AddColumn("value", hpq::Type::DOUBLE);
+  schema.AddColumn("flag", hpq::Type::BOOLEAN);
+  schema.SetFieldOffset(0, offsetof(Record, id));
+  schema.SetFieldOffset(1, offsetof(Record, score));
+  schema.SetFieldOffset(2, offsetof(Record, bucket));
+  schema.SetFieldOffset(3, offsetof(Record, value));
+  schema.SetFieldOffset(4, offsetof(Record, flag));
+
+  std::vector<Record> records(kRows);
+  std::vector<int64_t> ids(kRows);
+  std::vector<float> scores(kRows);
+  std::vector<int32_t> buckets(kRows);
+  std::vector<double> values(kRows);
+  std::vector<uint8_t> flags(kRows);
+  for (int i = 0; i < kRows; ++i) {
+    records[i] = {i * 3LL, i * 0.5f, i % 32, i * 1.25, uint8_t(i % 3 == 0)};
+    ids[i] = records[i].id;
+    scores[i] = records[i].score;
+    buckets[i] = records[i].bucket;
+    values[i] = records[i].value;
+    flags[i] = records[i].flag;
+  }
+
+  hpq::WriterOptions options;
+  options.row_group_size = 40000;
+  {
+    hpq::ParquetWriter writer("test_write_rows_rows.parquet", options);
+    writer.Init(schema);
+    // Uneven batches crossing page and row group boundaries.
+    writer.WriteRows(records.data(), sizeof(Record), 1234);
+    writer.WriteRows(records.data() + 1234, sizeof(Record), kRows - 1234);
+    writer.Close();
+  }
+  {
+    hpq::ParquetWriter writer("test_write_rows_cols.parquet", options);
+    writer.Init(schema);
+    writer.WriteColumn(0, ids.data(), kRows);
+    writer.WriteColumn(1, scores.data(), kRows);
+    writer.WriteColumn(2, buckets.data(), kRows);
+    writer.WriteColumn(3, values.data(), kRows);
+    writer.WriteColumn(4, flags.data(), kRows);
+    writer.Close();
+  }
+
+  assert(ReadFile("test_write_rows_rows.parquet") ==
+         ReadFile("test_write_rows_cols.parquet"));
+}
+
+void TestMissingOffsetRejected() {
+  hpq::Schema schema;
+  schema.AddColumn("id", hpq::Type::INT64);
+  hpq::ParquetWriter writer("test_write_rows_bad.parquet");
+  writer.Init(schema);
+
+  int64_t row = 1;
+  bool threw = false;
+  try {
+    writer.WriteRows(&row, sizeof(row), 1);
+  } catch (const std::runtime_error &) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+int main() {
+  TestGatherField();
+  TestWriteRowsMatchesColumns();
+  TestMissingOffsetRejected();
+  std::cout << "test_write_rows passed!" << std::endl;
+  return 0;
+}